@@ -22,6 +22,72 @@ uniform float zoom;
 
 uniform int colorBanding;
 
+//Fast approximate math (see FastMath.h)
+uniform int fastMath;
+
+//Multi-pass rendering (see ShaderFractal::UpdateMultiPass)
+//single pass: whole fractal in one draw, iterate: continue iterating the state in texture0, color: color the state in texture0
+//state: (z.x, z.y, iterations, 1.0 if escaped)
+#define RENDER_MODE_SINGLE_PASS 0
+#define RENDER_MODE_ITERATE 1
+#define RENDER_MODE_COLOR 2
+
+uniform int renderMode;
+uniform int iterationStart;
+uniform int passIterations;
+
+uniform sampler2D texture0;
+
+//Fast approximate math (fastMath == 1), mirrors FastMath.h with the same coefficients & max errors
+//GLSL ES 1.00 has no float bit casts, so the hardware log2 & exp2 are used instead of the polynomial versions
+
+float FastLog2(float x)
+{
+    return log2(x);
+}
+
+float FastExp2(float x)
+{
+    return exp2(clamp(x, -126.0, 127.0));
+}
+
+//atan2(y, x) in [-PI, PI]
+float FastAtan2(float y, float x)
+{
+    float absX = abs(x);
+    float absY = abs(y);
+
+    //atan of the ratio in [0, 1], the octant is restored afterwards
+    float ratio = min(absX, absY) / max(max(absX, absY), 1e-18);
+    float ratio2 = ratio * ratio;
+
+    float angle = ratio * (0.999999226 + ratio2 * (-0.333256780 + ratio2 * (0.198720403 + ratio2 * (-0.134478641 + ratio2 * (0.0831264530 + ratio2 * (-0.0363604309 + ratio2 * 0.00764835393))))));
+
+    angle = absY > absX ? PI / 2.0 - angle : angle;
+    angle = x < 0.0 ? PI - angle : angle;
+
+    return y < 0.0 ? -angle : angle;
+}
+
+//(sin(x), cos(x))
+vec2 FastSinCos(float x)
+{
+    //x = k * PI/2 + r, with r in [-PI/4, PI/4], PI/2 is split in 3 parts to keep r precise
+    float k = floor(x * 0.636619772 + 0.5);
+    float r = ((x - k * 1.5703125) - k * 4.837512969970703125e-4) - k * 7.54978995489188216e-8;
+    float r2 = r * r;
+
+    float sinR = r * (0.999999997 + r2 * (-0.166666507 + r2 * (0.00833203579 + r2 * -0.000195039043)));
+    float cosR = 0.999999972 + r2 * (-0.499998564 + r2 * (0.0416550149 + r2 * -0.00135857793));
+
+    //quadrant k: sin(x) = sin(r), cos(r), -sin(r), -cos(r) & cos(x) = cos(r), -sin(r), -cos(r), sin(r)
+    float quadrant = mod(k, 4.0);
+
+    vec2 sinCos = quadrant == 1.0 || quadrant == 3.0 ? vec2(cosR, sinR) : vec2(sinR, cosR);
+
+    return vec2(quadrant >= 2.0 ? -sinCos.x : sinCos.x, quadrant == 1.0 || quadrant == 2.0 ? -sinCos.y : sinCos.y);
+}
+
 //2-argument arctangent, used to (for example:) get the angle of a complex number
 float atan2(float y, float x)
 {
@@ -66,6 +132,18 @@ vec2 ComplexPow(vec2 z, float power)
     if (z.x * z.x + z.y * z.y == 0.0)
         return vec2(0.0, 0.0);
 
+    if (fastMath == 1)
+    {
+        //same angle range as atan2 above
+        float angle = FastAtan2(z.y, z.x);
+        angle = angle < -PI / 2.0 ? angle + 2.0 * PI : angle;
+
+        float magnitude = FastExp2(power / 2.0 * FastLog2(z.x * z.x + z.y * z.y));
+        vec2 sinCos = FastSinCos(power * angle);
+
+        return vec2(magnitude * sinCos.y, magnitude * sinCos.x);
+    }
+
     return vec2(pow(z.x * z.x + z.y * z.y, power / 2.0) * cos(power * atan2(z.y, z.x)), pow(z.x * z.x + z.y * z.y, power / 2.0) * sin(power * atan2(z.y, z.x)));
 }
 
@@ -115,6 +193,18 @@ vec4 hsva2rgba(vec4 hsva)
     return vec4(rgb.x, rgb.y, rgb.z, hsva.w);
 }
 
+//Smooth escape time color of the escaping iteration
+vec4 GetEscapeColor(vec2 z, float iteration, float escapePower)
+{
+    float nu = 1.0;
+
+    //log(log(|z|^2) / 2 / log(2)) / log(power) = log2(log2(|z|^2) / 2) / log2(power)
+    if (colorBanding == 0)
+        nu = fastMath == 1 ? FastLog2(FastLog2(ComplexAbsSquared(z)) * 0.5) / FastLog2(escapePower) : log(log(ComplexAbsSquared(z)) / 2.0 / log(2.0) ) / log(escapePower);
+
+    return hsva2rgba(vec4(mod((iteration + 1.0 - nu) * 3.0, 360.0), 1.0, 1.0, 1.0));
+}
+
 void main()
 {
     //next z = z ^ n + c
@@ -126,9 +216,42 @@ void main()
     vec2 c = ((vec2((fragTexCoord.x + offset.x) / widthStretch, fragTexCoord.y + offset.y)) / zoom) + position;
     vec2 z = vec2(0.0, 0.0);
     
+    //Multi-pass: continue iterating from the previous pass's state, or color the final state
+    //a pass is still limited to LIMIT_ITERATIONS, but passes continue until max iterations is reached
+    int iterationFirst = 0;
+    int iterationEnd = maxIterations;
+
+    if (renderMode != RENDER_MODE_SINGLE_PASS)
+    {
+        vec4 state = texture2D(texture0, fragTexCoord);
+
+        if (renderMode == RENDER_MODE_COLOR)
+        {
+            gl_FragColor = state.w == 1.0 ? GetEscapeColor(state.xy, state.z - 1.0, power) : vec4(0.0, 0.0, 0.0, 1.0);
+            return;
+        }
+
+        //the first pass starts at the pixel's position, escaped pixels are done
+        if (iterationStart > 0)
+        {
+            if (state.w == 1.0)
+            {
+                gl_FragColor = state;
+                return;
+            }
+
+            z = state.xy;
+        }
+
+        iterationFirst = iterationStart;
+        iterationEnd = iterationStart + passIterations < maxIterations ? iterationStart + passIterations : maxIterations;
+    }
+
     for (int i = 0; i < LIMIT_ITERATIONS; i++)
     {
-        if (i >= maxIterations)
+        int iteration = iterationFirst + i;
+
+        if (iteration >= iterationEnd)
             break;
 
         //Why no power for loops for whole exponents (integer power value):
@@ -153,12 +276,17 @@ void main()
 
         if (ComplexAbsSquared(z) > escapeRadius * escapeRadius)
         {
-            float nu = colorBanding == 1 ? 1.0 : log(log(ComplexAbsSquared(z)) / 2.0 / log(2.0) ) / log(power);
-
-            gl_FragColor = hsva2rgba(vec4(mod((float(i) + 1.0 - nu) * 3.0, 360.0), 1.0, 1.0, 1.0));
+            //iterations done are stored, the color uses the index of the escaping iteration
+            gl_FragColor = renderMode == RENDER_MODE_ITERATE ? vec4(z, float(iteration + 1), 1.0) : GetEscapeColor(z, float(iteration), power);
             return;
         }
     }
     
+    if (renderMode == RENDER_MODE_ITERATE)
+    {
+        gl_FragColor = vec4(z, float(iterationEnd), 0.0);
+        return;
+    }
+
     gl_FragColor = vec4(0.0, 0.0, 0.0, 1.0);
 } 
\ No newline at end of file
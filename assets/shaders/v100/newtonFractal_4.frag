@@ -23,6 +23,19 @@ uniform float zoom;
 
 uniform int colorBanding;
 
+//Multi-pass rendering (see ShaderFractal::UpdateMultiPass)
+//single pass: whole fractal in one draw, iterate: continue iterating the state in texture0, color: color the state in texture0
+//state: (z.x, z.y, iterations, found root + 1 or 0)
+#define RENDER_MODE_SINGLE_PASS 0
+#define RENDER_MODE_ITERATE 1
+#define RENDER_MODE_COLOR 2
+
+uniform int renderMode;
+uniform int iterationStart;
+uniform int passIterations;
+
+uniform sampler2D texture0;
+
 uniform vec2 roots[NUM_ROOTS];
 
 uniform vec2 a;
@@ -160,6 +173,12 @@ vec4 hsva2rgba(vec4 hsva)
     return vec4(rgb.x, rgb.y, rgb.z, hsva.w);
 }
 
+//Color of the root with the given index
+vec4 GetRootColor(int root)
+{
+    return hsva2rgba(vec4(float(root) * (360.0 / float(NUM_ROOTS)), 1.0, 1.0, 1.0));
+}
+
 void main()
 {
     //Newton fractal:
@@ -202,9 +221,42 @@ void main()
 
     vec2 z = ((vec2((fragTexCoord.x + offset.x) / widthStretch, fragTexCoord.y + offset.y)) / zoom) + position;
 
+    //Multi-pass: continue iterating from the previous pass's state, or color the final state
+    //a pass is still limited to LIMIT_ITERATIONS, but passes continue until max iterations is reached
+    int iterationFirst = 0;
+    int iterationEnd = maxIterations;
+
+    if (renderMode != RENDER_MODE_SINGLE_PASS)
+    {
+        vec4 state = texture2D(texture0, fragTexCoord);
+
+        if (renderMode == RENDER_MODE_COLOR)
+        {
+            gl_FragColor = state.w > 0.0 ? GetRootColor(int(state.w) - 1) : vec4(0.0, 0.0, 0.0, 1.0);
+            return;
+        }
+
+        //the first pass starts at the pixel's position, pixels that found a root are done
+        if (iterationStart > 0)
+        {
+            if (state.w > 0.0)
+            {
+                gl_FragColor = state;
+                return;
+            }
+
+            z = state.xy;
+        }
+
+        iterationFirst = iterationStart;
+        iterationEnd = iterationStart + passIterations < maxIterations ? iterationStart + passIterations : maxIterations;
+    }
+
     for (int i = 0; i < LIMIT_ITERATIONS; i++)
     {
-        if (i >= maxIterations)
+        int iteration = iterationFirst + i;
+
+        if (iteration >= iterationEnd)
             break;
 
          vec2 rz = ComplexMultiply(a, ComplexDivide(
@@ -223,13 +275,19 @@ void main()
                 vec2 dif = roots[i] - z;
                 if (abs(dif.x) <= tolerance && abs(dif.y) <= tolerance)
                 {
-                    gl_FragColor = hsva2rgba(vec4(float(i) * (360.0 / float(NUM_ROOTS)), 1.0, 1.0, 1.0));
+                    gl_FragColor = renderMode == RENDER_MODE_ITERATE ? vec4(z, float(iteration + 1), float(i + 1)) : GetRootColor(i);
                     return;
                 }
             }
         }
     }
     
+    if (renderMode == RENDER_MODE_ITERATE)
+    {
+        gl_FragColor = vec4(z, float(iterationEnd), 0.0);
+        return;
+    }
+
     //no root found, set finalcolor to black
     gl_FragColor = vec4(0.0, 0.0, 0.0, 1.0);
 } 
\ No newline at end of file
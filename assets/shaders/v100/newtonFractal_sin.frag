@@ -22,8 +22,51 @@ uniform float zoom;
 
 uniform int colorBanding;
 
+//Fast approximate math (see FastMath.h)
+uniform int fastMath;
+
+//Multi-pass rendering (see ShaderFractal::UpdateMultiPass)
+//single pass: whole fractal in one draw, iterate: continue iterating the state in texture0, color: color the state in texture0
+//state: (z.x, z.y, iterations, 1.0 if a root was found)
+#define RENDER_MODE_SINGLE_PASS 0
+#define RENDER_MODE_ITERATE 1
+#define RENDER_MODE_COLOR 2
+
+uniform int renderMode;
+uniform int iterationStart;
+uniform int passIterations;
+
+uniform sampler2D texture0;
+
 uniform vec2 a;
 
+//Fast approximate math (fastMath == 1), mirrors FastMath.h with the same coefficients & max errors
+//GLSL ES 1.00 has no float bit casts, so the hardware log2 & exp2 are used instead of the polynomial versions
+
+float FastExp2(float x)
+{
+    return exp2(clamp(x, -126.0, 127.0));
+}
+
+//(sin(x), cos(x))
+vec2 FastSinCos(float x)
+{
+    //x = k * PI/2 + r, with r in [-PI/4, PI/4], PI/2 is split in 3 parts to keep r precise
+    float k = floor(x * 0.636619772 + 0.5);
+    float r = ((x - k * 1.5703125) - k * 4.837512969970703125e-4) - k * 7.54978995489188216e-8;
+    float r2 = r * r;
+
+    float sinR = r * (0.999999997 + r2 * (-0.166666507 + r2 * (0.00833203579 + r2 * -0.000195039043)));
+    float cosR = 0.999999972 + r2 * (-0.499998564 + r2 * (0.0416550149 + r2 * -0.00135857793));
+
+    //quadrant k: sin(x) = sin(r), cos(r), -sin(r), -cos(r) & cos(x) = cos(r), -sin(r), -cos(r), sin(r)
+    float quadrant = mod(k, 4.0);
+
+    vec2 sinCos = quadrant == 1.0 || quadrant == 3.0 ? vec2(cosR, sinR) : vec2(sinR, cosR);
+
+    return vec2(quadrant >= 2.0 ? -sinCos.x : sinCos.x, quadrant == 1.0 || quadrant == 2.0 ? -sinCos.y : sinCos.y);
+}
+
 //z = a * b
 vec2 ComplexMultiply(vec2 a, vec2 b)
 {
@@ -68,6 +111,15 @@ vec2 ComplexSin(vec2 z)
     //ref 1: https://proofwiki.org/wiki/Sine_of_Complex_Number
     //sin(a+bi)=sin(a) * cosh(b) + i * cos(a) * sinh(b)
 
+    if (fastMath == 1)
+    {
+        //cosh(b) = (e^b + e^-b) / 2, sinh(b) = (e^b - e^-b) / 2, e^b = 2^(b * log2(e))
+        vec2 sinCos = FastSinCos(z.x);
+        float expY = FastExp2(z.y * 1.44269504);
+
+        return vec2(sinCos.x * (expY + 1.0 / expY) / 2.0, sinCos.y * (expY - 1.0 / expY) / 2.0);
+    }
+
     return vec2(sin(z.x) * cosh(z.y), cos(z.x) * sinh(z.y));
 }
 
@@ -77,6 +129,15 @@ vec2 ComplexCos(vec2 z)
     //ref 2: https://en.wikipedia.org/wiki/Sine_and_cosine#Complex_numbers_relationship
     //cos(a+bi)=cos(a) * cosh(b) - i * sin(a) * sinh(b)
 
+    if (fastMath == 1)
+    {
+        //cosh(b) = (e^b + e^-b) / 2, sinh(b) = (e^b - e^-b) / 2, e^b = 2^(b * log2(e))
+        vec2 sinCos = FastSinCos(z.x);
+        float expY = FastExp2(z.y * 1.44269504);
+
+        return vec2(sinCos.y * (expY + 1.0 / expY) / 2.0, -sinCos.x * (expY - 1.0 / expY) / 2.0);
+    }
+
     return vec2(cos(z.x) * cosh(z.y), -sin(z.x) * sinh(z.y));
 }
 
@@ -126,6 +187,12 @@ vec4 hsva2rgba(vec4 hsva)
     return vec4(rgb.x, rgb.y, rgb.z, hsva.w);
 }
 
+//Color of a found root, based on the iteration it was found in
+vec4 GetRootColor(float iteration)
+{
+    return hsva2rgba(vec4(mod(iteration * 5.0, 360.0), 1.0, 1.0, 1.0));
+}
+
 void main()
 {
     //Newton fractal:
@@ -141,9 +208,42 @@ void main()
 
     vec2 z = ((vec2((fragTexCoord.x + offset.x) / widthStretch, fragTexCoord.y + offset.y)) / zoom) + position;
 
+    //Multi-pass: continue iterating from the previous pass's state, or color the final state
+    //a pass is still limited to LIMIT_ITERATIONS, but passes continue until max iterations is reached
+    int iterationFirst = 0;
+    int iterationEnd = maxIterations;
+
+    if (renderMode != RENDER_MODE_SINGLE_PASS)
+    {
+        vec4 state = texture2D(texture0, fragTexCoord);
+
+        if (renderMode == RENDER_MODE_COLOR)
+        {
+            gl_FragColor = state.w > 0.0 ? GetRootColor(state.z - 1.0) : vec4(0.0, 0.0, 0.0, 1.0);
+            return;
+        }
+
+        //the first pass starts at the pixel's position, pixels that found a root are done
+        if (iterationStart > 0)
+        {
+            if (state.w > 0.0)
+            {
+                gl_FragColor = state;
+                return;
+            }
+
+            z = state.xy;
+        }
+
+        iterationFirst = iterationStart;
+        iterationEnd = iterationStart + passIterations < maxIterations ? iterationStart + passIterations : maxIterations;
+    }
+
     for (int i = 0; i < LIMIT_ITERATIONS; i++)
     {
-        if (i >= maxIterations)
+        int iteration = iterationFirst + i;
+
+        if (iteration >= iterationEnd)
             break;
 
         vec2 rz = ComplexMultiply(a, ComplexDivide(ComplexSin(z), ComplexCos(z)));
@@ -156,11 +256,17 @@ void main()
         vec2 zsin = ComplexSin(z);
         if (abs(zsin.x) <= tolerance && abs(zsin.y) <= tolerance)
         {
-            gl_FragColor = hsva2rgba(vec4(mod(float(i) * 5.0, 360.0), 1.0, 1.0, 1.0));
+            gl_FragColor = renderMode == RENDER_MODE_ITERATE ? vec4(z, float(iteration + 1), 1.0) : GetRootColor(float(iteration));
             return;
         }
     }
     
+    if (renderMode == RENDER_MODE_ITERATE)
+    {
+        gl_FragColor = vec4(z, float(iterationEnd), 0.0);
+        return;
+    }
+
     //no root found, set finalcolor to black
     gl_FragColor = vec4(0.0, 0.0, 0.0, 1.0);
 } 
\ No newline at end of file
@@ -23,8 +23,32 @@ uniform float zoom;
 
 uniform int colorBanding;
 
+//Fast approximate math (see FastMath.h)
+uniform int fastMath;
+
+//Multi-pass rendering (see ShaderFractal::UpdateMultiPass)
+//single pass: whole fractal in one draw, iterate: continue iterating the state in texture0, color: color the state in texture0
+//state: (z.x, z.y, iterations, 1.0 if escaped)
+#define RENDER_MODE_SINGLE_PASS 0
+#define RENDER_MODE_ITERATE 1
+#define RENDER_MODE_COLOR 2
+
+uniform int renderMode;
+uniform int iterationStart;
+uniform int passIterations;
+
+uniform sampler2D texture0;
+
 uniform vec2 roots[NUM_ROOTS];
 
+//Fast approximate math (fastMath == 1), mirrors FastMath.h with the same coefficients & max errors
+//GLSL ES 1.00 has no float bit casts, so the hardware log2 & exp2 are used instead of the polynomial versions
+
+float FastLog2(float x)
+{
+    return log2(x);
+}
+
 float ComplexAbs(vec2 z)
 {
     return sqrt(z.x * z.x + z.y * z.y);
@@ -102,6 +126,18 @@ vec4 hsva2rgba(vec4 hsva)
     return vec4(rgb.x, rgb.y, rgb.z, hsva.w);
 }
 
+//Smooth escape time color of the escaping iteration
+vec4 GetEscapeColor(vec2 z, float iteration, float escapePower)
+{
+    float nu = 1.0;
+
+    //log(log(|z|^2) / 2 / log(2)) / log(power) = log2(log2(|z|^2) / 2) / log2(power)
+    if (colorBanding == 0)
+        nu = fastMath == 1 ? FastLog2(FastLog2(ComplexAbsSquared(z)) * 0.5) / FastLog2(escapePower) : log(log(ComplexAbsSquared(z)) / 2.0 / log(2.0) ) / log(escapePower);
+
+    return hsva2rgba(vec4(mod((iteration + 1.0 - nu) * 3.0, 360.0), 1.0, 1.0, 1.0));
+}
+
 void main()
 {
     //next z = z ^ n + c
@@ -126,21 +162,59 @@ void main()
 
     float power = 2.0;
 
+    //Multi-pass: continue iterating from the previous pass's state, or color the final state
+    //a pass is still limited to LIMIT_ITERATIONS, but passes continue until max iterations is reached
+    int iterationFirst = 0;
+    int iterationEnd = maxIterations;
+
+    if (renderMode != RENDER_MODE_SINGLE_PASS)
+    {
+        vec4 state = texture2D(texture0, fragTexCoord);
+
+        if (renderMode == RENDER_MODE_COLOR)
+        {
+            gl_FragColor = state.w == 1.0 ? GetEscapeColor(state.xy, state.z - 1.0, power) : vec4(0.0, 0.0, 0.0, 1.0);
+            return;
+        }
+
+        //the first pass starts at the pixel's position, escaped pixels are done
+        if (iterationStart > 0)
+        {
+            if (state.w == 1.0)
+            {
+                gl_FragColor = state;
+                return;
+            }
+
+            z = state.xy;
+        }
+
+        iterationFirst = iterationStart;
+        iterationEnd = iterationStart + passIterations < maxIterations ? iterationStart + passIterations : maxIterations;
+    }
+
     for (int i = 0; i < LIMIT_ITERATIONS; i++)
     {
-        if (i >= maxIterations)
+        int iteration = iterationFirst + i;
+
+        if (iteration >= iterationEnd)
             break;
 
         z = SecondDegreePolynomial(z, secondDegreeFactor, firstDegreeFactor, constant) + c;
 
         if (ComplexAbsSquared(z) > escapeRadius * escapeRadius)
         {
-            float nu = colorBanding == 1 ? 1.0 : log(log(ComplexAbsSquared(z)) / 2.0 / log(2.0) ) / log(power);
-
-            gl_FragColor = hsva2rgba(vec4(mod((float(i) + 1.0 - nu) * 3.0, 360.0), 1.0, 1.0, 1.0));
+            //iterations done are stored, the color uses the index of the escaping iteration
+            gl_FragColor = renderMode == RENDER_MODE_ITERATE ? vec4(z, float(iteration + 1), 1.0) : GetEscapeColor(z, float(iteration), power);
             return;
         }
     }
     
+    if (renderMode == RENDER_MODE_ITERATE)
+    {
+        gl_FragColor = vec4(z, float(iterationEnd), 0.0);
+        return;
+    }
+
     gl_FragColor = vec4(0.0, 0.0, 0.0, 255.0);
 } 
\ No newline at end of file
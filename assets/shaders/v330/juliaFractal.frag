@@ -18,8 +18,96 @@ uniform float zoom = 1.0;
 
 uniform int colorBanding = 0;
 
+//Fast approximate math (see FastMath.h)
+uniform int fastMath = 0;
+
+//Multi-pass rendering (see ShaderFractal::UpdateMultiPass)
+//single pass: whole fractal in one draw, iterate: continue iterating the state in texture0, color: color the state in texture0
+//state: (z.x, z.y, iterations, 1.0 if escaped)
+#define RENDER_MODE_SINGLE_PASS 0
+#define RENDER_MODE_ITERATE 1
+#define RENDER_MODE_COLOR 2
+
+uniform int renderMode = 0;
+uniform int iterationStart = 0;
+uniform int passIterations = 0;
+
+uniform sampler2D texture0;
+
 out vec4 finalColor;
 
+//Fast approximate math (fastMath == 1), mirrors FastMath.h with the same coefficients & max errors
+
+float FastLog2(float x)
+{
+    //x = m * 2^e, with m in [sqrt(1/2), sqrt(2))
+    int bits = floatBitsToInt(x);
+    float exponent = float(((bits >> 23) & 255) - 127);
+    float m = intBitsToFloat((bits & 0x007FFFFF) | 0x3F800000);
+
+    if (m > 1.41421356)
+    {
+        m *= 0.5;
+        exponent += 1.0;
+    }
+
+    //log2(m) = 2 / ln(2) * atanh(t), t = (m - 1) / (m + 1)
+    float t = (m - 1.0) / (m + 1.0);
+    float t2 = t * t;
+
+    return exponent + t * (2.88539008 + t2 * (0.961798839 + t2 * (0.576715186 + t2 * 0.431717696)));
+}
+
+float FastExp2(float x)
+{
+    x = clamp(x, -126.0, 127.0);
+
+    //x = k + f, with f in [-0.5, 0.5]
+    float k = floor(x + 0.5);
+    float f = x - k;
+
+    float p = 1.00000008 + f * (0.693147188 + f * (0.240221075 + f * (0.0555035711 + f * (0.00967603192 + f * 0.00133908634))));
+
+    return p * intBitsToFloat((int(k) + 127) << 23);
+}
+
+//atan2(y, x) in [-PI, PI]
+float FastAtan2(float y, float x)
+{
+    float absX = abs(x);
+    float absY = abs(y);
+
+    //atan of the ratio in [0, 1], the octant is restored afterwards
+    float ratio = min(absX, absY) / max(max(absX, absY), 1e-37);
+    float ratio2 = ratio * ratio;
+
+    float angle = ratio * (0.999999226 + ratio2 * (-0.333256780 + ratio2 * (0.198720403 + ratio2 * (-0.134478641 + ratio2 * (0.0831264530 + ratio2 * (-0.0363604309 + ratio2 * 0.00764835393))))));
+
+    angle = absY > absX ? PI / 2.0 - angle : angle;
+    angle = x < 0.0 ? PI - angle : angle;
+
+    return y < 0.0 ? -angle : angle;
+}
+
+//(sin(x), cos(x))
+vec2 FastSinCos(float x)
+{
+    //x = k * PI/2 + r, with r in [-PI/4, PI/4], PI/2 is split in 3 parts to keep r precise
+    float k = floor(x * 0.636619772 + 0.5);
+    float r = ((x - k * 1.5703125) - k * 4.837512969970703125e-4) - k * 7.54978995489188216e-8;
+    float r2 = r * r;
+
+    float sinR = r * (0.999999997 + r2 * (-0.166666507 + r2 * (0.00833203579 + r2 * -0.000195039043)));
+    float cosR = 0.999999972 + r2 * (-0.499998564 + r2 * (0.0416550149 + r2 * -0.00135857793));
+
+    //quadrant k: sin(x) = sin(r), cos(r), -sin(r), -cos(r) & cos(x) = cos(r), -sin(r), -cos(r), sin(r)
+    float quadrant = mod(k, 4.0);
+
+    vec2 sinCos = quadrant == 1.0 || quadrant == 3.0 ? vec2(cosR, sinR) : vec2(sinR, cosR);
+
+    return vec2(quadrant >= 2.0 ? -sinCos.x : sinCos.x, quadrant == 1.0 || quadrant == 2.0 ? -sinCos.y : sinCos.y);
+}
+
 //2-argument arctangent, used to (for example:) get the angle of a complex number
 float atan2(float y, float x)
 {
@@ -88,6 +176,18 @@ vec2 ComplexPow(vec2 z, float power)
     if (z.x * z.x + z.y * z.y == 0.0)
         return vec2(0.0, 0.0);
 
+    if (fastMath == 1)
+    {
+        //same angle range as atan2 above
+        float angle = FastAtan2(z.y, z.x);
+        angle = angle < -PI / 2.0 ? angle + 2.0 * PI : angle;
+
+        float magnitude = FastExp2(power / 2.0 * FastLog2(z.x * z.x + z.y * z.y));
+        vec2 sinCos = FastSinCos(power * angle);
+
+        return vec2(magnitude * sinCos.y, magnitude * sinCos.x);
+    }
+
     return vec2(pow(z.x * z.x + z.y * z.y, power / 2.0) * cos(power * atan2(z.y, z.x)), pow(z.x * z.x + z.y * z.y, power / 2.0) * sin(power * atan2(z.y, z.x)));
 }
 
@@ -135,6 +235,21 @@ vec4 hsva2rgba(vec4 hsva)
     return vec4(rgb.x, rgb.y, rgb.z, hsva.w);
 }
 
+//Smooth escape time color, black if max iterations was reached
+vec4 GetEscapeColor(vec2 z, int complexIterations, float escapePower)
+{
+    if (complexIterations == maxIterations)
+        return vec4(0.0, 0.0, 0.0, 255.0);
+
+    float nu = 1.0;
+
+    //log(log(|z|^2) / 2 / log(2)) / log(power) = log2(log2(|z|^2) / 2) / log2(power)
+    if (colorBanding == 0)
+        nu = fastMath == 1 ? FastLog2(FastLog2(ComplexAbsSquared(z)) * 0.5) / FastLog2(escapePower) : log(log(ComplexAbsSquared(z)) / 2.0 / log(2.0) ) / log(escapePower);
+
+    return hsva2rgba(vec4(mod((complexIterations + 1 - nu) * 3.0, 360.0), 1.0, 1.0, 1.0));
+}
+
 void main()
 {
     //next z = z^power + c
@@ -146,10 +261,39 @@ void main()
     int complexIterations = 0;
     vec2 z = ((vec2((fragTexCoord.x + offset.x) / widthStretch, fragTexCoord.y + offset.y)) / zoom) + position;
 
+    //Multi-pass: continue iterating from the previous pass's state, or color the final state
+    int iterationEnd = maxIterations;
+
+    if (renderMode != RENDER_MODE_SINGLE_PASS)
+    {
+        vec4 state = texture(texture0, fragTexCoord);
+
+        if (renderMode == RENDER_MODE_COLOR)
+        {
+            finalColor = state.w == 1.0 ? GetEscapeColor(state.xy, int(state.z), power) : vec4(0.0, 0.0, 0.0, 1.0);
+            return;
+        }
+
+        //the first pass starts at the pixel's position, escaped pixels are done
+        if (iterationStart > 0)
+        {
+            if (state.w == 1.0)
+            {
+                finalColor = state;
+                return;
+            }
+
+            z = state.xy;
+            complexIterations = int(state.z);
+        }
+
+        iterationEnd = min(iterationStart + passIterations, maxIterations);
+    }
+
     //if power is a whole number & above 0 (excluding 0), multiply the complex number by itself that many times instead of using ComplexPow, it's less expensive
     if (mod(power, 1.0) == 0.0 && power > 0.0)
     {
-        while (ComplexAbsSquared(z) <= escapeRadius * escapeRadius && complexIterations < maxIterations)
+        while (ComplexAbsSquared(z) <= escapeRadius * escapeRadius && complexIterations < iterationEnd)
         {
             vec2 newZ = z;
 
@@ -165,7 +309,7 @@ void main()
     }
     else
     {
-        while (ComplexAbsSquared(z) <= escapeRadius * escapeRadius && complexIterations < maxIterations)
+        while (ComplexAbsSquared(z) <= escapeRadius * escapeRadius && complexIterations < iterationEnd)
         {
             z = ComplexPow(z, power) + c;
         
@@ -173,14 +317,11 @@ void main()
         }
     }
 
-    if (complexIterations == maxIterations)
+    if (renderMode == RENDER_MODE_ITERATE)
     {
-        finalColor = vec4(0.0, 0.0, 0.0, 255.0);
+        finalColor = vec4(z, float(complexIterations), ComplexAbsSquared(z) > escapeRadius * escapeRadius ? 1.0 : 0.0);
+        return;
     }
-    else
-    {
-        float nu = colorBanding == 1 ? 1.0 : log(log(ComplexAbsSquared(z)) / 2.0 / log(2.0) ) / log(power);
 
-        finalColor = hsva2rgba(vec4(mod((complexIterations + 1 - nu) * 3.0, 360.0), 1.0, 1.0, 1.0));
-    }
+    finalColor = GetEscapeColor(z, complexIterations, power);
 } 
\ No newline at end of file
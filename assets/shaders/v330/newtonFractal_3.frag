@@ -18,6 +18,19 @@ uniform float zoom = 1.0;
 
 uniform int colorBanding = 0;
 
+//Multi-pass rendering (see ShaderFractal::UpdateMultiPass)
+//single pass: whole fractal in one draw, iterate: continue iterating the state in texture0, color: color the state in texture0
+//state: (z.x, z.y, iterations, found root + 1 or 0)
+#define RENDER_MODE_SINGLE_PASS 0
+#define RENDER_MODE_ITERATE 1
+#define RENDER_MODE_COLOR 2
+
+uniform int renderMode = 0;
+uniform int iterationStart = 0;
+uniform int passIterations = 0;
+
+uniform sampler2D texture0;
+
 //Default roots are the roots to most known Newton Fractal (P(z) = z^3 - 1)
 uniform vec2[NUM_ROOTS] roots = vec2[NUM_ROOTS]
 (
@@ -143,6 +156,12 @@ vec4 hsva2rgba(vec4 hsva)
     return vec4(rgb.x, rgb.y, rgb.z, hsva.w);
 }
 
+//Color of the root with the given index
+vec4 GetRootColor(int root)
+{
+    return hsva2rgba(vec4(float(root) * (360.0 / float(NUM_ROOTS)), 1.0, 1.0, 1.0));
+}
+
 void main()
 {
     //Newton fractal:
@@ -182,7 +201,37 @@ void main()
 
     vec2 z = ((vec2((fragTexCoord.x + offset.x) / widthStretch, fragTexCoord.y + offset.y)) / zoom) + position;
     
-    for (int iteration = 0; iteration < maxIterations; iteration++)
+    //Multi-pass: continue iterating from the previous pass's state, or color the final state
+    int iterationFirst = 0;
+    int iterationEnd = maxIterations;
+
+    if (renderMode != RENDER_MODE_SINGLE_PASS)
+    {
+        vec4 state = texture(texture0, fragTexCoord);
+
+        if (renderMode == RENDER_MODE_COLOR)
+        {
+            finalColor = state.w > 0.0 ? GetRootColor(int(state.w) - 1) : vec4(0.0, 0.0, 0.0, 1.0);
+            return;
+        }
+
+        //the first pass starts at the pixel's position, pixels that found a root are done
+        if (iterationStart > 0)
+        {
+            if (state.w > 0.0)
+            {
+                finalColor = state;
+                return;
+            }
+
+            z = state.xy;
+        }
+
+        iterationFirst = iterationStart;
+        iterationEnd = min(iterationStart + passIterations, maxIterations);
+    }
+
+    for (int iteration = iterationFirst; iteration < iterationEnd; iteration++)
     {
         vec2 rz = ComplexMultiply(a, ComplexDivide(
             ThirdDegreePolynomial(z, thirdDegreeFactor, secondDegreeFactor, firstDegreeFactor, constant), 
@@ -200,13 +249,19 @@ void main()
                 vec2 dif = roots[i] - z;
                 if (abs(dif.x) <= tolerance && abs(dif.y) <= tolerance)
                 {
-                    finalColor = hsva2rgba(vec4(float(i) * (360.0 / float(NUM_ROOTS)), 1.0, 1.0, 1.0));
+                    finalColor = renderMode == RENDER_MODE_ITERATE ? vec4(z, float(iteration + 1), float(i + 1)) : GetRootColor(i);
                     return;
                 }
             }
         }
     }
 
+    if (renderMode == RENDER_MODE_ITERATE)
+    {
+        finalColor = vec4(z, float(iterationEnd), 0.0);
+        return;
+    }
+
     //no root found, set finalcolor to black
     finalColor = vec4(0.0, 0.0, 0.0, 1.0);
 } 
\ No newline at end of file
@@ -18,6 +18,22 @@ uniform float zoom = 1.0;
 
 uniform int colorBanding = 0;
 
+//Fast approximate math (see FastMath.h)
+uniform int fastMath = 0;
+
+//Multi-pass rendering (see ShaderFractal::UpdateMultiPass)
+//single pass: whole fractal in one draw, iterate: continue iterating the state in texture0, color: color the state in texture0
+//state: (z.x, z.y, iterations, 1.0 if escaped)
+#define RENDER_MODE_SINGLE_PASS 0
+#define RENDER_MODE_ITERATE 1
+#define RENDER_MODE_COLOR 2
+
+uniform int renderMode = 0;
+uniform int iterationStart = 0;
+uniform int passIterations = 0;
+
+uniform sampler2D texture0;
+
 //Default roots are the roots to P(z) = z^2 - 1
 uniform vec2[NUM_ROOTS] roots = vec2[NUM_ROOTS]
 (
@@ -27,6 +43,28 @@ uniform vec2[NUM_ROOTS] roots = vec2[NUM_ROOTS]
 
 out vec4 finalColor;
 
+//Fast approximate math (fastMath == 1), mirrors FastMath.h with the same coefficients & max errors
+
+float FastLog2(float x)
+{
+    //x = m * 2^e, with m in [sqrt(1/2), sqrt(2))
+    int bits = floatBitsToInt(x);
+    float exponent = float(((bits >> 23) & 255) - 127);
+    float m = intBitsToFloat((bits & 0x007FFFFF) | 0x3F800000);
+
+    if (m > 1.41421356)
+    {
+        m *= 0.5;
+        exponent += 1.0;
+    }
+
+    //log2(m) = 2 / ln(2) * atanh(t), t = (m - 1) / (m + 1)
+    float t = (m - 1.0) / (m + 1.0);
+    float t2 = t * t;
+
+    return exponent + t * (2.88539008 + t2 * (0.961798839 + t2 * (0.576715186 + t2 * 0.431717696)));
+}
+
 float ComplexAbs(vec2 z)
 {
     return sqrt(z.x * z.x + z.y * z.y);
@@ -121,6 +159,21 @@ vec2 SecondDegreePolynomial(vec2 z, vec2 a, vec2 b, vec2 c)
     return secondDegree + firstDegree + c;
 }
 
+//Smooth escape time color, black if max iterations was reached
+vec4 GetEscapeColor(vec2 z, int complexIterations, float escapePower)
+{
+    if (complexIterations == maxIterations)
+        return vec4(0.0, 0.0, 0.0, 255.0);
+
+    float nu = 1.0;
+
+    //log(log(|z|^2) / 2 / log(2)) / log(power) = log2(log2(|z|^2) / 2) / log2(power)
+    if (colorBanding == 0)
+        nu = fastMath == 1 ? FastLog2(FastLog2(ComplexAbsSquared(z)) * 0.5) / FastLog2(escapePower) : log(log(ComplexAbsSquared(z)) / 2.0 / log(2.0) ) / log(escapePower);
+
+    return hsva2rgba(vec4(mod((complexIterations + 1 - nu) * 3.0, 360.0), 1.0, 1.0, 1.0));
+}
+
 void main()
 {
     //next z = P(z) + c
@@ -146,21 +199,47 @@ void main()
 
     float power = 2.0;
 
-    while (ComplexAbsSquared(z) <= escapeRadius * escapeRadius && complexIterations < maxIterations)
+    //Multi-pass: continue iterating from the previous pass's state, or color the final state
+    int iterationEnd = maxIterations;
+
+    if (renderMode != RENDER_MODE_SINGLE_PASS)
+    {
+        vec4 state = texture(texture0, fragTexCoord);
+
+        if (renderMode == RENDER_MODE_COLOR)
+        {
+            finalColor = state.w == 1.0 ? GetEscapeColor(state.xy, int(state.z), power) : vec4(0.0, 0.0, 0.0, 1.0);
+            return;
+        }
+
+        //the first pass starts at the pixel's position, escaped pixels are done
+        if (iterationStart > 0)
+        {
+            if (state.w == 1.0)
+            {
+                finalColor = state;
+                return;
+            }
+
+            z = state.xy;
+            complexIterations = int(state.z);
+        }
+
+        iterationEnd = min(iterationStart + passIterations, maxIterations);
+    }
+
+    while (ComplexAbsSquared(z) <= escapeRadius * escapeRadius && complexIterations < iterationEnd)
     {
         z = SecondDegreePolynomial(z, secondDegreeFactor, firstDegreeFactor, constant) + c;
         
         complexIterations++;
     }
 
-    if (complexIterations == maxIterations)
+    if (renderMode == RENDER_MODE_ITERATE)
     {
-        finalColor = vec4(0.0, 0.0, 0.0, 255.0);
+        finalColor = vec4(z, float(complexIterations), ComplexAbsSquared(z) > escapeRadius * escapeRadius ? 1.0 : 0.0);
+        return;
     }
-    else
-    {
-        float nu = colorBanding == 1 ? 1.0 : log(log(ComplexAbsSquared(z)) / 2.0 / log(2.0) ) / log(power);
 
-        finalColor = hsva2rgba(vec4(mod((complexIterations + 1 - nu) * 3.0, 360.0), 1.0, 1.0, 1.0));
-    }
+    finalColor = GetEscapeColor(z, complexIterations, power);
 } 
\ No newline at end of file
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <functional>
+
+#include "raylib.h"
+
+#include "Fractal.h"
+
+namespace Explorer
+{
+	//Zoom animations: fractal parameters at keyframes, interpolated in between & rendered on the cpu frame by frame
+	//The zoom is interpolated exponentially (a constant zoom speed), & the position so that it moves at a constant speed on screen,
+	//power, c, roots, a, the center offset & max iterations linearly. The type, color banding & fast math change at each keyframe
+
+	struct FractalKeyframe
+	{
+		//Seconds since the animation's start
+		double time;
+
+		FractalParameters parameters;
+	};
+
+	//Parameters at time, keyframes must be sorted by time
+	FractalParameters InterpolateFractalKeyframes(const std::vector<FractalKeyframe>& keyframes, double time);
+
+	//Keyframe files: a text file with a line per keyframe, "time=2.5 type=0 position=-0.75,0.1 zoom=40 ..." (see GetFractalKeyframeLine)
+
+	std::string GetFractalKeyframeLine(const FractalKeyframe&);
+
+	//Missing fields keep their defaults, false if the line isn't a keyframe
+	bool ParseFractalKeyframeLine(const std::string& line, FractalKeyframe& keyframe);
+
+	//Keyframes of the file sorted by time, throws std::runtime_error if it can't be read
+	std::vector<FractalKeyframe> LoadFractalKeyframes(const std::string& fileName);
+
+	//Adds the keyframe at the end of the file, throws std::runtime_error if it can't be written
+	void AppendFractalKeyframe(const std::string& fileName, const FractalKeyframe&);
+
+	//Rendering
+
+	struct FractalAnimationSettings
+	{
+		int width;
+		int height;
+
+		double framesPerSecond;
+
+		bool flipY;
+
+		//Frames are handed to writeFrame in order (one at a time), otherwise from every thread as soon as they're rendered
+		bool ordered;
+	};
+
+	int GetFractalAnimationNumFrames(const std::vector<FractalKeyframe>& keyframes, const FractalAnimationSettings&);
+
+	//Renders every frame (R8G8B8A8 images) that skipFrame returns false for, one frame per thread at a time (as many frames in flight as threads),
+	//progress is called after every frame with the frames done so far, one call at a time
+	//renderFrame renders the frame's parameters into its pixels (on the calling thread), the cpu renderer if it's empty
+	//returns the number of frames rendered
+	int RenderFractalAnimation(const std::vector<FractalKeyframe>& keyframes, const FractalAnimationSettings&, const std::function<bool(int frame)>& skipFrame,
+		const std::function<void(int frame, const Image& image)>& writeFrame, const std::function<void(int framesDone)>& progress,
+		const std::function<void(const FractalParameters& parameters, Color* pixels)>& renderFrame = nullptr);
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <vector>
+#include <random>
+
+#include "raylib.h"
+
+#include "Fractal.h"
+#include "CPUFractal.h"
+
+namespace Explorer
+{
+	//Buddhabrot: how often the orbits of escaping points of z^n + c pass through each pixel (Multibrot, Multicorn & Burning Ship)
+	//It's a Monte Carlo render: c's are sampled at random & their orbits added to a density histogram, which gets smoother the more samples it has
+	bool FractalSupportsBuddhabrot(FractalType);
+
+	class Buddhabrot
+	{
+		private:
+			FractalParameters parameters;
+			CPUFractalView view;
+
+			int width;
+			int height;
+
+			//Importance sampling: c's are sampled from a grid of cells over the set, weighted by a coarse escape time pre-pass
+			//so most samples land near the boundary, where the long (bright) orbits are
+			float sampleRadius;
+			int numCells;
+			std::vector<double> cellCumulativeWeights;
+
+			//Orbits are added to one histogram per batch (so threads never share one), which are merged into histogram after each batch
+			std::vector<float> histogram;
+			std::vector<std::vector<float>> batchHistograms;
+			std::vector<std::mt19937_64> batchRandom;
+
+			long long numSamples;
+			long long numIterations;
+
+			void PrepareImportanceSampling();
+		public:
+			//Starts over, with the orbits of a fractal of parameters' type, power & max iterations drawn in the view
+			void Reset(const FractalParameters&, int width, int height, bool flipY);
+
+			//Traces numSamples more orbits on all threads, returns the number of iterations done
+			long long AddSamples(long long numSamples);
+
+			long long GetNumSamples() const;
+			long long GetNumIterations() const;
+
+			const FractalParameters& GetParameters() const;
+			int GetWidth() const;
+			int GetHeight() const;
+
+			//Tone maps the density into image (uncompressed R8G8B8A8, width x height)
+			void UpdateImage(Image& image) const;
+
+			Buddhabrot()
+			{
+				parameters = FractalParameters();
+				view = CPUFractalView{ 0.0, 0.0, 0.0, 0.0 };
+
+				width = 0;
+				height = 0;
+
+				sampleRadius = 0.0f;
+				numCells = 0;
+
+				numSamples = 0;
+				numIterations = 0;
+			}
+	};
+}
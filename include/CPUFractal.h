@@ -0,0 +1,131 @@
+#pragma once
+
+#include <vector>
+#include <functional>
+
+#include "raylib.h"
+
+#include "Fractal.h"
+
+namespace Explorer
+{
+	//CPU rendering: the same fractals & coloring as the desktop (v330) shaders, computed on the CPU
+	//used where the gpu can't help (exports larger than a render texture, offline rendering, benchmarking)
+
+	//Fractal position of pixel (x, y) is (originX + x * stepX, originY + y * stepY), pixel (0, 0) is the top left pixel
+	//positions are pixel centers, the same positions the shaders get from fragTexCoord
+	struct CPUFractalView
+	{
+		double originX;
+		double originY;
+
+		double stepX;
+		double stepY;
+	};
+
+	CPUFractalView GetCPUFractalView(const FractalParameters&, int width, int height, bool flipX, bool flipY);
+
+	//Renders the rectangle (x, y, width, height) of view into pixels, with rowStride pixels between rows
+	//pixels points to pixel (0, 0) of the view, returns the number of iterations done
+	long long RenderFractalRectCPU(const FractalParameters&, const CPUFractalView&, Color* pixels, int rowStride, int x, int y, int width, int height);
+
+	//Kernel variants, to compare them (see fractal_bench): RenderFractalRectCPU renders in float, with fast math fractional powers
+	//of the escape time fractals iterated 8 pixels at a time in lanes
+	enum CPUFractalPrecision
+	{
+		CPU_FRACTAL_FLOAT = 0,
+		CPU_FRACTAL_DOUBLE = 1,
+	};
+
+	const int NUM_CPU_FRACTAL_PRECISIONS = 2;
+
+	//Lane widths of the fast math fractional power kernel, 1 samples one pixel at a time
+	const int NUM_CPU_FRACTAL_LANE_WIDTHS = 4;
+	const int CPU_FRACTAL_LANE_WIDTHS[NUM_CPU_FRACTAL_LANE_WIDTHS] = { 1, 4, 8, 16 };
+
+	const char* GetCPUFractalPrecisionName(CPUFractalPrecision);
+
+	//The float kernel of parameters iterates pixels in lanes (fast math & a fractional power of the multibrot, multicorn, burning ship or julia)
+	bool CPUFractalUsesLanes(const FractalParameters&);
+
+	//RenderFractalRectCPU in the given precision, with laneWidth (one of CPU_FRACTAL_LANE_WIDTHS) pixels at a time if the float kernel uses lanes
+	long long RenderFractalRectCPUVariant(const FractalParameters&, const CPUFractalView&, CPUFractalPrecision, int laneWidth,
+		Color* pixels, int rowStride, int x, int y, int width, int height);
+
+	//Float kernels need the rectangle's pixels at least this many float steps (ulps) apart, closer pixels come out in blocks
+	//& the iterations' rounding shows up first
+	const double CPU_FRACTAL_MIN_PIXEL_ULPS = 32.0;
+
+	//The precision the rectangle (x, y, width, height) of view needs, float while its pixels are CPU_FRACTAL_MIN_PIXEL_ULPS float steps apart, double after that
+	CPUFractalPrecision GetCPUFractalRectPrecision(const CPUFractalView&, int x, int y, int width, int height);
+
+	//Whether the rectangle's pixels are still CPU_FRACTAL_MIN_PIXEL_ULPS double steps apart, zoomed in further even double renders them in blocks
+	bool IsCPUFractalRectResolvable(const CPUFractalView&, int x, int y, int width, int height);
+
+	//RenderFractalRectCPU in the precision of GetCPUFractalRectPrecision, for views that can zoom in past float (deep tile levels)
+	long long RenderFractalRectCPUDeep(const FractalParameters&, const CPUFractalView&, Color* pixels, int rowStride, int x, int y, int width, int height);
+
+	//Colors of arbitrary fractal positions (pointsX[i], pointsY[i]) into pixels[i], for renders that don't sample a grid, returns the number of iterations done
+	long long RenderFractalPointsCPU(const FractalParameters&, const double* pointsX, const double* pointsY, Color* pixels, int numPoints);
+
+	//Renders the whole view (width x height pixels, no row padding) on all hardware threads, returns the number of iterations done
+	//pixels that are a mirror or rotation of another pixel in the view are copied from it instead of iterated (see GetCPUFractalSymmetries)
+	long long RenderFractalCPU(const FractalParameters&, const CPUFractalView&, Color* pixels, int width, int height);
+
+	//Not including the identity
+	const int NUM_MAX_CPU_FRACTAL_SYMMETRIES = 7;
+
+	//Symmetries of the fractal that map the view's pixel grid onto itself, in quarter turns around 0 & reflections across the real axis:
+	//z -> i^quarterTurns * z, or z -> i^quarterTurns * conj(z) if conjugate
+	struct CPUFractalSymmetry
+	{
+		int quarterTurns;
+		bool conjugate;
+
+		//pixel (x, y) maps to (offsetX + xx * x + xy * y, offsetY + yx * x + yy * y)
+		int offsetX;
+		int xx;
+		int xy;
+
+		int offsetY;
+		int yx;
+		int yy;
+
+		//newton fractals colored by root: a pixel converging to root i maps to a pixel converging to root mappedRoots[i]
+		int mappedRoots[NUM_MAX_ROOTS];
+	};
+
+	//Fills symmetries (up to NUM_MAX_CPU_FRACTAL_SYMMETRIES) & returns how many there are
+	int GetCPUFractalSymmetries(const FractalParameters&, const CPUFractalView&, CPUFractalSymmetry* symmetries);
+
+	//Threads
+
+	//Hardware threads used by the CPU renderers (or the number set by SetCPUFractalNumThreads), 1 on web (built without pthreads)
+	int GetCPUFractalNumThreads();
+
+	//Uses numThreads threads instead of every hardware thread, to measure how renders scale (see fractal_scaling), 0 goes back to every hardware thread
+	void SetCPUFractalNumThreads(int numThreads);
+
+	//Calls work for every item in [0, numItems), handing the items out one at a time to all threads, returns the sum of what work returned
+	long long RunOnAllThreads(int numItems, const std::function<long long(int item)>& work);
+
+	//How long the threads of RunOnAllThreadsStealing worked, until there was nothing left for them to take
+	struct CPUFractalThreadStats
+	{
+		int numThreads;
+
+		double maxBusySeconds;
+		double meanBusySeconds;
+
+		//Items a thread took from another thread's queue
+		int numSteals;
+	};
+
+	//Calls work for every item of items on all threads, for items whose costs vary a lot (give them most expensive first):
+	//they're dealt out in turn into a queue per thread, threads take their own from the front & once they run out steal from the back of the others
+	//(the cheapest left), returns the sum of what work returned. stats can be null
+	long long RunOnAllThreadsStealing(const std::vector<int>& items, const std::function<long long(int item)>& work, CPUFractalThreadStats* stats);
+
+	//Image (uncompressed R8G8B8A8) of the whole fractal, the same as ShaderFractal::GenImage
+	Image GenImageFractalCPU(const FractalParameters&, int width, int height, bool flipX, bool flipY);
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+namespace Explorer
+{
+	//Dynamic resolution: scales the fractal's render resolution down when frames take longer than a frame time budget, & back up when they fit
+	//Frame times are averaged over DYNAMIC_RESOLUTION_INTERVAL seconds before the scale changes, so single slow frames don't make it jump.
+	//With vsync frames never take less than the refresh interval, so the scale goes up slowly while the budget is met until a frame misses it
+
+	const float DYNAMIC_RESOLUTION_MIN_SCALE = 0.25f;
+	const float DYNAMIC_RESOLUTION_MAX_SCALE = 1.0f;
+
+	const float DYNAMIC_RESOLUTION_INTERVAL = 0.25f;
+
+	//Scale step up per interval while the budget is met
+	const float DYNAMIC_RESOLUTION_SCALE_UP = 1.05f;
+
+	//Intervals the scale holds after a step up missed the budget, before trying again
+	const int DYNAMIC_RESOLUTION_HOLD_INTERVALS = 16;
+
+	//Average frame times within these of the budget count as meeting it, or missing it
+	const float DYNAMIC_RESOLUTION_MET_RATIO = 1.05f;
+	const float DYNAMIC_RESOLUTION_MISSED_RATIO = 1.15f;
+
+	class DynamicResolution
+	{
+		private:
+			float frameTimeBudget;
+			float scale;
+
+			//Frames of the current interval
+			float intervalTime;
+			int intervalFrames;
+
+			float averageFrameTime;
+
+			//The last interval scaled up, if the next one misses the budget that step is undone
+			bool scaledUp;
+			int holdIntervals;
+		public:
+			//Starts over at full resolution
+			void Reset(float frameTimeBudget);
+
+			//Adds a frame that was drawn at GetScale()
+			void Update(float frameTime);
+
+			//Of the window's resolution on each axis
+			float GetScale() const;
+
+			float GetFrameTimeBudget() const;
+
+			//Of the last interval
+			float GetAverageFrameTime() const;
+
+			DynamicResolution()
+			{
+				frameTimeBudget = 1.0f / 60.0f;
+				scale = DYNAMIC_RESOLUTION_MAX_SCALE;
+
+				intervalTime = 0.0f;
+				intervalFrames = 0;
+
+				averageFrameTime = 0.0f;
+
+				scaledUp = false;
+				holdIntervals = 0;
+			}
+	};
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <vector>
+
+#include "raylib.h"
+
+#include "Fractal.h"
+
+namespace Explorer
+{
+	//Exponential map (log-polar) zooms: a zoom into a fixed point is the same picture scaled frame after frame,
+	//so the fractal around the point is rendered once as a strip of angle (columns) by log radius (rows), with square samples (a conformal map),
+	//& every frame is resampled from the strip instead of rendered. Zooming in is moving down the strip, so frames cost a lookup per pixel
+	//The zoom's fixed point is parameters' position (the center of the screen, with the default center offset)
+	bool FractalSupportsExponentialMap(FractalType);
+
+	class ExponentialMap
+	{
+		private:
+			FractalParameters parameters;
+
+			int width;
+			int height;
+
+			//The strip: numRadii rows of numAngles samples, row i at radius exp(minLogRadius + i * logRadiusStep) from the position
+			int numAngles;
+			int numRadii;
+			double minLogRadius;
+			double logRadiusStep;
+
+			std::vector<Color> samples;
+
+			//Where each frame pixel is in the strip at zoom 1: its column & its row (zooming in by z moves it log(z) / logRadiusStep rows down)
+			std::vector<float> pixelColumns;
+			std::vector<float> pixelRows;
+		public:
+			//Renders the strip on all threads for width x height frames from parameters' zoom to endZoom (either can be larger),
+			//returns the number of iterations done
+			long long Render(const FractalParameters&, float endZoom, int width, int height, bool flipY);
+
+			//Resamples the frame at zoom (between the zooms given to Render) into pixels (width x height), on the calling thread
+			//(several frames can be resampled at once)
+			void ResampleFrame(float zoom, Color* pixels) const;
+
+			int GetNumAngles() const;
+			int GetNumRadii() const;
+
+			ExponentialMap()
+			{
+				parameters = FractalParameters();
+
+				width = 0;
+				height = 0;
+
+				numAngles = 0;
+				numRadii = 0;
+				minLogRadius = 0.0;
+				logRadiusStep = 0.0;
+			}
+	};
+}
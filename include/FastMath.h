@@ -0,0 +1,128 @@
+#pragma once
+
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+
+namespace Explorer
+{
+	//Fast approximate transcendental functions, used by the CPU kernels when fast math is enabled
+	//and mirrored in the fractal shaders (FastLog2, FastExp2, FastAtan2 & FastSinCos)
+
+	//All functions are branch free & table free, so the compiler can vectorize loops calling them.
+	//Coefficients are Chebyshev fits on the reduced range, max errors were measured over the whole float range the kernels use.
+
+	namespace FastMath
+	{
+		const float PI_FLOAT = 3.14159265358979f;
+		const float HALF_PI = 1.57079632679490f;
+		const float TWO_OVER_PI = 0.636619772367581f;
+
+		//Cody-Waite split of pi/2, the first parts multiply with small integers exactly
+		const float HALF_PI_1 = 1.5703125f;
+		const float HALF_PI_2 = 4.837512969970703125e-4f;
+		const float HALF_PI_3 = 7.54978995489188216e-8f;
+	}
+
+	//condition ? a : b, selecting the bits with a mask so there's no branch
+	inline float FastSelect(bool condition, float a, float b)
+	{
+		uint32_t mask = 0u - (uint32_t)condition;
+
+		return std::bit_cast<float>((std::bit_cast<uint32_t>(a) & mask) | (std::bit_cast<uint32_t>(b) & ~mask));
+	}
+
+	//floor(x) for |x| < 2^31, using a conversion & compare instead of a rounding instruction/branch
+	inline int FastFloorToInt(float x)
+	{
+		int truncated = (int)x;
+		return truncated - (x < (float)truncated);
+	}
+
+	//log2(x) for positive, normal x
+	//max absolute error: 1.1e-7 for x in [1/2, 2], max relative error: 9.1e-8 elsewhere
+	inline float FastLog2(float x)
+	{
+		//x = m * 2^e, with m in [sqrt(1/2), sqrt(2)): offsetting the bits by sqrt(1/2) makes the exponent field round at sqrt(2)
+		int32_t offsetBits = (int32_t)std::bit_cast<uint32_t>(x) - 0x3F3504F3;
+		float exponent = (float)(offsetBits >> 23);
+
+		float m = std::bit_cast<float>((uint32_t)((offsetBits & 0x007FFFFF) + 0x3F3504F3));
+
+		//log2(m) = 2 / ln(2) * atanh(t), t = (m - 1) / (m + 1)
+		float t = (m - 1.0f) / (m + 1.0f);
+		float t2 = t * t;
+
+		return exponent + t * (2.88539008f + t2 * (0.961798839f + t2 * (0.576715186f + t2 * 0.431717696f)));
+	}
+
+	//2^x for |x| < 2^31, results saturate to ~2^-126 & ~2^127 outside of [-126, 127] instead of becoming denormal or infinite
+	//max relative error: 2.4e-7
+	inline float FastExp2(float x)
+	{
+		//x = k + f, with f in [-0.5, 0.5]
+		int k = FastFloorToInt(x + 0.5f);
+		float f = x - (float)k;
+
+		float p = 1.00000008f + f * (0.693147188f + f * (0.240221075f + f * (0.0555035711f + f * (0.00967603192f + f * 0.00133908634f))));
+
+		//the exponent is clamped as an integer, a float clamp before the polynomial stops compilers from vectorizing
+		k = k < -126 ? -126 : k;
+		k = k > 127 ? 127 : k;
+
+		return p * std::bit_cast<float>((uint32_t)(k + 127) << 23);
+	}
+
+	//x^y for positive x
+	//max relative error: ~2.4e-7 + |y * log2(x)| * 8.3e-8 (FastLog2's error is scaled by y before FastExp2), 5.4e-6 for x <= 300 & y <= 8
+	inline float FastPow(float x, float y)
+	{
+		return FastExp2(y * FastLog2(x));
+	}
+
+	//atan2(y, x) in [-pi, pi], 0 for (0, 0)
+	//max absolute error: 7.2e-7 radians
+	inline float FastAtan2(float y, float x)
+	{
+		float absX = std::fabs(x);
+		float absY = std::fabs(y);
+
+		//atan of the ratio in [0, 1], the octant is restored afterwards
+		float ratio = std::min(absX, absY) / std::max(std::max(absX, absY), 1e-37f);
+		float ratio2 = ratio * ratio;
+
+		float angle = ratio * (0.999999226f + ratio2 * (-0.333256780f + ratio2 * (0.198720403f + ratio2 * (-0.134478641f + ratio2 * (0.0831264530f + ratio2 * (-0.0363604309f + ratio2 * 0.00764835393f))))));
+
+		//octant: pi/2 - angle if |y| > |x|, then pi - angle if x < 0, multiplying by the comparisons keeps it branch free
+		angle += (float)(absY > absX) * (FastMath::HALF_PI - 2.0f * angle);
+		angle += (float)(x < 0.0f) * (FastMath::PI_FLOAT - 2.0f * angle);
+
+		return std::copysign(angle, y);
+	}
+
+	//sin(x) & cos(x) at once, for |x| < ~10^5 (larger arguments lose precision in the range reduction)
+	//max absolute error: 1.4e-7 for |x| <= 100
+	inline void FastSinCos(float x, float& sine, float& cosine)
+	{
+		//x = k * pi/2 + r, with r in [-pi/4, pi/4]
+		int k = FastFloorToInt(x * FastMath::TWO_OVER_PI + 0.5f);
+		float kFloat = (float)k;
+
+		float r = ((x - kFloat * FastMath::HALF_PI_1) - kFloat * FastMath::HALF_PI_2) - kFloat * FastMath::HALF_PI_3;
+		float r2 = r * r;
+
+		float sinR = r * (0.999999997f + r2 * (-0.166666507f + r2 * (0.00833203579f + r2 * -0.000195039043f)));
+		float cosR = 0.999999972f + r2 * (-0.499998564f + r2 * (0.0416550149f + r2 * -0.00135857793f));
+
+		//quadrant k: sin(x) = sin(r), cos(r), -sin(r), -cos(r) & cos(x) = cos(r), -sin(r), -cos(r), sin(r)
+		bool swap = (k & 1) != 0;
+
+		float swappedSin = FastSelect(swap, cosR, sinR);
+		float swappedCos = FastSelect(swap, sinR, cosR);
+
+		//negate by flipping the sign bit
+		sine = std::bit_cast<float>(std::bit_cast<uint32_t>(swappedSin) ^ ((uint32_t)(k & 2) << 30));
+		cosine = std::bit_cast<float>(std::bit_cast<uint32_t>(swappedCos) ^ ((uint32_t)((k + 1) & 2) << 30));
+	}
+}
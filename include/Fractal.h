@@ -51,6 +51,9 @@ namespace Explorer
 
 		bool colorBanding;
 
+		//Fast approximate transcendental functions (see FastMath.h), slightly less precise but cheaper
+		bool fastMath;
+
 		FractalParameters()
 		{
 			type = FRACTAL_MULTIBROT;
@@ -69,6 +72,8 @@ namespace Explorer
 			a = Vector2{ 1.0f, 0.0f };
 
 			colorBanding = false;
+
+			fastMath = false;
 		}
 
 		FractalParameters(FractalType type, Vector2 position, Vector2 normalizedCenterOffset, float zoom, int maxIterations, float power, Vector2 c, std::array<Vector2, NUM_MAX_ROOTS> roots, Vector2 a, bool colorBanding)
@@ -88,15 +93,27 @@ namespace Explorer
 			this->a = a;
 
 			this->colorBanding = colorBanding;
+
+			this->fastMath = false;
 		}
 	};
 
+	bool AreFractalParametersEqual(const FractalParameters&, const FractalParameters&);
+
+	//64 bit FNV-1a hash of the parameters, the same between runs & builds (checkpoints & caches are keyed by it)
+	//equal parameters (see AreFractalParametersEqual) have equal hashes
+	unsigned long long HashFractalParameters(const FractalParameters&);
+
+	//Mixes value into hash, for hashing the parameters together with the rest of a render's settings (size, flips...)
+	unsigned long long HashFractalValue(unsigned long long hash, unsigned long long value);
+
 	int GetFractalNumRoots(FractalType);
 
 	bool FractalSupportsPower(FractalType);
 	bool FractalSupportsC(FractalType);
 	bool FractalSupportsA(FractalType);
 	bool FractalSupportsColorBanding(FractalType);
+	bool FractalSupportsFastMath(FractalType);
 
 	//Render Texture
 
@@ -106,6 +123,10 @@ namespace Explorer
 	int GetFractalRenderTextureHeight();
 	void UnloadFractalRenderTexture();
 
+	//Multi-pass rendering stores each pixel's z & iteration count in float render textures between passes,
+	//which requires float render texture support (OES_texture_float & WEBGL_color_buffer_float on web)
+	bool IsMultiPassSupported();
+
 	//Shaders
 
 	//Kinda wished not all fractal types had access to all the functions, but it's okay.
@@ -115,6 +136,16 @@ namespace Explorer
 		private:
 			Shader fractalShader;
 			FractalType type;
+
+			//Multi-pass rendering
+			bool multiPass;
+			int maxIterations;
+			int multiPassIterations;
+
+			void RestartMultiPass();
+
+			//Draws the fractal into the readback render texture (see Readback.h)
+			RenderTexture2D DrawToReadbackRenderTexture(bool flipX, bool flipY) const;
 		public:
 			FractalType GetFractalType() const;
 
@@ -134,22 +165,50 @@ namespace Explorer
 
 			void SetColorBanding(bool);
 
+			void SetFastMath(bool);
+
+			//Multi-pass rendering: iterations are spread over multiple passes (and frames) instead of a single draw
+
+			void SetMultiPass(bool);
+			bool IsMultiPass() const;
+
+			//Runs up to numPasses passes of iterationsPerPass iterations each, stops early if all iterations are done
+			void UpdateMultiPass(int iterationsPerPass, int numPasses);
+
+			int GetMultiPassIterations() const;
+			bool IsMultiPassComplete() const;
+
 			void Draw(Rectangle destination, bool flipX, bool flipY) const;
 
+			//Draws the fractal at resolutionScale (0 to 1) of destination's resolution into a corner of a render texture kept at destination's size, upscaled (bilinear) to destination
+			//Fewer pixels to iterate, for frames that have to be cheap
+			void DrawScaled(Rectangle destination, float resolutionScale, bool flipX, bool flipY) const;
+
 			Image GenImage(bool flipX, bool flipY) const;
 
+			//Starts an asynchronous readback of the fractal's image, returns its id for PollReadback, -1 if none are free
+			int QueueImage(bool flipX, bool flipY) const;
+
 			void Unload();
 
 			ShaderFractal()
 			{
 				fractalShader = { 0 };
 				type = FRACTAL_UNKNOWN;
+
+				multiPass = false;
+				maxIterations = 0;
+				multiPassIterations = 0;
 			}
 
 			ShaderFractal(Shader shader, FractalType fractalType)
 			{
 				fractalShader = shader;
 				type = fractalType;
+
+				multiPass = false;
+				maxIterations = 0;
+				multiPassIterations = 0;
 			}
 	};
 
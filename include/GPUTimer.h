@@ -0,0 +1,23 @@
+#pragma once
+
+namespace Explorer
+{
+	//GPU timer: how long the gpu took for the commands between BeginGPUTimer & EndGPUTimer, with timer queries.
+	//Results are read a few frames later once the gpu is done with them, so timing never waits for the gpu,
+	//queries are skipped while all of the ring's are still in flight.
+	//Needs OpenGL 3.3 (desktop), elsewhere (web) there are no timings.
+
+	//Timings in flight at once
+	const int GPU_TIMER_RING_SIZE = 4;
+
+	//Only one timing at a time, raylib's batch should be flushed before ending it (rlDrawRenderBatchActive) so it includes the last draws
+	void BeginGPUTimer();
+	void EndGPUTimer();
+
+	//Seconds of the latest finished timing, -1 if there's none yet (or no timer queries)
+	double GetGPUTimerSeconds();
+
+	bool IsGPUTimerAvailable();
+
+	void UnloadGPUTimer();
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <string>
+#include <functional>
+
+//No raylib here, windows' socket headers clash with it (Rectangle, CloseWindow...), so the sockets stay in HttpServer.cpp
+
+namespace Explorer
+{
+	//A minimal HTTP/1.1 server for the command line tools: GET only, a connection per request, on the loopback interface only
+
+	struct HttpRequest
+	{
+		std::string method;
+
+		//Decoded, without the query
+		std::string path;
+
+		//Still encoded, everything after the ?
+		std::string query;
+	};
+
+	struct HttpResponse
+	{
+		int status;
+
+		std::string contentType;
+
+		//Bytes, not necessarily text
+		std::string body;
+	};
+
+	//Connections handled at once, the next ones wait in the listen queue until one is done
+	const int HTTP_MAX_CONNECTIONS = 64;
+
+	//Decodes %XX escapes & + (a space)
+	std::string DecodeUrl(const std::string& text);
+
+	//Serves on 127.0.0.1:port until the process exits, every connection is handled on a thread of its own, up to HTTP_MAX_CONNECTIONS at once
+	//(so handler is called from many threads at once)
+	//throws std::runtime_error if it can't listen on the port
+	void RunHttpServer(int port, const std::function<HttpResponse(const HttpRequest&)>& handler);
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "raylib.h"
+
+#include "Fractal.h"
+#include "CPUFractal.h"
+
+namespace Explorer
+{
+	//Modified inverse iteration method (MIIM): the boundary of a julia set z^n + c drawn as the preimages of a point on it,
+	//z -> (z - c)^(1/n) has n branches, so the preimages form a tree that's walked depth first (up to max iterations deep).
+	//Branches through pixels that were already visited visitCap times are cut, which keeps the tree from growing exponentially.
+
+	//Only julia sets of whole powers of 2 & above
+	bool FractalSupportsInverseIteration(const FractalParameters&);
+
+	//Draws the julia set boundary into pixels (width x height, no row padding) on all threads, returns the number of points visited
+	long long RenderJuliaInverseIteration(const FractalParameters&, const CPUFractalView&, Color* pixels, int width, int height, int visitCap);
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "raylib.h"
+
+#include "Fractal.h"
+
+namespace Explorer
+{
+	//Julia atlas: a grid of small julia sets, one for every c of a lattice over the Mandelbrot set's region, to pick c from by looking at them
+	//The whole grid is a single contact sheet (see ParameterSweep.h), rendered in one pass on all threads with as many pixels as the screen,
+	//so it takes about as long as one full screen julia set
+
+	//Size of a thumbnail in pixels
+	const int JULIA_ATLAS_CELL_SIZE = 64;
+	const int JULIA_ATLAS_SPACING = 1;
+
+	//c's region, around the Mandelbrot set, stretched over the grid (c's imaginary part going up)
+	const Vector2 JULIA_ATLAS_C_MIN = Vector2{ -2.1f, -1.2f };
+	const Vector2 JULIA_ATLAS_C_MAX = Vector2{ 0.6f, 1.2f };
+
+	//Zoom of the thumbnails, centered on 0 so the whole set fits
+	const float JULIA_ATLAS_THUMBNAIL_ZOOM = 0.35f;
+
+	//Thumbnails are too small to show the detail of more iterations, & a lot of them are filled sets (every pixel at max iterations)
+	const int JULIA_ATLAS_MAX_ITERATIONS = 128;
+
+	class JuliaAtlas
+	{
+		private:
+			//What the atlas was rendered with (c, position & zoom excluded)
+			FractalParameters parameters;
+
+			int width;
+			int height;
+
+			int numColumns;
+			int numRows;
+
+			Image image;
+			Texture2D texture;
+
+			double seconds;
+
+			//Top left of the sheet on screen, it's centered
+			Vector2 GetOrigin() const;
+		public:
+			//Renders the atlas again if the julia set's power, iterations... or the screen's size changed
+			void Update(const FractalParameters&, int width, int height);
+
+			void Draw() const;
+
+			//-1 if screenPosition isn't on a cell
+			int GetCellAt(Vector2 screenPosition) const;
+
+			Rectangle GetCellRect(int cell) const;
+			Vector2 GetCellC(int cell) const;
+
+			int GetNumColumns() const;
+			int GetNumRows() const;
+
+			//Time the last render took
+			double GetSeconds() const;
+
+			void Unload();
+
+			JuliaAtlas()
+			{
+				parameters = FractalParameters();
+
+				width = 0;
+				height = 0;
+
+				numColumns = 0;
+				numRows = 0;
+
+				image = Image{ 0 };
+				texture = Texture2D{ 0 };
+
+				seconds = 0.0;
+			}
+	};
+}
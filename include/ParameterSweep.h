@@ -0,0 +1,75 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "raylib.h"
+
+#include "Fractal.h"
+
+namespace Explorer
+{
+	//Parameter sweeps: a grid of variations of one fractal (powers, julia c values, newton a values...) rendered side by side into a contact sheet
+	//The whole sheet is a single job on the cpu: every cell is split into bands of rows & all of them are handed out to the threads at once,
+	//rendered straight into the sheet, so there's no per image thread start up, buffer or copy
+
+	enum SweepParameter
+	{
+		SWEEP_NONE = -1,
+		SWEEP_POWER = 0,
+		SWEEP_C_REAL = 1,
+		SWEEP_C_IMAGINARY = 2,
+		SWEEP_A_REAL = 3,
+		SWEEP_A_IMAGINARY = 4,
+		SWEEP_MAX_ITERATIONS = 5,
+		SWEEP_ZOOM = 6,
+	};
+
+	const int NUM_SWEEP_PARAMETERS = 7;
+
+	//"power", "c.x", "c.y", "a.x", "a.y", "iterations", "zoom"
+	const char* GetSweepParameterName(SweepParameter);
+
+	//SWEEP_NONE if the name isn't a parameter
+	SweepParameter GetSweepParameterByName(const std::string& name);
+
+	double GetSweepParameterValue(const FractalParameters&, SweepParameter);
+	void SetSweepParameterValue(FractalParameters&, SweepParameter, double value);
+
+	struct SweepAxis
+	{
+		SweepParameter parameter;
+
+		//count values from from to to, both included
+		double from;
+		double to;
+		int count;
+	};
+
+	//Cells row by row, the columns axis going right & the rows axis going down
+	std::vector<FractalParameters> GetParameterSweepGrid(const FractalParameters& base, const SweepAxis& columns, const SweepAxis& rows);
+
+	struct ContactSheetSettings
+	{
+		int columns;
+
+		int cellWidth;
+		int cellHeight;
+
+		//Pixels between the cells & around the sheet
+		int spacing;
+
+		bool flipY;
+	};
+
+	struct ContactSheetCellStats
+	{
+		//Summed over the threads that rendered the cell's bands
+		double threadSeconds;
+
+		long long iterations;
+	};
+
+	//Renders cells (row by row, settings.columns per row) into an R8G8B8A8 image, cellStats gets the time & iterations of every cell
+	Image RenderContactSheet(const std::vector<FractalParameters>& cells, const ContactSheetSettings&, std::vector<ContactSheetCellStats>& cellStats);
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <string>
+#include <functional>
+
+#include "raylib.h"
+
+#include "Fractal.h"
+#include "UI/Notification.h"
+
+namespace Explorer
+{
+	//Posters: images far larger than the window (64k x 64k & up), rendered on the cpu band by band & streamed into a TIFF file
+	//every band is deflate compressed & written as soon as it's rendered, so memory stays at about one band no matter the poster's size
+	//TIFF instead of PNG, because TIFF strips are compressed independently & a PNG is a single deflate stream over the whole image
+	//Desktop only
+
+	const int POSTER_MAX_SIZE = 131072;
+
+	//Rows per TIFF strip, the unit that's compressed & written
+	const int POSTER_STRIP_HEIGHT = 16;
+
+	//Pixels rendered at once, a band is as many strips as fit
+	const long long POSTER_BAND_PIXELS = 16ll * 1024ll * 1024ll;
+
+	//Renders the poster into fileName, progress is called with the rows written so far after every band & stops the export if it returns false
+	//returns false if it was stopped, throws std::runtime_error if the file can't be written
+	//Bands are checkpointed in a render journal next to fileName (see RenderJournal.h), exporting the same poster to a file that was stopped
+	//(or crashed) part way resumes it after its last finished band
+	bool ExportFractalPoster(const FractalParameters&, int width, int height, bool flipX, bool flipY, const std::string& fileName, const std::function<bool(int rowsWritten)>& progress);
+
+	//Identifies a poster's render in its journal
+	unsigned long long GetFractalPosterHash(const FractalParameters&, int width, int height, bool flipX, bool flipY);
+
+	//Viewer posters: POSTER_SCALE times the window's size (at most POSTER_MAX_SIZE), exported to Fractal_Screenshots by a background thread
+	//a poster of the same view that didn't finish (closed or crashed) is resumed
+
+	const int POSTER_SCALE = 16;
+
+	//false if a poster is already being exported
+	bool StartFractalPosterExport(const FractalParameters&, int width, int height, bool flipY);
+
+	bool IsFractalPosterExporting();
+
+	//0 to 1
+	float GetFractalPosterProgress();
+
+	//The partial file is deleted
+	void CancelFractalPosterExport();
+
+	//Gets the notification of a finished (or failed) poster, false if there's none
+	bool PollFractalPosterNotification(Notification& notification);
+
+	//Stops the export in progress (it's kept, exporting the same poster again resumes it) & stops the thread
+	void UnloadPosterExporter();
+}
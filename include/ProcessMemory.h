@@ -0,0 +1,13 @@
+#pragma once
+
+//No raylib here, windows.h clashes with it (Rectangle, CloseWindow...), so the platform calls stay in ProcessMemory.cpp
+
+namespace Explorer
+{
+	//Peak resident memory (working set on windows) of the process in bytes, -1 if it can't be read
+	long long GetPeakResidentBytes();
+
+	//Starts measuring the peak again from the current resident memory, false where the peak can't be reset (only linux can),
+	//GetPeakResidentBytes is then the peak since the process started
+	bool ResetPeakResidentBytes();
+}
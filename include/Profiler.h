@@ -0,0 +1,57 @@
+#pragma once
+
+#include <string>
+
+namespace Explorer
+{
+	//Profiler: PROFILE_ZONE("name") times the rest of its scope, zones are recorded with their thread into a ring buffer
+	//& written out as Chrome trace event JSON (chrome://tracing or ui.perfetto.dev) by WriteProfileTrace, nested zones show up nested.
+	//Compiled out unless built with EXPLORER_PROFILER (cmake -DEXPLORER_PROFILER=ON): the macros are then empty & nothing is recorded.
+	//Names must be string literals, only their pointers are kept
+
+	//Zones kept, the oldest are overwritten
+	const int PROFILER_RING_SIZE = 1 << 16;
+
+	bool IsProfilerEnabled();
+
+	//Names the calling thread in traces (threads that ended give their id to the next new thread, so render workers share a few rows)
+	void SetProfileThreadName(const char* name);
+
+	//Writes the ring's zones to a trace event JSON file, returns how many there were,
+	//throws std::runtime_error if it can't be written or the profiler is compiled out
+	int WriteProfileTrace(const std::string& fileName);
+
+#ifdef EXPLORER_PROFILER
+	long long GetProfileNanoseconds();
+	void RecordProfileZone(const char* name, long long startNanoseconds, long long endNanoseconds);
+
+	class ProfileZone
+	{
+		private:
+			const char* name;
+			long long startNanoseconds;
+		public:
+			ProfileZone(const char* zoneName)
+			{
+				name = zoneName;
+				startNanoseconds = GetProfileNanoseconds();
+			}
+
+			~ProfileZone()
+			{
+				RecordProfileZone(name, startNanoseconds, GetProfileNanoseconds());
+			}
+	};
+#endif
+}
+
+#ifdef EXPLORER_PROFILER
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#define PROFILE_ZONE(name) Explorer::ProfileZone PROFILE_CONCAT(profileZone, __LINE__)(name)
+#define PROFILE_THREAD(name) Explorer::SetProfileThreadName(name)
+#else
+#define PROFILE_ZONE(name)
+#define PROFILE_THREAD(name)
+#endif
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "raylib.h"
+
+namespace Explorer
+{
+	//GPU readback: a reusable offscreen render target & a ring of pixel buffer objects (PBOs).
+	//Reading into a PBO returns right away, the pixels are copied out a frame or two later once the GPU is done with them,
+	//instead of LoadImageFromTexture waiting for the whole pipeline to finish.
+	//Needs OpenGL 3.3 (desktop), elsewhere (web) readbacks are synchronous & done as soon as they're queued.
+
+	//Readbacks in flight at once
+	const int READBACK_RING_SIZE = 3;
+
+	//Offscreen render target of width x height, the same one is returned until the size changes
+	RenderTexture2D GetReadbackRenderTexture(int width, int height);
+
+	//Starts reading texture's pixels (texture must be R8G8B8A8 & attached to renderTexture), returns the readback's id,
+	//-1 if all of the ring's readbacks are still in flight
+	int QueueReadback(const RenderTexture2D& renderTexture);
+
+	//Gets the image of a finished readback (R8G8B8A8, rows in the texture's order, same as LoadImageFromTexture)
+	//false if it isn't done yet, once it returns true the id is free again
+	bool PollReadback(int id, Image& image);
+
+	//Waits for the readback & returns its image, frees the id
+	Image WaitReadback(int id);
+
+	bool IsReadbackAsync();
+
+	void UnloadReadback();
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <functional>
+#include <condition_variable>
+
+namespace Explorer
+{
+	//Render jobs: cpu renders run on a job thread instead of the ui thread, so input & drawing never wait for the fractal
+	//The ui thread publishes a job (a lambda holding a snapshot of the parameters), which replaces the one before it & bumps the epoch.
+	//A job is a series of steps (a batch of tiles, an image...) run until one returns false, or until the epoch changes:
+	//stale jobs stop at their next step, & steps can check IsCancelled to stop sooner. Results are handed back by the jobs themselves
+	//(under a mutex of their owner's), the ui keeps drawing the last completed ones until newer ones arrive
+	//Steps run on all threads themselves (see RunOnAllThreads), the job thread only orders them
+	//Web (no threads): steps run on the ui thread in RunOnThisThread, for a frame time at a time
+
+	//Returns true if there's more to do, epoch is the job's (for IsCancelled)
+	using RenderJobStep = std::function<bool(long long epoch)>;
+
+	class RenderJobQueue
+	{
+		private:
+			std::thread thread;
+
+			//Guards job, running & stopping
+			std::mutex mutex;
+			std::condition_variable condition;
+
+			RenderJobStep job;
+			bool running;
+			bool stopping;
+
+			std::atomic<long long> epoch;
+			std::atomic<bool> busy;
+
+			void UpdateThread();
+		public:
+			//Replaces the current job, returns its epoch
+			long long Publish(RenderJobStep step);
+
+			//Stops the current job without a new one
+			void Cancel();
+
+			//A newer job was published (or the job was cancelled) since epoch's
+			bool IsCancelled(long long epoch) const;
+
+			//A job is queued or running
+			bool IsBusy() const;
+
+			//Web: runs the job's steps on this thread for up to frameTime seconds (at least one), does nothing where there's a job thread
+			void RunOnThisThread(float frameTime);
+
+			//Cancels the job & waits for the thread to end
+			void Stop();
+
+			RenderJobQueue()
+			{
+				running = false;
+				stopping = false;
+
+				epoch = 0;
+				busy = false;
+			}
+
+			~RenderJobQueue()
+			{
+				Stop();
+			}
+	};
+}
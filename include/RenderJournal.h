@@ -0,0 +1,55 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <fstream>
+
+namespace Explorer
+{
+	//Render journals: checkpoints of long renders (posters, animations...) split into tiles, so a render that was stopped or crashed
+	//skips its finished tiles when it's started again, instead of starting over
+	//A journal is a text file next to the render's output: the render's hash (see HashFractalParameters), then a line per finished tile
+	//with the tile's index & its own data (ex: where it was written). Lines are flushed as soon as a tile is finished,
+	//after its output, so a journal never lists a tile that isn't on disk. A torn last line (crashed while writing it) is ignored
+
+	//fileName with the journal extension
+	std::string GetRenderJournalFileName(const std::string& fileName);
+
+	class RenderJournal
+	{
+		private:
+			std::string fileName;
+			unsigned long long renderHash;
+
+			std::map<int, std::string> finishedTiles;
+
+			std::ofstream stream;
+
+			void Write();
+		public:
+			//Opens the journal, keeping its finished tiles if it's a journal of the same render (renderHash), starting it over otherwise
+			//returns true if there were finished tiles kept, throws std::runtime_error if it can't be written
+			bool Open(const std::string& fileName, unsigned long long renderHash);
+
+			bool IsTileFinished(int tile) const;
+
+			//Data the tile was finished with, empty if it isn't finished
+			std::string GetTileData(int tile) const;
+
+			int GetNumFinishedTiles() const;
+
+			//Adds the tile to the journal on disk, data must not contain line breaks
+			void FinishTile(int tile, const std::string& data);
+
+			//Closes & deletes the journal, once the render is complete (or thrown away)
+			void Remove();
+
+			RenderJournal()
+			{
+				renderHash = 0;
+			}
+	};
+
+	//true if fileName is a journal of the render
+	bool IsRenderJournalOf(const std::string& fileName, unsigned long long renderHash);
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <fstream>
+
+#include "raylib.h"
+
+#include "Fractal.h"
+#include "RenderJobs.h"
+
+namespace Explorer
+{
+	//Render stats: what rendering the fractal cost in a frame (times, pixels, iterations, how the pixels ended), for the debug overlay
+	//& a JSON lines log to tune deployments with. The cpu renderers count their iterations, the shaders can't: for them iterations
+	//& pixel classes are estimated from a small cpu render of the same view (the cpu renderer iterates like the desktop shaders),
+	//scaled to the pixels the shader evaluated
+
+	//Width of the estimate's render, its height keeps the view's aspect ratio
+	const int RENDER_STATS_SAMPLE_WIDTH = 64;
+
+	struct FractalRenderStats
+	{
+		//Wall time on the cpu (of the render, or of submitting it for shaders) & the gpu's time for it, -1 if it wasn't measured
+		double cpuSeconds;
+		double gpuSeconds;
+
+		long long pixels;
+
+		//-1 if it isn't known (multi-pass shaders)
+		long long iterations;
+
+		//Reached max iterations, escaped, or converged to a root (newton fractals)
+		long long interiorPixels;
+		long long escapedPixels;
+		long long convergedPixels;
+
+		//Iterations & pixel classes are estimated (shaders)
+		bool estimated;
+	};
+
+	//Adds the pixels to stats' classes: black pixels reached max iterations, the others escaped or converged (newton fractals)
+	void CountFractalPixelClasses(FractalType, const Color* pixels, size_t numPixels, FractalRenderStats& stats);
+
+	//Mega iterations per second of the gpu's time if there is one, of the cpu's otherwise, 0 if it isn't known
+	double GetFractalRenderThroughput(const FractalRenderStats&);
+
+	//Estimates a shader's iterations & pixel classes from a RENDER_STATS_SAMPLE_WIDTH wide cpu render,
+	//rendered by a render job whenever the view changes
+	class FractalRenderStatsSampler
+	{
+		private:
+			unsigned long long publishedHash;
+
+			//Guards the sample, of the last finished job
+			std::mutex mutex;
+			FractalRenderStats sample;
+			bool hasSample;
+
+			//Last, so its thread stops before the rest is destroyed
+			RenderJobQueue jobs;
+		public:
+			void Update(const FractalParameters&, int width, int height, bool flipY);
+
+			//stats' iterations & pixel classes for numPixels from the latest sample, false if there's none yet
+			bool Estimate(long long numPixels, FractalRenderStats& stats);
+
+			void Unload();
+
+			FractalRenderStatsSampler()
+			{
+				publishedHash = 0;
+
+				sample = FractalRenderStats{ -1.0, -1.0, 0, 0, 0, 0, 0, false };
+				hasSample = false;
+			}
+	};
+
+	//Appends a JSON object per frame to a file, one per line
+	class RenderStatsLog
+	{
+		private:
+			std::string fileName;
+			std::ofstream stream;
+
+			long long numLines;
+		public:
+			//Appends to the file if it exists, throws std::runtime_error if it can't be opened
+			void Open(const std::string& fileName);
+
+			bool IsOpen() const;
+
+			//renderer: what rendered the frame (shader, cpu...)
+			void Append(long long frame, double time, const char* renderer, const FractalParameters&, int width, int height, const FractalRenderStats&);
+
+			const std::string& GetFileName() const;
+			long long GetNumLines() const;
+
+			void Close();
+
+			RenderStatsLog()
+			{
+				numLines = 0;
+			}
+	};
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "raylib.h"
+
+#include "UI/Notification.h"
+
+namespace Explorer
+{
+	//Screenshots are encoded & written to Fractal_Screenshots by a background thread, so taking one doesn't stall rendering
+	//Desktop only: web screenshots are exported on the main thread, MEMFS & the download script need it
+
+	//Max screenshots waiting to be written, more are refused until there's room
+	const int SCREENSHOT_QUEUE_CAPACITY = 4;
+
+	//Takes ownership of image (it's unloaded once written), false if the queue is full, then the image is unloaded right away
+	bool QueueFractalScreenshot(Image image);
+
+	//Gets the notification of a finished screenshot, one per call, false if there are none
+	bool PollFractalScreenshotNotification(Notification& notification);
+
+	//Writes the screenshots still in the queue & stops the thread
+	void UnloadScreenshotExporter();
+}
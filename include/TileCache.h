@@ -0,0 +1,117 @@
+#pragma once
+
+#include <list>
+#include <mutex>
+#include <memory>
+#include <string>
+#include <vector>
+#include <future>
+#include <functional>
+#include <unordered_map>
+
+namespace Explorer
+{
+	//Encoded tiles (or any other bytes) by a 64 bit key, in memory up to a byte budget (least recently used first out) & on disk
+	//Several threads asking for the same missing tile at once wait for one render of it instead of each rendering it
+
+	typedef std::shared_ptr<const std::string> CachedTile;
+
+	struct TileCacheStats
+	{
+		long long numRequests;
+
+		long long numMemoryHits;
+		long long numDiskHits;
+
+		//Waited for another request's render of the same tile
+		long long numCoalesced;
+
+		long long numRenders;
+
+		//Renders that threw, their requests (& the ones waiting for them) failed
+		long long numFailedRenders;
+
+		//Requests answered from memory or disk
+		double hitRate;
+
+		long long memoryBytes;
+		long long memoryBudget;
+		long long numMemoryTiles;
+
+		//Percentiles of the last TILE_CACHE_LATENCY_SAMPLES renders & requests, in milliseconds
+		double renderLatencyP50;
+		double renderLatencyP90;
+		double renderLatencyP99;
+		double renderLatencyMax;
+
+		double requestLatencyP50;
+		double requestLatencyP90;
+		double requestLatencyP99;
+		double requestLatencyMax;
+	};
+
+	const int TILE_CACHE_LATENCY_SAMPLES = 4096;
+
+	class TileCache
+	{
+		private:
+			std::mutex mutex;
+
+			//Most recently used first
+			std::list<std::pair<unsigned long long, CachedTile>> tiles;
+			std::unordered_map<unsigned long long, std::list<std::pair<unsigned long long, CachedTile>>::iterator> tileEntries;
+
+			long long memoryBytes;
+			long long memoryBudget;
+
+			//Empty for no disk tier
+			std::string diskDirectory;
+
+			//Tiles being read or rendered, the requests for them wait on the future
+			std::unordered_map<unsigned long long, std::shared_future<CachedTile>> pendingTiles;
+
+			long long numRequests;
+			long long numMemoryHits;
+			long long numDiskHits;
+			long long numCoalesced;
+			long long numRenders;
+			long long numFailedRenders;
+
+			//Rings of the last latencies, in milliseconds
+			std::vector<double> renderLatencies;
+			std::vector<double> requestLatencies;
+			long long numRenderLatencies;
+			long long numRequestLatencies;
+
+			std::string GetDiskFileName(unsigned long long key) const;
+
+			//Both need the lock
+			void AddToMemory(unsigned long long key, const CachedTile& tile);
+			void AddLatency(std::vector<double>& latencies, long long& numLatencies, double milliseconds);
+		public:
+			//Empties the memory tier (the disk tier is kept), diskDirectory is created if it doesn't exist, empty for no disk tier
+			void Reset(long long memoryBudget, const std::string& diskDirectory);
+
+			//The tile from memory, disk or render (called on this thread, outside of the lock), whichever comes first
+			//render's exceptions are thrown to every request waiting for the tile, & the tile isn't cached
+			CachedTile GetTile(unsigned long long key, const std::function<std::string()>& render);
+
+			TileCacheStats GetStats();
+
+			TileCache()
+			{
+				memoryBytes = 0;
+				memoryBudget = 0;
+
+				numRequests = 0;
+				numMemoryHits = 0;
+				numDiskHits = 0;
+				numCoalesced = 0;
+				numRenders = 0;
+				numFailedRenders = 0;
+
+				numRenderLatencies = 0;
+				numRequestLatencies = 0;
+			}
+	};
+}
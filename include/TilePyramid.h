@@ -0,0 +1,67 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <functional>
+
+#include "raylib.h"
+
+#include "Fractal.h"
+#include "CPUFractal.h"
+
+namespace Explorer
+{
+	//Tile pyramids: the fractal as square tiles at every zoom level, for pan & zoom web maps (Leaflet, OpenLayers, OpenSeadragon...)
+	//Level 0 is a single tile of parameters' view (its height, as a square), every level below splits each tile into 4
+	//Levels are rendered one after the other on the cpu, a tile per thread at a time from a queue of the level's tiles,
+	//the queue only has the children of the tiles of the level above that aren't uniformly interior (all black), so deep levels stay sparse
+	//Tiles with the same pixels are written once, the others are hard links to it (copies on file systems without links)
+
+	enum TilePyramidLayout
+	{
+		//{z}/{x}/{y}.png, y going down, with a tiles.json manifest
+		TILE_PYRAMID_XYZ,
+
+		//Deep Zoom: <name>.dzi & <name>_files/{level}/{x}_{y}.png, levels from 1x1 pixels up, with a tiles.json manifest
+		TILE_PYRAMID_DZI
+	};
+
+	struct TilePyramidSettings
+	{
+		int tileSize;
+
+		//Level 0 to numLevels - 1
+		int numLevels;
+
+		TilePyramidLayout layout;
+
+		bool flipY;
+
+		//Writes the tiles under uniformly interior tiles too (as links to one interior tile), otherwise they're left out of the layout
+		//& the manifest's "interiorTile" is the tile to show for them
+		bool fillInterior;
+	};
+
+	struct TilePyramidLevelStats
+	{
+		int level;
+
+		long long numRendered;
+
+		//Under a uniformly interior tile, not rendered
+		long long numSkipped;
+
+		//Written as links to a tile with the same pixels
+		long long numDeduplicated;
+
+		double seconds;
+	};
+
+	//The view of tile x, y of level z (tileSize << z pixels across) of the pyramid of parameters' view
+	CPUFractalView GetTilePyramidTileView(const FractalParameters&, int tileSize, int z, int x, int y, bool flipY);
+
+	//Renders the pyramid into directory, progress is called with the level & its tiles done so far after every tile, one call at a time
+	//returns the stats of every level, throws std::runtime_error if the files can't be written
+	std::vector<TilePyramidLevelStats> GenerateTilePyramid(const FractalParameters&, const TilePyramidSettings&, const std::string& directory,
+		const std::function<void(int level, long long tilesDone, long long numTiles)>& progress);
+}
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <mutex>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "raylib.h"
+
+#include "Fractal.h"
+#include "RenderJobs.h"
+#include "RenderStats.h"
+
+namespace Explorer
+{
+	//CPU rendering through a quadtree of tiles in fractal space: level 0 tiles are TILE_TREE_ROOT_SIZE across, every level halves them
+	//The view is drawn from the level whose pixels are about the screen's, with the missing tiles filled in from the closest cached level above
+	//(blurry, a coarse level is rendered first for that) or below, so zooming & panning never waits for a whole frame to render,
+	//& going back to a place (with the same fractal settings) draws it straight from the cache
+	//Tiles are rendered by a render job (see RenderJobs.h) on all threads, outward from a focus on the screen (the cursor), & loaded as textures
+	//on the ui thread once they're done, the least recently drawn are unloaded past TILE_TREE_MEMORY_BUDGET.
+	//When the view changes the job is replaced by one with the new view's tiles, tiles of the old job still being rendered are stopped
+	//unless the new view wants them too
+	//Iterations are recorded per cell of every rendered tile: a tile's bands are handed out to the threads most expensive first by the costs
+	//of the cached tile above it (a preview level tile usually), on a work stealing pool (see RunOnAllThreadsStealing)
+
+	const int TILE_TREE_TILE_SIZE = 256;
+	const double TILE_TREE_ROOT_SIZE = 4.0;
+
+	//Negative levels are tiles larger than the root, for zooming far out
+	//deep levels are rendered in double (see GetCPUFractalRectPrecision), past level 40 their pixels get closer than double can tell apart around |z| = 2
+	const int TILE_TREE_MIN_LEVEL = -24;
+	const int TILE_TREE_MAX_LEVEL = 40;
+
+	//How many levels up a missing tile is looked for (down, only the next level)
+	const int TILE_TREE_FALLBACK_LEVELS = 16;
+
+	//Levels above the view's level rendered first, as the placeholder while the view's level renders
+	const int TILE_TREE_PREVIEW_LEVELS = 3;
+
+	const long long TILE_TREE_MEMORY_BUDGET = 256ll * 1024ll * 1024ll;
+
+	//Rows of a tile rendered between checks for the job being cancelled, & a thread's item
+	const int TILE_TREE_BAND_HEIGHT = 16;
+
+	//Costs are recorded per TILE_TREE_BAND_HEIGHT square cell, so there are as many cells across as bands
+	const int TILE_TREE_COST_CELLS = TILE_TREE_TILE_SIZE / TILE_TREE_BAND_HEIGHT;
+
+	struct TileTreeTile
+	{
+		int level;
+
+		//Tile x, y covers [x, x + 1] * size by [y, y + 1] * size of the fractal, y going up
+		long long x;
+		long long y;
+
+		//The tile's parameters except for the view (see GetTileTreeContentHash)
+		unsigned long long contentHash;
+
+		Texture2D texture;
+
+		long long lastUsedFrame;
+
+		//Iterations of each cell, rows from the top (empty until it's rendered)
+		std::vector<long long> costs;
+	};
+
+	struct TileTreeRenderedTile
+	{
+		TileTreeTile tile;
+
+		//TILE_TREE_TILE_SIZE x TILE_TREE_TILE_SIZE, from the top left
+		std::vector<Color> pixels;
+	};
+
+	class FractalTileTree
+	{
+		private:
+			std::unordered_map<unsigned long long, TileTreeTile> tiles;
+			long long memoryBytes;
+
+			long long frame;
+
+			//Missing tiles of the last update, the first ones are rendered first
+			std::vector<TileTreeTile> wantedTiles;
+
+			//The view & parameters of the last published job, a new one is published when they change
+			unsigned long long publishedViewHash;
+
+			//Guards everything below, shared with the job thread
+			std::mutex renderMutex;
+
+			//Rendered by the job, waiting for the ui thread to load them as textures
+			std::vector<TileTreeRenderedTile> renderedTiles;
+
+			//Keys of the tiles rendered since the last job was published (skipped if a job has them again) & of the job's tiles
+			std::unordered_set<unsigned long long> renderedKeys;
+			std::unordered_set<unsigned long long> jobKeys;
+
+			//What the job rendered since the last update
+			FractalRenderStats jobFrameStats;
+
+			//Thread busy times summed over the batches of the job of statsEpoch
+			long long statsEpoch;
+			double jobMaxBusySeconds;
+			double jobMeanBusySeconds;
+
+			//Of the last job that rendered, copied from the above on the ui thread
+			float loadImbalance;
+			FractalRenderStats frameStats;
+
+			//Last, so its thread stops before the rest is destroyed
+			RenderJobQueue renderJobs;
+
+			int GetViewLevel(const FractalParameters&, int height) const;
+
+			const TileTreeTile* FindTile(unsigned long long contentHash, int level, long long x, long long y) const;
+
+			void LoadRenderedTiles();
+			void PublishRenderJob(const FractalParameters&);
+
+			//Iterations of each band of tile from the closest cached tile above it that has costs, -1 if there's none
+			void PredictBandCosts(const TileTreeTile& tile, long long* bandCosts) const;
+
+			//Renders a batch of the job's tiles (as many as threads) a band per item, returns false once they're all done
+			bool RenderTiles(const FractalParameters&, const std::vector<TileTreeTile>& tiles, const std::vector<long long>& bandCosts, size_t& nextTile, long long epoch);
+
+			void EvictTiles();
+		public:
+			//Loads the tiles the job rendered & publishes a new job if the view changed, or the focus moved to another tile
+			//focus: screen position the tiles closest to are rendered first, level by level
+			//frameTime: seconds of rendering on this thread per update where there's no job thread (web)
+			void Update(const FractalParameters&, int width, int height, bool flipY, Vector2 focus, float frameTime);
+
+			//Draws the view from the tiles there are
+			void Draw(const FractalParameters&, int width, int height, bool flipY) const;
+
+			int GetNumTiles() const;
+			int GetNumWantedTiles() const;
+			long long GetMemoryBytes() const;
+
+			//The job is still rendering tiles
+			bool IsRendering() const;
+
+			//Busiest thread's time over the threads' mean time, over the batches of the last job that rendered (1 is even, 0 before any)
+			float GetLoadImbalance() const;
+
+			//What the job rendered between the last two updates, cpu seconds are the wall time of its batches (0 pixels if it rendered nothing)
+			const FractalRenderStats& GetFrameStats() const;
+
+			void Unload();
+
+			FractalTileTree()
+			{
+				memoryBytes = 0;
+				frame = 0;
+
+				publishedViewHash = 0;
+
+				statsEpoch = 0;
+				jobMaxBusySeconds = 0.0;
+				jobMeanBusySeconds = 0.0;
+
+				loadImbalance = 0.0f;
+
+				jobFrameStats = FractalRenderStats{ 0.0, -1.0, 0, 0, 0, 0, 0, false };
+				frameStats = jobFrameStats;
+			}
+	};
+}
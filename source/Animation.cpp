@@ -0,0 +1,357 @@
+#include "Animation.h"
+
+#include <cmath>
+#include <mutex>
+#include <vector>
+#include <charconv>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <algorithm>
+#include <condition_variable>
+
+#include "raylib.h"
+
+#include "CPUFractal.h"
+
+namespace Explorer
+{
+	#pragma region Interpolation
+	inline float LerpFloat(float a, float b, double amount)
+	{
+		return (float)((double)a + ((double)b - (double)a) * amount);
+	}
+
+	inline Vector2 LerpVector2(Vector2 a, Vector2 b, double amount)
+	{
+		return Vector2{ LerpFloat(a.x, b.x, amount), LerpFloat(a.y, b.y, amount) };
+	}
+
+	FractalParameters InterpolateFractalKeyframes(const std::vector<FractalKeyframe>& keyframes, double time)
+	{
+		if (keyframes.empty())
+			return FractalParameters();
+
+		if (time <= keyframes.front().time)
+			return keyframes.front().parameters;
+
+		if (time >= keyframes.back().time)
+			return keyframes.back().parameters;
+
+		//The keyframes around time
+		size_t next = 1;
+
+		while (keyframes[next].time <= time)
+			next++;
+
+		const FractalKeyframe& from = keyframes[next - 1];
+		const FractalKeyframe& to = keyframes[next];
+
+		double amount = (time - from.time) / (to.time - from.time);
+
+		//The type, banding & fast math of the keyframe before
+		FractalParameters parameters = from.parameters;
+
+		//Exponential zoom: the view's size (1 / zoom) shrinks by the same factor every second
+		double fromSize = 1.0 / (double)from.parameters.zoom;
+		double toSize = 1.0 / (double)to.parameters.zoom;
+		double size = fromSize * std::pow(toSize / fromSize, amount);
+
+		parameters.zoom = (float)(1.0 / size);
+
+		//The position moves by the same fraction of the view every second, so it doesn't race by zoomed out & crawl zoomed in
+		double positionAmount = std::abs(fromSize - toSize) > 1e-9 * fromSize ? (fromSize - size) / (fromSize - toSize) : amount;
+
+		parameters.position = LerpVector2(from.parameters.position, to.parameters.position, positionAmount);
+		parameters.normalizedCenterOffset = LerpVector2(from.parameters.normalizedCenterOffset, to.parameters.normalizedCenterOffset, amount);
+
+		parameters.maxIterations = (int)std::lround(LerpFloat((float)from.parameters.maxIterations, (float)to.parameters.maxIterations, amount));
+		parameters.power = LerpFloat(from.parameters.power, to.parameters.power, amount);
+		parameters.c = LerpVector2(from.parameters.c, to.parameters.c, amount);
+		parameters.a = LerpVector2(from.parameters.a, to.parameters.a, amount);
+
+		for (int i = 0; i < NUM_MAX_ROOTS; i++)
+			parameters.roots[i] = LerpVector2(from.parameters.roots[i], to.parameters.roots[i], amount);
+
+		return parameters;
+	}
+	#pragma endregion
+
+	#pragma region Keyframe files
+	//Shortest text that reads back as the same value
+	template<typename T>
+	std::string GetFloatsText(const T* values, int numValues)
+	{
+		std::string text;
+
+		for (int i = 0; i < numValues; i++)
+		{
+			char buffer[32];
+			std::to_chars_result result = std::to_chars(buffer, buffer + sizeof(buffer), values[i]);
+
+			text += (i > 0 ? "," : "") + std::string(buffer, result.ptr);
+		}
+
+		return text;
+	}
+
+	std::string GetFloatsText(std::initializer_list<float> values)
+	{
+		return GetFloatsText(values.begin(), (int)values.size());
+	}
+
+	//Reads up to numValues comma separated numbers, false if there are more or one isn't a number
+	bool ParseFloats(const std::string& text, double* values, int numValues)
+	{
+		const char* start = text.data();
+		const char* end = text.data() + text.size();
+
+		for (int i = 0; i < numValues && start < end; i++)
+		{
+			std::from_chars_result result = std::from_chars(start, end, values[i]);
+
+			if (result.ec != std::errc())
+				return false;
+
+			start = result.ptr;
+
+			if (start < end && *start == ',')
+				start++;
+		}
+
+		return start == end;
+	}
+
+	std::string GetFractalKeyframeLine(const FractalKeyframe& keyframe)
+	{
+		const FractalParameters& parameters = keyframe.parameters;
+
+		std::string line = "time=" + GetFloatsText(&keyframe.time, 1);
+
+		line += " type=" + std::to_string((int)parameters.type);
+		line += " offset=" + GetFloatsText({ parameters.normalizedCenterOffset.x, parameters.normalizedCenterOffset.y });
+		line += " position=" + GetFloatsText({ parameters.position.x, parameters.position.y });
+		line += " zoom=" + GetFloatsText({ parameters.zoom });
+		line += " iterations=" + std::to_string(parameters.maxIterations);
+		line += " power=" + GetFloatsText({ parameters.power });
+		line += " c=" + GetFloatsText({ parameters.c.x, parameters.c.y });
+
+		float roots[NUM_MAX_ROOTS * 2];
+
+		for (int i = 0; i < NUM_MAX_ROOTS; i++)
+		{
+			roots[i * 2] = parameters.roots[i].x;
+			roots[i * 2 + 1] = parameters.roots[i].y;
+		}
+
+		line += " roots=" + GetFloatsText(roots, NUM_MAX_ROOTS * 2);
+		line += " a=" + GetFloatsText({ parameters.a.x, parameters.a.y });
+		line += " banding=" + std::string(parameters.colorBanding ? "1" : "0");
+		line += " fastMath=" + std::string(parameters.fastMath ? "1" : "0");
+
+		return line;
+	}
+
+	bool ParseFractalKeyframeLine(const std::string& line, FractalKeyframe& keyframe)
+	{
+		keyframe = FractalKeyframe{ 0.0, FractalParameters() };
+
+		std::istringstream fields(line);
+		std::string field;
+
+		bool hasTime = false;
+
+		while (fields >> field)
+		{
+			size_t separator = field.find('=');
+
+			if (separator == std::string::npos)
+				return false;
+
+			std::string name = field.substr(0, separator);
+			std::string value = field.substr(separator + 1);
+
+			double values[NUM_MAX_ROOTS * 2] = {};
+			FractalParameters& parameters = keyframe.parameters;
+
+			if (!ParseFloats(value, values, name == "roots" ? NUM_MAX_ROOTS * 2 : 2))
+				return false;
+
+			if (name == "time")
+			{
+				keyframe.time = values[0];
+				hasTime = true;
+			}
+			else if (name == "type")
+			{
+				parameters.type = (FractalType)(int)values[0];
+			}
+			else if (name == "offset")
+			{
+				parameters.normalizedCenterOffset = Vector2{ (float)values[0], (float)values[1] };
+			}
+			else if (name == "position")
+			{
+				parameters.position = Vector2{ (float)values[0], (float)values[1] };
+			}
+			else if (name == "zoom")
+			{
+				parameters.zoom = (float)values[0];
+			}
+			else if (name == "iterations")
+			{
+				parameters.maxIterations = (int)values[0];
+			}
+			else if (name == "power")
+			{
+				parameters.power = (float)values[0];
+			}
+			else if (name == "c")
+			{
+				parameters.c = Vector2{ (float)values[0], (float)values[1] };
+			}
+			else if (name == "roots")
+			{
+				for (int i = 0; i < NUM_MAX_ROOTS; i++)
+					parameters.roots[i] = Vector2{ (float)values[i * 2], (float)values[i * 2 + 1] };
+			}
+			else if (name == "a")
+			{
+				parameters.a = Vector2{ (float)values[0], (float)values[1] };
+			}
+			else if (name == "banding")
+			{
+				parameters.colorBanding = values[0] != 0.0;
+			}
+			else if (name == "fastMath")
+			{
+				parameters.fastMath = values[0] != 0.0;
+			}
+		}
+
+		return hasTime && keyframe.parameters.zoom > 0.0f;
+	}
+
+	std::vector<FractalKeyframe> LoadFractalKeyframes(const std::string& fileName)
+	{
+		std::ifstream file(fileName);
+
+		if (!file)
+			throw std::runtime_error("Failed to open keyframes " + fileName);
+
+		std::vector<FractalKeyframe> keyframes;
+		std::string line;
+
+		for (int lineNumber = 1; std::getline(file, line); lineNumber++)
+		{
+			//Blank lines & # comments
+			if (line.find_first_not_of(" \t\r") == std::string::npos || line[line.find_first_not_of(" \t\r")] == '#')
+				continue;
+
+			FractalKeyframe keyframe;
+
+			if (!ParseFractalKeyframeLine(line, keyframe))
+				throw std::runtime_error("Invalid keyframe on line " + std::to_string(lineNumber) + " of " + fileName);
+
+			keyframes.push_back(keyframe);
+		}
+
+		std::stable_sort(keyframes.begin(), keyframes.end(), [](const FractalKeyframe& a, const FractalKeyframe& b) { return a.time < b.time; });
+
+		return keyframes;
+	}
+
+	void AppendFractalKeyframe(const std::string& fileName, const FractalKeyframe& keyframe)
+	{
+		std::ofstream file(fileName, std::ios::app);
+		file << GetFractalKeyframeLine(keyframe) << '\n';
+
+		if (!file)
+			throw std::runtime_error("Failed to write keyframe to " + fileName);
+	}
+	#pragma endregion
+
+	#pragma region Rendering
+	int GetFractalAnimationNumFrames(const std::vector<FractalKeyframe>& keyframes, const FractalAnimationSettings& settings)
+	{
+		if (keyframes.empty())
+			return 0;
+
+		//The last keyframe is the last frame
+		return (int)std::floor((keyframes.back().time - keyframes.front().time) * settings.framesPerSecond + 1e-6) + 1;
+	}
+
+	int RenderFractalAnimation(const std::vector<FractalKeyframe>& keyframes, const FractalAnimationSettings& settings, const std::function<bool(int frame)>& skipFrame,
+		const std::function<void(int frame, const Image& image)>& writeFrame, const std::function<void(int framesDone)>& progress,
+		const std::function<void(const FractalParameters& parameters, Color* pixels)>& renderFrame)
+	{
+		int numFrames = GetFractalAnimationNumFrames(keyframes, settings);
+
+		std::mutex writeMutex;
+		std::condition_variable writeCondition;
+
+		//Ordered: the next frame to be written, the threads with later frames wait for it
+		int nextFrame = 0;
+		int framesDone = 0;
+
+		//Each thread renders a whole frame on its own (no threads within a frame), the items are handed out in order
+		//so every frame a thread waits for is already being rendered by another
+		long long numRendered = RunOnAllThreads(numFrames, [&](int frame)
+		{
+			bool skipped = skipFrame(frame);
+
+			Image image = { 0 };
+
+			if (!skipped)
+			{
+				double time = keyframes.front().time + (double)frame / settings.framesPerSecond;
+				FractalParameters parameters = InterpolateFractalKeyframes(keyframes, time);
+
+				image = GenImageColor(settings.width, settings.height, BLACK);
+
+				if (renderFrame)
+				{
+					renderFrame(parameters, (Color*)image.data);
+				}
+				else
+				{
+					CPUFractalView view = GetCPUFractalView(parameters, settings.width, settings.height, false, settings.flipY);
+					RenderFractalRectCPU(parameters, view, (Color*)image.data, settings.width, 0, 0, settings.width, settings.height);
+				}
+			}
+
+			std::unique_lock<std::mutex> lock(writeMutex);
+
+			if (settings.ordered)
+			{
+				writeCondition.wait(lock, [&]() { return nextFrame == frame; });
+
+				if (!skipped)
+					writeFrame(frame, image);
+
+				nextFrame++;
+				writeCondition.notify_all();
+			}
+			else if (!skipped)
+			{
+				//Written outside of the lock, so frames are encoded on all threads at once
+				lock.unlock();
+				writeFrame(frame, image);
+				lock.lock();
+			}
+
+			framesDone++;
+			progress(framesDone);
+
+			lock.unlock();
+
+			if (!skipped)
+				UnloadImage(image);
+
+			return skipped ? 0ll : 1ll;
+		});
+
+		return (int)numRendered;
+	}
+	#pragma endregion
+}
@@ -0,0 +1,345 @@
+#include "Buddhabrot.h"
+
+#include <cmath>
+#include <algorithm>
+
+#include "raylib.h"
+
+namespace Explorer
+{
+	//Cells per side of the importance sampling grid
+	const int BUDDHABROT_GRID_SIZE = 128;
+
+	//Importance sampling weights, relative to a cell on the boundary of the set
+	const double BUDDHABROT_INTERIOR_CELL_WEIGHT = 0.1;
+	const double BUDDHABROT_EXTERIOR_CELL_WEIGHT = 0.05;
+
+	bool FractalSupportsBuddhabrot(FractalType type)
+	{
+		return type == FRACTAL_MULTIBROT || type == FRACTAL_MULTICORN || type == FRACTAL_BURNING_SHIP;
+	}
+
+	#pragma region Orbits
+	//z^power + c, with z transformed first for the multicorn & burning ship, same as the shaders
+	inline void StepOrbit(const FractalParameters& parameters, bool integerPower, double& zX, double& zY, double cX, double cY)
+	{
+		double baseX = parameters.type == FRACTAL_BURNING_SHIP ? std::abs(zX) : zX;
+		double baseY = parameters.type == FRACTAL_MULTICORN ? -zY : (parameters.type == FRACTAL_BURNING_SHIP ? std::abs(zY) : zY);
+
+		double newX = baseX;
+		double newY = baseY;
+
+		if (integerPower)
+		{
+			for (int i = 1; i < (int)parameters.power; i++)
+			{
+				double multipliedX = newX * baseX - newY * baseY;
+				newY = newX * baseY + newY * baseX;
+				newX = multipliedX;
+			}
+		}
+		else if (baseX * baseX + baseY * baseY == 0.0)
+		{
+			newX = 0.0;
+			newY = 0.0;
+		}
+		else
+		{
+			//the shaders' atan2 range is (-pi/2, 3pi/2]
+			double angle = (double)parameters.power * (baseX > 0.0 ? std::atan(baseY / baseX) : std::atan(baseY / baseX) + PI);
+			double magnitude = std::pow(baseX * baseX + baseY * baseY, (double)parameters.power / 2.0);
+
+			newX = magnitude * std::cos(angle);
+			newY = magnitude * std::sin(angle);
+		}
+
+		zX = newX + cX;
+		zY = newY + cY;
+	}
+
+	//Iterations until z escapes, maxIterations if it doesn't
+	inline int GetOrbitLength(const FractalParameters& parameters, bool integerPower, double escapeRadiusSquared, double cX, double cY)
+	{
+		double zX = 0.0;
+		double zY = 0.0;
+
+		for (int iteration = 0; iteration < parameters.maxIterations; iteration++)
+		{
+			StepOrbit(parameters, integerPower, zX, zY, cX, cY);
+
+			if (zX * zX + zY * zY > escapeRadiusSquared)
+				return iteration + 1;
+		}
+
+		return parameters.maxIterations;
+	}
+	#pragma endregion
+
+	void Buddhabrot::Reset(const FractalParameters& fractalParameters, int imageWidth, int imageHeight, bool flipY)
+	{
+		parameters = fractalParameters;
+		view = GetCPUFractalView(parameters, imageWidth, imageHeight, false, flipY);
+
+		width = imageWidth;
+		height = imageHeight;
+
+		histogram.assign((size_t)width * (size_t)height, 0.0f);
+
+		int numBatches = GetCPUFractalNumThreads();
+
+		batchHistograms.resize(numBatches);
+		batchRandom.resize(numBatches);
+
+		for (int i = 0; i < numBatches; i++)
+		{
+			batchHistograms[i].assign((size_t)width * (size_t)height, 0.0f);
+			batchRandom[i].seed((unsigned long long)i + 1);
+		}
+
+		numSamples = 0;
+		numIterations = 0;
+
+		PrepareImportanceSampling();
+	}
+
+	void Buddhabrot::PrepareImportanceSampling()
+	{
+		//|z^n + c| keeps growing once |z| > max(2, 2^(1 / (n - 1)))
+		float power = parameters.power;
+		sampleRadius = power > 1.0f ? std::min(16.0f, std::max(2.0f, std::pow(2.0f, 1.0f / (power - 1.0f)))) : 2.0f;
+
+		bool integerPower = std::fmod(power, 1.0f) == 0.0f && power > 0.0f;
+		double escapeRadiusSquared = (double)sampleRadius * (double)sampleRadius;
+
+		//Escape time at the cells' corners
+		int numCorners = BUDDHABROT_GRID_SIZE + 1;
+		double cellSize = 2.0 * (double)sampleRadius / (double)BUDDHABROT_GRID_SIZE;
+
+		std::vector<int> cornerIterations((size_t)numCorners * (size_t)numCorners);
+
+		RunOnAllThreads(numCorners, [&](int row)
+		{
+			long long iterations = 0;
+
+			for (int column = 0; column < numCorners; column++)
+			{
+				int orbitLength = GetOrbitLength(parameters, integerPower, escapeRadiusSquared, -sampleRadius + column * cellSize, -sampleRadius + row * cellSize);
+				cornerIterations[(size_t)row * (size_t)numCorners + (size_t)column] = orbitLength;
+
+				iterations += orbitLength;
+			}
+
+			return iterations;
+		});
+
+		//Cells with corners both inside & outside contain the boundary, interior cells rarely escape,
+		//exterior cells escape in a few iterations & add little, unless they're close enough to take a while
+		numCells = BUDDHABROT_GRID_SIZE * BUDDHABROT_GRID_SIZE;
+		cellCumulativeWeights.resize(numCells);
+
+		double totalWeight = 0.0;
+
+		for (int row = 0; row < BUDDHABROT_GRID_SIZE; row++)
+		{
+			for (int column = 0; column < BUDDHABROT_GRID_SIZE; column++)
+			{
+				int corners[4] =
+				{
+					cornerIterations[(size_t)row * (size_t)numCorners + (size_t)column],
+					cornerIterations[(size_t)row * (size_t)numCorners + (size_t)column + 1],
+					cornerIterations[(size_t)(row + 1) * (size_t)numCorners + (size_t)column],
+					cornerIterations[(size_t)(row + 1) * (size_t)numCorners + (size_t)column + 1]
+				};
+
+				int numInside = 0;
+				int maxOrbitLength = 0;
+
+				for (int corner : corners)
+				{
+					if (corner == parameters.maxIterations)
+						numInside++;
+					else
+						maxOrbitLength = std::max(maxOrbitLength, corner);
+				}
+
+				double weight = 1.0;
+
+				if (numInside == 4)
+					weight = BUDDHABROT_INTERIOR_CELL_WEIGHT;
+				else if (numInside == 0)
+					weight = BUDDHABROT_EXTERIOR_CELL_WEIGHT + (1.0 - BUDDHABROT_EXTERIOR_CELL_WEIGHT) * std::min(1.0, (double)maxOrbitLength / 64.0);
+
+				totalWeight += weight;
+				cellCumulativeWeights[row * BUDDHABROT_GRID_SIZE + column] = totalWeight;
+			}
+		}
+	}
+
+	long long Buddhabrot::AddSamples(long long samples)
+	{
+		if (width <= 0 || height <= 0 || samples <= 0)
+			return 0;
+
+		bool integerPower = std::fmod(parameters.power, 1.0f) == 0.0f && parameters.power > 0.0f;
+		double escapeRadiusSquared = (double)sampleRadius * (double)sampleRadius;
+
+		double cellSize = 2.0 * (double)sampleRadius / (double)BUDDHABROT_GRID_SIZE;
+		double totalWeight = cellCumulativeWeights.back();
+
+		int numBatches = (int)batchHistograms.size();
+
+		//Trace the orbits into the batch histograms
+		long long iterations = RunOnAllThreads(numBatches, [&](int batch)
+		{
+			std::vector<float>& batchHistogram = batchHistograms[batch];
+			std::mt19937_64& random = batchRandom[batch];
+
+			std::uniform_real_distribution<double> weightDistribution(0.0, totalWeight);
+			std::uniform_real_distribution<double> cellDistribution(0.0, cellSize);
+
+			std::vector<double> orbit((size_t)parameters.maxIterations * 2);
+
+			long long batchSamples = samples / numBatches + (batch < samples % numBatches ? 1 : 0);
+			long long batchIterations = 0;
+
+			for (long long sample = 0; sample < batchSamples; sample++)
+			{
+				//Pick a cell by weight, then a point in it
+				int cell = (int)(std::upper_bound(cellCumulativeWeights.begin(), cellCumulativeWeights.end(), weightDistribution(random)) - cellCumulativeWeights.begin());
+				cell = std::min(cell, numCells - 1);
+
+				double cellWeight = cellCumulativeWeights[cell] - (cell > 0 ? cellCumulativeWeights[cell - 1] : 0.0);
+
+				double cX = -sampleRadius + (cell % BUDDHABROT_GRID_SIZE) * cellSize + cellDistribution(random);
+				double cY = -sampleRadius + (cell / BUDDHABROT_GRID_SIZE) * cellSize + cellDistribution(random);
+
+				double zX = 0.0;
+				double zY = 0.0;
+
+				int orbitLength = 0;
+				bool escaped = false;
+
+				while (orbitLength < parameters.maxIterations)
+				{
+					StepOrbit(parameters, integerPower, zX, zY, cX, cY);
+
+					orbit[orbitLength * 2] = zX;
+					orbit[orbitLength * 2 + 1] = zY;
+					orbitLength++;
+
+					if (zX * zX + zY * zY > escapeRadiusSquared)
+					{
+						escaped = true;
+						break;
+					}
+				}
+
+				batchIterations += orbitLength;
+
+				if (!escaped)
+					continue;
+
+				//Cells were picked with probability cellWeight / totalWeight instead of 1 / numCells, so the orbit counts for the difference
+				float sampleWeight = (float)(totalWeight / ((double)numCells * cellWeight));
+
+				for (int i = 0; i < orbitLength; i++)
+				{
+					double pixelX = std::floor((orbit[i * 2] - view.originX) / view.stepX + 0.5);
+					double pixelY = std::floor((orbit[i * 2 + 1] - view.originY) / view.stepY + 0.5);
+
+					if (pixelX < 0.0 || pixelX >= (double)width || pixelY < 0.0 || pixelY >= (double)height)
+						continue;
+
+					batchHistogram[(size_t)pixelY * (size_t)width + (size_t)pixelX] += sampleWeight;
+				}
+			}
+
+			return batchIterations;
+		});
+
+		//Merge the batch histograms, each thread owns a set of rows so nothing is shared
+		RunOnAllThreads(height, [&](int row)
+		{
+			float* rowHistogram = histogram.data() + (size_t)row * (size_t)width;
+
+			for (std::vector<float>& batchHistogram : batchHistograms)
+			{
+				float* rowBatchHistogram = batchHistogram.data() + (size_t)row * (size_t)width;
+
+				for (int column = 0; column < width; column++)
+				{
+					rowHistogram[column] += rowBatchHistogram[column];
+					rowBatchHistogram[column] = 0.0f;
+				}
+			}
+
+			return 0ll;
+		});
+
+		numSamples += samples;
+		numIterations += iterations;
+
+		return iterations;
+	}
+
+	long long Buddhabrot::GetNumSamples() const
+	{
+		return numSamples;
+	}
+
+	long long Buddhabrot::GetNumIterations() const
+	{
+		return numIterations;
+	}
+
+	const FractalParameters& Buddhabrot::GetParameters() const
+	{
+		return parameters;
+	}
+
+	int Buddhabrot::GetWidth() const
+	{
+		return width;
+	}
+
+	int Buddhabrot::GetHeight() const
+	{
+		return height;
+	}
+
+	void Buddhabrot::UpdateImage(Image& image) const
+	{
+		if (image.width != width || image.height != height || image.format != PIXELFORMAT_UNCOMPRESSED_R8G8B8A8)
+			return;
+
+		//Exposure from a high percentile of the visited pixels' density (estimated from every 16th pixel),
+		//the max is usually a few very bright pixels & the mean is mostly the faint haze around the set
+		std::vector<float> densities;
+		densities.reserve(histogram.size() / 16 + 1);
+
+		for (size_t i = 0; i < histogram.size(); i += 16)
+		{
+			if (histogram[i] > 0.0f)
+				densities.push_back(histogram[i]);
+		}
+
+		float whiteDensity = 0.0f;
+
+		if (!densities.empty())
+		{
+			std::vector<float>::iterator percentile = densities.begin() + (ptrdiff_t)((double)(densities.size() - 1) * 0.995);
+			std::nth_element(densities.begin(), percentile, densities.end());
+
+			whiteDensity = *percentile;
+		}
+
+		Color* pixels = (Color*)image.data;
+
+		for (size_t i = 0; i < histogram.size(); i++)
+		{
+			float brightness = whiteDensity > 0.0f ? std::min(1.0f, histogram[i] / whiteDensity) : 0.0f;
+
+			pixels[i] = Color{ (unsigned char)(255.0f * std::pow(brightness, 0.8f)), (unsigned char)(255.0f * brightness), (unsigned char)(255.0f * std::pow(brightness, 1.3f)), 255 };
+		}
+	}
+}
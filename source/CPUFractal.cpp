@@ -0,0 +1,1171 @@
+#include "CPUFractal.h"
+
+#include <cmath>
+#include <algorithm>
+#include <type_traits>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <deque>
+#include <chrono>
+#include <vector>
+#include <numeric>
+#include <limits>
+#include <functional>
+
+#include "raylib.h"
+
+#include "FastMath.h"
+#include "Profiler.h"
+
+namespace Explorer
+{
+	//Everything that doesn't change per pixel, prepared once per render
+	template<typename Real>
+	struct CPUFractalKernel
+	{
+		int maxIterations;
+
+		Real power;
+		bool integerPower;
+		int integerPowerValue;
+
+		//https://en.wikipedia.org/wiki/Plotting_algorithms_for_the_Mandelbrot_set#Continuous_(smooth)_coloring
+		Real escapeRadiusSquared;
+		bool colorBanding;
+
+		//log(escape power) for smooth coloring, log2 if fast math is enabled
+		float logEscapePower;
+
+		Real cX;
+		Real cY;
+
+		Real aX;
+		Real aY;
+
+		//P(z) = (z - roots[0]) * ... * (z - roots[numRoots - 1]), coefficients[i] multiplies z^i
+		int numRoots;
+		Real rootsX[NUM_MAX_ROOTS];
+		Real rootsY[NUM_MAX_ROOTS];
+		Real coefficientsX[NUM_MAX_ROOTS + 1];
+		Real coefficientsY[NUM_MAX_ROOTS + 1];
+
+		//due to floating imprecision, we might not perfectly land at a root
+		Real tolerance;
+	};
+
+	template<typename Real>
+	CPUFractalKernel<Real> PrepareCPUFractalKernel(const FractalParameters& parameters)
+	{
+		CPUFractalKernel<Real> kernel = {};
+
+		kernel.maxIterations = parameters.maxIterations;
+
+		kernel.power = (Real)parameters.power;
+		kernel.integerPower = std::fmod(parameters.power, 1.0f) == 0.0f && parameters.power > 0.0f;
+		kernel.integerPowerValue = (int)parameters.power;
+
+		kernel.escapeRadiusSquared = parameters.colorBanding ? (Real)(2.0 * 2.0) : (Real)(16.0 * 16.0);
+		kernel.colorBanding = parameters.colorBanding;
+
+		//P(z)+c fractals escape like z^deg(P)
+		float escapePower = parameters.power;
+
+		if (parameters.type == FRACTAL_POLYNOMIAL_2DEG)
+			escapePower = 2.0f;
+		else if (parameters.type == FRACTAL_POLYNOMIAL_3DEG)
+			escapePower = 3.0f;
+
+		kernel.logEscapePower = parameters.fastMath ? FastLog2(escapePower) : std::log(escapePower);
+
+		kernel.cX = (Real)parameters.c.x;
+		kernel.cY = (Real)parameters.c.y;
+
+		kernel.aX = (Real)parameters.a.x;
+		kernel.aY = (Real)parameters.a.y;
+
+		//Expand the roots into coefficients, one (z - root) factor at a time
+		kernel.numRoots = GetFractalNumRoots(parameters.type);
+		kernel.coefficientsX[0] = 1;
+
+		for (int i = 0; i < kernel.numRoots; i++)
+		{
+			Real rootX = kernel.rootsX[i] = (Real)parameters.roots[i].x;
+			Real rootY = kernel.rootsY[i] = (Real)parameters.roots[i].y;
+
+			for (int degree = i + 1; degree >= 0; degree--)
+			{
+				Real lowerX = degree > 0 ? kernel.coefficientsX[degree - 1] : 0;
+				Real lowerY = degree > 0 ? kernel.coefficientsY[degree - 1] : 0;
+
+				Real coefficientX = kernel.coefficientsX[degree];
+				Real coefficientY = kernel.coefficientsY[degree];
+
+				kernel.coefficientsX[degree] = lowerX - (rootX * coefficientX - rootY * coefficientY);
+				kernel.coefficientsY[degree] = lowerY - (rootX * coefficientY + rootY * coefficientX);
+			}
+		}
+
+		kernel.tolerance = parameters.type == FRACTAL_NEWTON_SIN ? (Real)0.01 : (Real)0.35;
+
+		return kernel;
+	}
+
+	#pragma region Complex math
+	//z^power, in place
+	template<typename Real, bool FAST_MATH>
+	inline void ComplexPow(Real& x, Real& y, Real power)
+	{
+		//same as the shaders, 0^power is 0 (pow(0, power) is undefined in glsl)
+		Real magnitudeSquared = x * x + y * y;
+
+		if (magnitudeSquared == 0)
+		{
+			x = 0;
+			y = 0;
+			return;
+		}
+
+		if constexpr (FAST_MATH)
+		{
+			//the shaders' atan2 range is (-pi/2, 3pi/2], which matters for fractional powers
+			float angle = FastAtan2((float)y, (float)x);
+			angle += (float)(angle < -FastMath::HALF_PI) * (2.0f * FastMath::PI_FLOAT);
+
+			float magnitude = FastExp2((float)power * 0.5f * FastLog2((float)magnitudeSquared));
+
+			float sine;
+			float cosine;
+			FastSinCos((float)power * angle, sine, cosine);
+
+			x = (Real)(magnitude * cosine);
+			y = (Real)(magnitude * sine);
+		}
+		else
+		{
+			Real angle = power * (x > 0 ? std::atan(y / x) : std::atan(y / x) + (Real)PI);
+			Real magnitude = std::pow(magnitudeSquared, power / 2);
+
+			x = magnitude * std::cos(angle);
+			y = magnitude * std::sin(angle);
+		}
+	}
+
+	//P(z) (& P'(z) if derivative isn't null) using Horner's method
+	template<typename Real>
+	inline void EvaluatePolynomial(const CPUFractalKernel<Real>& kernel, Real zX, Real zY, Real& pX, Real& pY, Real* derivativeX = nullptr, Real* derivativeY = nullptr)
+	{
+		pX = kernel.coefficientsX[kernel.numRoots];
+		pY = kernel.coefficientsY[kernel.numRoots];
+
+		Real dX = 0;
+		Real dY = 0;
+
+		for (int degree = kernel.numRoots - 1; degree >= 0; degree--)
+		{
+			Real newDX = dX * zX - dY * zY + pX;
+			Real newDY = dX * zY + dY * zX + pY;
+
+			Real newPX = pX * zX - pY * zY + kernel.coefficientsX[degree];
+			Real newPY = pX * zY + pY * zX + kernel.coefficientsY[degree];
+
+			dX = newDX;
+			dY = newDY;
+			pX = newPX;
+			pY = newPY;
+		}
+
+		if (derivativeX)
+		{
+			*derivativeX = dX;
+			*derivativeY = dY;
+		}
+	}
+
+	//a * (p / d), using the shaders' ComplexDivide: its real part is (ac - bd) / (c*c + d*d) instead of (ac + bd) / (c*c + d*d)
+	//the newton fractals are defined by it, so it's mirrored here to render the same images
+	template<typename Real>
+	inline void GetNewtonStep(const CPUFractalKernel<Real>& kernel, Real pX, Real pY, Real dX, Real dY, Real& stepX, Real& stepY)
+	{
+		Real divisor = dX * dX + dY * dY;
+
+		Real quotientX = (pX * dX - pY * dY) / divisor;
+		Real quotientY = (pY * dX - pX * dY) / divisor;
+
+		stepX = kernel.aX * quotientX - kernel.aY * quotientY;
+		stepY = kernel.aX * quotientY + kernel.aY * quotientX;
+	}
+
+	//sin(z) & cos(z) at once
+	//sin(a+bi) = sin(a) * cosh(b) + i * cos(a) * sinh(b), cos(a+bi) = cos(a) * cosh(b) - i * sin(a) * sinh(b)
+	template<typename Real, bool FAST_MATH>
+	inline void ComplexSinCos(Real x, Real y, Real& sinX, Real& sinY, Real& cosX, Real& cosY)
+	{
+		Real sine;
+		Real cosine;
+		Real hyperbolicCosine;
+		Real hyperbolicSine;
+
+		if constexpr (FAST_MATH)
+		{
+			float fastSine;
+			float fastCosine;
+			FastSinCos((float)x, fastSine, fastCosine);
+
+			//cosh(b) = (e^b + e^-b) / 2, sinh(b) = (e^b - e^-b) / 2, e^b = 2^(b * log2(e))
+			float expY = FastExp2((float)y * 1.44269504f);
+
+			sine = (Real)fastSine;
+			cosine = (Real)fastCosine;
+			hyperbolicCosine = (Real)((expY + 1.0f / expY) * 0.5f);
+			hyperbolicSine = (Real)((expY - 1.0f / expY) * 0.5f);
+		}
+		else
+		{
+			sine = std::sin(x);
+			cosine = std::cos(x);
+			hyperbolicCosine = std::cosh(y);
+			hyperbolicSine = std::sinh(y);
+		}
+
+		sinX = sine * hyperbolicCosine;
+		sinY = cosine * hyperbolicSine;
+		cosX = cosine * hyperbolicCosine;
+		cosY = -sine * hyperbolicSine;
+	}
+	#pragma endregion
+
+	#pragma region Coloring
+	//hue in degrees, wrapped like glsl's mod
+	inline Color GetHueColor(float hue)
+	{
+		hue = hue - 360.0f * std::floor(hue / 360.0f);
+
+		//log(power) is 0 for power 1, which makes the smooth coloring term infinite
+		if (!std::isfinite(hue))
+			hue = 0.0f;
+
+		return ColorFromHSV(hue, 1.0f, 1.0f);
+	}
+
+	//Smooth escape time color, black if max iterations was reached
+	template<typename Real, bool FAST_MATH>
+	inline Color GetEscapeColor(const CPUFractalKernel<Real>& kernel, Real zX, Real zY, int complexIterations)
+	{
+		if (complexIterations == kernel.maxIterations)
+			return BLACK;
+
+		float nu = 1.0f;
+
+		//log(log(|z|^2) / 2 / log(2)) / log(power) = log2(log2(|z|^2) / 2) / log2(power)
+		if (!kernel.colorBanding)
+		{
+			if constexpr (FAST_MATH)
+				nu = FastLog2(FastLog2((float)(zX * zX + zY * zY)) * 0.5f) / kernel.logEscapePower;
+			else
+				nu = (float)(std::log(std::log(zX * zX + zY * zY) / 2.0 / std::log(2.0)) / kernel.logEscapePower);
+		}
+
+		return GetHueColor(((float)(complexIterations + 1) - nu) * 3.0f);
+	}
+	#pragma endregion
+
+	#pragma region Kernels
+	//z^power + c, with z transformed first for the multicorn & burning ship
+	template<typename Real, bool FAST_MATH, FractalType TYPE>
+	inline Color SampleEscapeTime(const CPUFractalKernel<Real>& kernel, Real x, Real y, int& iterations)
+	{
+		//julia starts at the pixel, the others start at 0 with the pixel as c
+		Real zX = TYPE == FRACTAL_JULIA ? x : 0;
+		Real zY = TYPE == FRACTAL_JULIA ? y : 0;
+
+		Real cX = TYPE == FRACTAL_JULIA ? kernel.cX : x;
+		Real cY = TYPE == FRACTAL_JULIA ? kernel.cY : y;
+
+		int complexIterations = 0;
+
+		while (zX * zX + zY * zY <= kernel.escapeRadiusSquared && complexIterations < kernel.maxIterations)
+		{
+			Real baseX = TYPE == FRACTAL_BURNING_SHIP ? std::abs(zX) : zX;
+			Real baseY = TYPE == FRACTAL_MULTICORN ? -zY : (TYPE == FRACTAL_BURNING_SHIP ? std::abs(zY) : zY);
+
+			Real newX = baseX;
+			Real newY = baseY;
+
+			//if power is a whole number & above 0, multiply instead of using ComplexPow, it's less expensive
+			if (kernel.integerPower)
+			{
+				for (int i = 1; i < kernel.integerPowerValue; i++)
+				{
+					Real multipliedX = newX * baseX - newY * baseY;
+					newY = newX * baseY + newY * baseX;
+					newX = multipliedX;
+				}
+			}
+			else
+			{
+				ComplexPow<Real, FAST_MATH>(newX, newY, kernel.power);
+			}
+
+			zX = newX + cX;
+			zY = newY + cY;
+
+			complexIterations++;
+		}
+
+		iterations = complexIterations;
+
+		return GetEscapeColor<Real, FAST_MATH>(kernel, zX, zY, complexIterations);
+	}
+
+	//Pixels iterated side by side by RenderEscapeTimeLanes
+	const int CPU_FRACTAL_LANES = 8;
+
+	//SampleEscapeTime for LANES pixels of a row at once, for fast math fractional powers
+	//the loop over the lanes has no branches (escaped lanes keep their z through FastSelect), so compilers vectorize it
+	template<FractalType TYPE, int LANES>
+	long long RenderEscapeTimeLanes(const CPUFractalKernel<float>& kernel, float startX, float stepX, float y, Color* pixels, int numPixels)
+	{
+		float lanesZX[LANES];
+		float lanesZY[LANES];
+		float lanesCX[LANES];
+		float lanesCY[LANES];
+		int lanesIterations[LANES];
+
+		for (int lane = 0; lane < LANES; lane++)
+		{
+			float x = startX + (float)lane * stepX;
+
+			lanesZX[lane] = TYPE == FRACTAL_JULIA ? x : 0.0f;
+			lanesZY[lane] = TYPE == FRACTAL_JULIA ? y : 0.0f;
+			lanesCX[lane] = TYPE == FRACTAL_JULIA ? kernel.cX : x;
+			lanesCY[lane] = TYPE == FRACTAL_JULIA ? kernel.cY : y;
+			lanesIterations[lane] = 0;
+
+			//lanes past the end of the row start escaped
+			if (lane >= numPixels)
+				lanesZX[lane] = 2.0f * kernel.escapeRadiusSquared;
+		}
+
+		for (int iteration = 0; iteration < kernel.maxIterations; iteration++)
+		{
+			int numActive = 0;
+
+			for (int lane = 0; lane < LANES; lane++)
+			{
+				float zX = lanesZX[lane];
+				float zY = lanesZY[lane];
+
+				float magnitudeSquared = zX * zX + zY * zY;
+				bool active = magnitudeSquared <= kernel.escapeRadiusSquared;
+
+				//ComplexPow<float, true> of the transformed z, |z| is the same for all transforms
+				float baseX = TYPE == FRACTAL_BURNING_SHIP ? std::fabs(zX) : zX;
+				float baseY = TYPE == FRACTAL_MULTICORN ? -zY : (TYPE == FRACTAL_BURNING_SHIP ? std::fabs(zY) : zY);
+
+				float angle = FastAtan2(baseY, baseX);
+				angle += (float)(angle < -FastMath::HALF_PI) * (2.0f * FastMath::PI_FLOAT);
+
+				float magnitude = FastExp2(kernel.power * 0.5f * FastLog2(magnitudeSquared));
+				magnitude = FastSelect(magnitudeSquared == 0.0f, 0.0f, magnitude);
+
+				float sine;
+				float cosine;
+				FastSinCos(kernel.power * angle, sine, cosine);
+
+				lanesZX[lane] = FastSelect(active, magnitude * cosine + lanesCX[lane], zX);
+				lanesZY[lane] = FastSelect(active, magnitude * sine + lanesCY[lane], zY);
+				lanesIterations[lane] += active;
+
+				numActive += active;
+			}
+
+			if (numActive == 0)
+				break;
+		}
+
+		long long totalIterations = 0;
+
+		for (int lane = 0; lane < numPixels; lane++)
+		{
+			pixels[lane] = GetEscapeColor<float, true>(kernel, lanesZX[lane], lanesZY[lane], lanesIterations[lane]);
+			totalIterations += lanesIterations[lane];
+		}
+
+		return totalIterations;
+	}
+
+	//P(z) + c
+	template<typename Real, bool FAST_MATH>
+	inline Color SamplePolynomial(const CPUFractalKernel<Real>& kernel, Real x, Real y, int& iterations)
+	{
+		Real zX = 0;
+		Real zY = 0;
+
+		int complexIterations = 0;
+
+		while (zX * zX + zY * zY <= kernel.escapeRadiusSquared && complexIterations < kernel.maxIterations)
+		{
+			Real pX;
+			Real pY;
+			EvaluatePolynomial(kernel, zX, zY, pX, pY);
+
+			zX = pX + x;
+			zY = pY + y;
+
+			complexIterations++;
+		}
+
+		iterations = complexIterations;
+
+		return GetEscapeColor<Real, FAST_MATH>(kernel, zX, zY, complexIterations);
+	}
+
+	//z - a * (P(z) / P'(z)), colored by the root it lands on
+	template<typename Real>
+	inline Color SampleNewtonPolynomial(const CPUFractalKernel<Real>& kernel, Real x, Real y, int& iterations)
+	{
+		Real zX = x;
+		Real zY = y;
+
+		for (int iteration = 0; iteration < kernel.maxIterations; iteration++)
+		{
+			Real pX;
+			Real pY;
+			Real dX;
+			Real dY;
+			EvaluatePolynomial(kernel, zX, zY, pX, pY, &dX, &dY);
+
+			Real stepX;
+			Real stepY;
+			GetNewtonStep(kernel, pX, pY, dX, dY, stepX, stepY);
+
+			zX -= stepX;
+			zY -= stepY;
+
+			//near a root if the step is within tolerance, then find the root within tolerance
+			if (std::abs(stepX) <= kernel.tolerance && std::abs(stepY) <= kernel.tolerance)
+			{
+				for (int i = 0; i < kernel.numRoots; i++)
+				{
+					if (std::abs(kernel.rootsX[i] - zX) <= kernel.tolerance && std::abs(kernel.rootsY[i] - zY) <= kernel.tolerance)
+					{
+						iterations = iteration + 1;
+						return GetHueColor((float)i * (360.0f / (float)kernel.numRoots));
+					}
+				}
+			}
+		}
+
+		iterations = kernel.maxIterations;
+
+		return BLACK;
+	}
+
+	//z - a * (sin(z) / cos(z)), colored by the iteration a root was found
+	template<typename Real, bool FAST_MATH>
+	inline Color SampleNewtonSin(const CPUFractalKernel<Real>& kernel, Real x, Real y, int& iterations)
+	{
+		Real zX = x;
+		Real zY = y;
+
+		for (int iteration = 0; iteration < kernel.maxIterations; iteration++)
+		{
+			Real sinX;
+			Real sinY;
+			Real cosX;
+			Real cosY;
+			ComplexSinCos<Real, FAST_MATH>(zX, zY, sinX, sinY, cosX, cosY);
+
+			Real stepX;
+			Real stepY;
+			GetNewtonStep(kernel, sinX, sinY, cosX, cosY, stepX, stepY);
+
+			zX -= stepX;
+			zY -= stepY;
+
+			ComplexSinCos<Real, FAST_MATH>(zX, zY, sinX, sinY, cosX, cosY);
+
+			if (std::abs(sinX) <= kernel.tolerance && std::abs(sinY) <= kernel.tolerance)
+			{
+				iterations = iteration + 1;
+				return GetHueColor((float)iteration * 5.0f);
+			}
+		}
+
+		iterations = kernel.maxIterations;
+
+		return BLACK;
+	}
+
+	template<typename Real, bool FAST_MATH, FractalType TYPE>
+	inline Color SampleFractal(const CPUFractalKernel<Real>& kernel, Real x, Real y, int& iterations)
+	{
+		if constexpr (TYPE == FRACTAL_NEWTON_3DEG || TYPE == FRACTAL_NEWTON_4DEG || TYPE == FRACTAL_NEWTON_5DEG)
+			return SampleNewtonPolynomial(kernel, x, y, iterations);
+		else if constexpr (TYPE == FRACTAL_NEWTON_SIN)
+			return SampleNewtonSin<Real, FAST_MATH>(kernel, x, y, iterations);
+		else if constexpr (TYPE == FRACTAL_POLYNOMIAL_2DEG || TYPE == FRACTAL_POLYNOMIAL_3DEG)
+			return SamplePolynomial<Real, FAST_MATH>(kernel, x, y, iterations);
+		else
+			return SampleEscapeTime<Real, FAST_MATH, TYPE>(kernel, x, y, iterations);
+	}
+	#pragma endregion
+
+	#pragma region Symmetry
+	//z -> i^quarterTurns * z, or z -> i^quarterTurns * conj(z)
+	Vector2 ApplySymmetry(Vector2 z, int quarterTurns, bool conjugate)
+	{
+		if (conjugate)
+			z.y = -z.y;
+
+		for (int i = 0; i < quarterTurns; i++)
+			z = Vector2{ -z.y, z.x };
+
+		return z;
+	}
+
+	//i^quarterTurns is an nth root of unity
+	bool IsRootOfUnity(int quarterTurns, int n)
+	{
+		return (quarterTurns * (n % 4)) % 4 == 0;
+	}
+
+	//Does the fractal look the same after the symmetry, also fills mappedRoots for fractals with roots
+	bool IsFractalSymmetric(const FractalParameters& parameters, int quarterTurns, bool conjugate, int* mappedRoots)
+	{
+		//the shaders' atan2 puts the branch cut of fractional powers at -pi/2, which isn't symmetric
+		bool integerPower = std::fmod(parameters.power, 1.0f) == 0.0f && parameters.power > 0.0f;
+		int n = (int)parameters.power;
+
+		bool rotationSymmetric = false;
+		bool conjugateSymmetric = false;
+
+		switch (parameters.type)
+		{
+			case FRACTAL_MULTIBROT:
+				//c -> w * c gives z -> w * z if w^(n - 1) = 1
+				rotationSymmetric = integerPower && IsRootOfUnity(quarterTurns, n - 1);
+				conjugateSymmetric = integerPower;
+				break;
+			case FRACTAL_MULTICORN:
+				//c -> w * c gives z -> w * z if conj(w)^n = w, so w^(n + 1) = 1
+				rotationSymmetric = integerPower && IsRootOfUnity(quarterTurns, n + 1);
+				conjugateSymmetric = integerPower;
+				break;
+			case FRACTAL_JULIA:
+				//(w * z)^n + c = z^n + c if w^n = 1
+				rotationSymmetric = integerPower && IsRootOfUnity(quarterTurns, n);
+				conjugateSymmetric = integerPower && parameters.c.y == 0.0f;
+				break;
+			case FRACTAL_NEWTON_3DEG:
+			case FRACTAL_NEWTON_4DEG:
+			case FRACTAL_NEWTON_5DEG:
+			case FRACTAL_NEWTON_SIN:
+				//the shaders' ComplexDivide keeps sign flips & conjugates, but not quarter turns
+				rotationSymmetric = quarterTurns % 2 == 0;
+				conjugateSymmetric = parameters.a.y == 0.0f;
+				break;
+			case FRACTAL_POLYNOMIAL_2DEG:
+			case FRACTAL_POLYNOMIAL_3DEG:
+				rotationSymmetric = quarterTurns == 0;
+				conjugateSymmetric = true;
+				break;
+			default: //Or FRACTAL_BURNING_SHIP & FRACTAL_UNKNOWN
+				return false;
+		}
+
+		if (!rotationSymmetric || (conjugate && !conjugateSymmetric))
+			return false;
+
+		//The roots have to map onto the roots
+		int numRoots = GetFractalNumRoots(parameters.type);
+
+		for (int i = 0; i < numRoots; i++)
+		{
+			Vector2 mappedRoot = ApplySymmetry(parameters.roots[i], quarterTurns, conjugate);
+			mappedRoots[i] = -1;
+
+			for (int j = 0; j < numRoots; j++)
+			{
+				if (std::abs(mappedRoot.x - parameters.roots[j].x) <= 1e-5f && std::abs(mappedRoot.y - parameters.roots[j].y) <= 1e-5f)
+				{
+					mappedRoots[i] = j;
+					break;
+				}
+			}
+
+			if (mappedRoots[i] == -1)
+				return false;
+		}
+
+		return true;
+	}
+
+	//Turns the symmetry into pixel coordinates, false if it doesn't map pixel centers onto pixel centers
+	bool GetPixelSymmetry(const CPUFractalView& view, CPUFractalSymmetry& symmetry)
+	{
+		Vector2 mappedX = ApplySymmetry(Vector2{ 1.0f, 0.0f }, symmetry.quarterTurns, symmetry.conjugate);
+		Vector2 mappedY = ApplySymmetry(Vector2{ 0.0f, 1.0f }, symmetry.quarterTurns, symmetry.conjugate);
+
+		//fractal position (originX + x * stepX, originY + y * stepY) maps to the pixel at:
+		//x' = (xx * (originX + x * stepX) + xy * (originY + y * stepY) - originX) / stepX, same for y'
+		double offsetX = ((double)mappedX.x * view.originX + (double)mappedY.x * view.originY - view.originX) / view.stepX;
+		double offsetY = ((double)mappedX.y * view.originX + (double)mappedY.y * view.originY - view.originY) / view.stepY;
+
+		double stepRatio = view.stepY / view.stepX;
+
+		//within a thousandth of a pixel
+		if (std::abs(offsetX - std::round(offsetX)) > 1e-3 || std::abs(offsetY - std::round(offsetY)) > 1e-3)
+			return false;
+
+		if (std::abs(offsetX) > 1e9 || std::abs(offsetY) > 1e9 || std::abs(std::abs(stepRatio) - 1.0) > 1e-9)
+			return false;
+
+		int stepSign = stepRatio > 0.0 ? 1 : -1;
+
+		symmetry.offsetX = (int)std::round(offsetX);
+		symmetry.xx = (int)mappedX.x;
+		symmetry.xy = (int)mappedY.x * stepSign;
+
+		symmetry.offsetY = (int)std::round(offsetY);
+		symmetry.yx = (int)mappedX.y * stepSign;
+		symmetry.yy = (int)mappedY.y;
+
+		return true;
+	}
+
+	int GetCPUFractalSymmetries(const FractalParameters& parameters, const CPUFractalView& view, CPUFractalSymmetry* symmetries)
+	{
+		int numSymmetries = 0;
+
+		for (int quarterTurns = 0; quarterTurns < 4; quarterTurns++)
+		{
+			for (int conjugate = 0; conjugate < 2; conjugate++)
+			{
+				//identity
+				if (quarterTurns == 0 && conjugate == 0)
+					continue;
+
+				CPUFractalSymmetry& symmetry = symmetries[numSymmetries];
+				symmetry.quarterTurns = quarterTurns;
+				symmetry.conjugate = conjugate == 1;
+
+				if (IsFractalSymmetric(parameters, quarterTurns, symmetry.conjugate, symmetry.mappedRoots) && GetPixelSymmetry(view, symmetry))
+					numSymmetries++;
+			}
+		}
+
+		return numSymmetries;
+	}
+
+	//Pixel (x, y) is copied from the first pixel (in row order) of the view the symmetries map it to,
+	//returns the index of that symmetry, or -1 if (x, y) is the first & has to be iterated
+	inline int GetSymmetrySource(const CPUFractalSymmetry* symmetries, int numSymmetries, int x, int y, int width, int height, int& sourceX, int& sourceY)
+	{
+		int source = -1;
+
+		sourceX = x;
+		sourceY = y;
+
+		for (int i = 0; i < numSymmetries; i++)
+		{
+			const CPUFractalSymmetry& symmetry = symmetries[i];
+
+			int mappedX = symmetry.offsetX + symmetry.xx * x + symmetry.xy * y;
+			int mappedY = symmetry.offsetY + symmetry.yx * x + symmetry.yy * y;
+
+			if (mappedX < 0 || mappedX >= width || mappedY < 0 || mappedY >= height)
+				continue;
+
+			if (mappedY < sourceY || (mappedY == sourceY && mappedX < sourceX))
+			{
+				source = i;
+				sourceX = mappedX;
+				sourceY = mappedY;
+			}
+		}
+
+		return source;
+	}
+	#pragma endregion
+
+	#pragma region Rendering
+	//LANES: pixels iterated at once by the fast math fractional power kernel, 1 samples them one at a time like the others
+	template<typename Real, bool FAST_MATH, FractalType TYPE, int LANES = CPU_FRACTAL_LANES>
+	long long RenderRect(const CPUFractalKernel<Real>& kernel, const CPUFractalView& view, Color* pixels, int rowStride, int x, int y, int width, int height)
+	{
+		long long totalIterations = 0;
+
+		for (int row = y; row < y + height; row++)
+		{
+			Real fractalY = (Real)(view.originY + (double)row * view.stepY);
+			Color* rowPixels = pixels + (size_t)row * (size_t)rowStride;
+
+			//fractional powers go through the vectorized lanes
+			if constexpr (LANES > 1 && FAST_MATH && std::is_same_v<Real, float> && (TYPE == FRACTAL_MULTIBROT || TYPE == FRACTAL_MULTICORN || TYPE == FRACTAL_BURNING_SHIP || TYPE == FRACTAL_JULIA))
+			{
+				if (!kernel.integerPower)
+				{
+					for (int column = x; column < x + width; column += LANES)
+					{
+						int numPixels = std::min(LANES, x + width - column);
+						totalIterations += RenderEscapeTimeLanes<TYPE, LANES>(kernel, (float)(view.originX + (double)column * view.stepX), (float)view.stepX, fractalY, rowPixels + column, numPixels);
+					}
+
+					continue;
+				}
+			}
+
+			for (int column = x; column < x + width; column++)
+			{
+				int iterations = 0;
+				rowPixels[column] = SampleFractal<Real, FAST_MATH, TYPE>(kernel, (Real)(view.originX + (double)column * view.stepX), fractalY, iterations);
+
+				totalIterations += iterations;
+			}
+		}
+
+		return totalIterations;
+	}
+
+	//Picks the kernel for the fractal type, so the type isn't checked per pixel
+	template<typename Real, bool FAST_MATH, int LANES = CPU_FRACTAL_LANES>
+	long long RenderRectForType(const FractalParameters& parameters, const CPUFractalView& view, Color* pixels, int rowStride, int x, int y, int width, int height)
+	{
+		CPUFractalKernel<Real> kernel = PrepareCPUFractalKernel<Real>(parameters);
+
+		switch (parameters.type)
+		{
+			case FRACTAL_MULTIBROT:
+				return RenderRect<Real, FAST_MATH, FRACTAL_MULTIBROT, LANES>(kernel, view, pixels, rowStride, x, y, width, height);
+			case FRACTAL_MULTICORN:
+				return RenderRect<Real, FAST_MATH, FRACTAL_MULTICORN, LANES>(kernel, view, pixels, rowStride, x, y, width, height);
+			case FRACTAL_BURNING_SHIP:
+				return RenderRect<Real, FAST_MATH, FRACTAL_BURNING_SHIP, LANES>(kernel, view, pixels, rowStride, x, y, width, height);
+			case FRACTAL_JULIA:
+				return RenderRect<Real, FAST_MATH, FRACTAL_JULIA, LANES>(kernel, view, pixels, rowStride, x, y, width, height);
+			case FRACTAL_NEWTON_3DEG:
+				return RenderRect<Real, FAST_MATH, FRACTAL_NEWTON_3DEG, LANES>(kernel, view, pixels, rowStride, x, y, width, height);
+			case FRACTAL_NEWTON_4DEG:
+				return RenderRect<Real, FAST_MATH, FRACTAL_NEWTON_4DEG, LANES>(kernel, view, pixels, rowStride, x, y, width, height);
+			case FRACTAL_NEWTON_5DEG:
+				return RenderRect<Real, FAST_MATH, FRACTAL_NEWTON_5DEG, LANES>(kernel, view, pixels, rowStride, x, y, width, height);
+			case FRACTAL_NEWTON_SIN:
+				return RenderRect<Real, FAST_MATH, FRACTAL_NEWTON_SIN, LANES>(kernel, view, pixels, rowStride, x, y, width, height);
+			case FRACTAL_POLYNOMIAL_2DEG:
+				return RenderRect<Real, FAST_MATH, FRACTAL_POLYNOMIAL_2DEG, LANES>(kernel, view, pixels, rowStride, x, y, width, height);
+			case FRACTAL_POLYNOMIAL_3DEG:
+				return RenderRect<Real, FAST_MATH, FRACTAL_POLYNOMIAL_3DEG, LANES>(kernel, view, pixels, rowStride, x, y, width, height);
+			default: //Or FRACTAL_UNKNOWN
+				return 0;
+		}
+	}
+
+	template<typename Real, bool FAST_MATH, FractalType TYPE>
+	long long RenderPoints(const CPUFractalKernel<Real>& kernel, const double* pointsX, const double* pointsY, Color* pixels, int numPoints)
+	{
+		long long totalIterations = 0;
+
+		for (int i = 0; i < numPoints; i++)
+		{
+			int iterations = 0;
+			pixels[i] = SampleFractal<Real, FAST_MATH, TYPE>(kernel, (Real)pointsX[i], (Real)pointsY[i], iterations);
+
+			totalIterations += iterations;
+		}
+
+		return totalIterations;
+	}
+
+	template<typename Real, bool FAST_MATH>
+	long long RenderPointsForType(const FractalParameters& parameters, const double* pointsX, const double* pointsY, Color* pixels, int numPoints)
+	{
+		CPUFractalKernel<Real> kernel = PrepareCPUFractalKernel<Real>(parameters);
+
+		switch (parameters.type)
+		{
+			case FRACTAL_MULTIBROT:
+				return RenderPoints<Real, FAST_MATH, FRACTAL_MULTIBROT>(kernel, pointsX, pointsY, pixels, numPoints);
+			case FRACTAL_MULTICORN:
+				return RenderPoints<Real, FAST_MATH, FRACTAL_MULTICORN>(kernel, pointsX, pointsY, pixels, numPoints);
+			case FRACTAL_BURNING_SHIP:
+				return RenderPoints<Real, FAST_MATH, FRACTAL_BURNING_SHIP>(kernel, pointsX, pointsY, pixels, numPoints);
+			case FRACTAL_JULIA:
+				return RenderPoints<Real, FAST_MATH, FRACTAL_JULIA>(kernel, pointsX, pointsY, pixels, numPoints);
+			case FRACTAL_NEWTON_3DEG:
+				return RenderPoints<Real, FAST_MATH, FRACTAL_NEWTON_3DEG>(kernel, pointsX, pointsY, pixels, numPoints);
+			case FRACTAL_NEWTON_4DEG:
+				return RenderPoints<Real, FAST_MATH, FRACTAL_NEWTON_4DEG>(kernel, pointsX, pointsY, pixels, numPoints);
+			case FRACTAL_NEWTON_5DEG:
+				return RenderPoints<Real, FAST_MATH, FRACTAL_NEWTON_5DEG>(kernel, pointsX, pointsY, pixels, numPoints);
+			case FRACTAL_NEWTON_SIN:
+				return RenderPoints<Real, FAST_MATH, FRACTAL_NEWTON_SIN>(kernel, pointsX, pointsY, pixels, numPoints);
+			case FRACTAL_POLYNOMIAL_2DEG:
+				return RenderPoints<Real, FAST_MATH, FRACTAL_POLYNOMIAL_2DEG>(kernel, pointsX, pointsY, pixels, numPoints);
+			case FRACTAL_POLYNOMIAL_3DEG:
+				return RenderPoints<Real, FAST_MATH, FRACTAL_POLYNOMIAL_3DEG>(kernel, pointsX, pointsY, pixels, numPoints);
+			default: //Or FRACTAL_UNKNOWN
+				return 0;
+		}
+	}
+
+	//Set by SetCPUFractalNumThreads, 0: every hardware thread
+	int cpuFractalNumThreads = 0;
+
+	int GetCPUFractalNumThreads()
+	{
+#ifdef PLATFORM_WEB
+		//The web build doesn't use pthreads
+		return 1;
+#else
+		if (cpuFractalNumThreads > 0)
+			return cpuFractalNumThreads;
+
+		return std::max(1, (int)std::thread::hardware_concurrency());
+#endif
+	}
+
+	void SetCPUFractalNumThreads(int numThreads)
+	{
+		cpuFractalNumThreads = std::max(numThreads, 0);
+	}
+
+	long long RunOnAllThreads(int numItems, const std::function<long long(int item)>& work)
+	{
+		std::atomic<int> nextItem = 0;
+		std::atomic<long long> total = 0;
+
+		auto worker = [&]()
+		{
+			PROFILE_ZONE("Render worker");
+
+			long long workerTotal = 0;
+
+			for (int item = nextItem++; item < numItems; item = nextItem++)
+				workerTotal += work(item);
+
+			total += workerTotal;
+		};
+
+		int numThreads = std::min(GetCPUFractalNumThreads(), numItems);
+
+		std::vector<std::thread> threads;
+
+		for (int i = 1; i < numThreads; i++)
+		{
+			threads.emplace_back([&]()
+			{
+				PROFILE_THREAD("Render worker");
+				worker();
+			});
+		}
+
+		worker();
+
+		for (std::thread& thread : threads)
+			thread.join();
+
+		return total;
+	}
+
+	long long RunOnAllThreadsStealing(const std::vector<int>& items, const std::function<long long(int item)>& work, CPUFractalThreadStats* stats)
+	{
+		struct ThreadQueue
+		{
+			std::mutex mutex;
+			std::deque<int> items;
+		};
+
+		int numThreads = std::max(std::min(GetCPUFractalNumThreads(), (int)items.size()), 1);
+
+		std::vector<ThreadQueue> queues(numThreads);
+
+		for (size_t i = 0; i < items.size(); i++)
+			queues[i % (size_t)numThreads].items.push_back(items[i]);
+
+		std::vector<double> busySeconds(numThreads, 0.0);
+
+		std::atomic<long long> total = 0;
+		std::atomic<int> numSteals = 0;
+
+		auto worker = [&](int thread)
+		{
+			PROFILE_ZONE("Render worker");
+
+			auto startTime = std::chrono::steady_clock::now();
+			long long workerTotal = 0;
+
+			while (true)
+			{
+				int item = -1;
+
+				{
+					std::lock_guard<std::mutex> lock(queues[thread].mutex);
+
+					if (!queues[thread].items.empty())
+					{
+						item = queues[thread].items.front();
+						queues[thread].items.pop_front();
+					}
+				}
+
+				for (int other = 1; other < numThreads && item == -1; other++)
+				{
+					ThreadQueue& victim = queues[(thread + other) % numThreads];
+					std::lock_guard<std::mutex> lock(victim.mutex);
+
+					if (!victim.items.empty())
+					{
+						item = victim.items.back();
+						victim.items.pop_back();
+
+						numSteals++;
+					}
+				}
+
+				//Nothing is added, so once every queue is empty it's done
+				if (item == -1)
+					break;
+
+				workerTotal += work(item);
+			}
+
+			busySeconds[thread] = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+			total += workerTotal;
+		};
+
+		std::vector<std::thread> threads;
+
+		for (int i = 1; i < numThreads; i++)
+		{
+			threads.emplace_back([&, i]()
+			{
+				PROFILE_THREAD("Render worker");
+				worker(i);
+			});
+		}
+
+		worker(0);
+
+		for (std::thread& thread : threads)
+			thread.join();
+
+		if (stats != nullptr)
+		{
+			stats->numThreads = numThreads;
+			stats->maxBusySeconds = *std::max_element(busySeconds.begin(), busySeconds.end());
+			stats->meanBusySeconds = std::accumulate(busySeconds.begin(), busySeconds.end(), 0.0) / (double)numThreads;
+			stats->numSteals = numSteals;
+		}
+
+		return total;
+	}
+
+	CPUFractalView GetCPUFractalView(const FractalParameters& parameters, int width, int height, bool flipX, bool flipY)
+	{
+		//Same mapping as GetRectToFractalPosition, fractal fits the height
+		double zoom = (double)parameters.zoom;
+		double widthStretch = (double)height / (double)width;
+
+		double signX = flipX ? -1.0 : 1.0;
+		double signY = flipY ? 1.0 : -1.0;
+
+		CPUFractalView view;
+
+		view.originX = signX * (0.5 / width + parameters.normalizedCenterOffset.x) / (widthStretch * zoom) + parameters.position.x;
+		view.originY = signY * (0.5 / height + parameters.normalizedCenterOffset.y) / zoom + parameters.position.y;
+
+		view.stepX = signX / (height * zoom);
+		view.stepY = signY / (height * zoom);
+
+		return view;
+	}
+
+	long long RenderFractalRectCPU(const FractalParameters& parameters, const CPUFractalView& view, Color* pixels, int rowStride, int x, int y, int width, int height)
+	{
+		if (parameters.fastMath && FractalSupportsFastMath(parameters.type))
+			return RenderRectForType<float, true>(parameters, view, pixels, rowStride, x, y, width, height);
+
+		return RenderRectForType<float, false>(parameters, view, pixels, rowStride, x, y, width, height);
+	}
+
+	const char* GetCPUFractalPrecisionName(CPUFractalPrecision precision)
+	{
+		switch (precision)
+		{
+			case CPU_FRACTAL_FLOAT:
+				return "float";
+			case CPU_FRACTAL_DOUBLE:
+				return "double";
+			default:
+				return "unknown";
+		}
+	}
+
+	bool CPUFractalUsesLanes(const FractalParameters& parameters)
+	{
+		bool escapeTime = parameters.type == FRACTAL_MULTIBROT || parameters.type == FRACTAL_MULTICORN || parameters.type == FRACTAL_BURNING_SHIP || parameters.type == FRACTAL_JULIA;
+		bool integerPower = std::fmod(parameters.power, 1.0f) == 0.0f && parameters.power > 0.0f;
+
+		return parameters.fastMath && FractalSupportsFastMath(parameters.type) && escapeTime && !integerPower;
+	}
+
+	//Distance between the rectangle's pixels in steps (ulps) of a floating point type with the given epsilon, at the largest value its positions are iterated to
+	double GetCPUFractalRectPixelUlps(const CPUFractalView& view, int x, int y, int width, int height, double epsilon)
+	{
+		//Iterated values get as large as the escape radius of 2 even if the positions are smaller
+		double largest = 2.0;
+
+		largest = std::max(largest, std::abs(view.originX + (double)x * view.stepX));
+		largest = std::max(largest, std::abs(view.originX + (double)(x + width - 1) * view.stepX));
+		largest = std::max(largest, std::abs(view.originY + (double)y * view.stepY));
+		largest = std::max(largest, std::abs(view.originY + (double)(y + height - 1) * view.stepY));
+
+		double step = std::min(std::abs(view.stepX), std::abs(view.stepY));
+
+		return step / (largest * epsilon);
+	}
+
+	CPUFractalPrecision GetCPUFractalRectPrecision(const CPUFractalView& view, int x, int y, int width, int height)
+	{
+		if (GetCPUFractalRectPixelUlps(view, x, y, width, height, (double)std::numeric_limits<float>::epsilon()) >= CPU_FRACTAL_MIN_PIXEL_ULPS)
+			return CPU_FRACTAL_FLOAT;
+
+		return CPU_FRACTAL_DOUBLE;
+	}
+
+	bool IsCPUFractalRectResolvable(const CPUFractalView& view, int x, int y, int width, int height)
+	{
+		return GetCPUFractalRectPixelUlps(view, x, y, width, height, std::numeric_limits<double>::epsilon()) >= CPU_FRACTAL_MIN_PIXEL_ULPS;
+	}
+
+	long long RenderFractalRectCPUDeep(const FractalParameters& parameters, const CPUFractalView& view, Color* pixels, int rowStride, int x, int y, int width, int height)
+	{
+		if (GetCPUFractalRectPrecision(view, x, y, width, height) == CPU_FRACTAL_FLOAT)
+			return RenderFractalRectCPU(parameters, view, pixels, rowStride, x, y, width, height);
+
+		return RenderFractalRectCPUVariant(parameters, view, CPU_FRACTAL_DOUBLE, 1, pixels, rowStride, x, y, width, height);
+	}
+
+	long long RenderFractalRectCPUVariant(const FractalParameters& parameters, const CPUFractalView& view, CPUFractalPrecision precision, int laneWidth,
+		Color* pixels, int rowStride, int x, int y, int width, int height)
+	{
+		bool fastMath = parameters.fastMath && FractalSupportsFastMath(parameters.type);
+
+		if (precision == CPU_FRACTAL_DOUBLE)
+		{
+			if (fastMath)
+				return RenderRectForType<double, true>(parameters, view, pixels, rowStride, x, y, width, height);
+
+			return RenderRectForType<double, false>(parameters, view, pixels, rowStride, x, y, width, height);
+		}
+
+		if (!fastMath)
+			return RenderRectForType<float, false>(parameters, view, pixels, rowStride, x, y, width, height);
+
+		switch (laneWidth)
+		{
+			case 1:
+				return RenderRectForType<float, true, 1>(parameters, view, pixels, rowStride, x, y, width, height);
+			case 4:
+				return RenderRectForType<float, true, 4>(parameters, view, pixels, rowStride, x, y, width, height);
+			case 16:
+				return RenderRectForType<float, true, 16>(parameters, view, pixels, rowStride, x, y, width, height);
+			default: //Or CPU_FRACTAL_LANES
+				return RenderRectForType<float, true>(parameters, view, pixels, rowStride, x, y, width, height);
+		}
+	}
+
+	long long RenderFractalPointsCPU(const FractalParameters& parameters, const double* pointsX, const double* pointsY, Color* pixels, int numPoints)
+	{
+		if (parameters.fastMath && FractalSupportsFastMath(parameters.type))
+			return RenderPointsForType<float, true>(parameters, pointsX, pointsY, pixels, numPoints);
+
+		return RenderPointsForType<float, false>(parameters, pointsX, pointsY, pixels, numPoints);
+	}
+
+	long long RenderFractalCPU(const FractalParameters& parameters, const CPUFractalView& view, Color* pixels, int width, int height)
+	{
+		CPUFractalSymmetry symmetries[NUM_MAX_CPU_FRACTAL_SYMMETRIES];
+		int numSymmetries = GetCPUFractalSymmetries(parameters, view, symmetries);
+
+		//Iterate the runs of pixels that aren't copied
+		long long totalIterations = RunOnAllThreads(height, [&](int row)
+		{
+			long long iterations = 0;
+			int runStart = 0;
+
+			for (int column = 0; column <= width; column++)
+			{
+				int sourceX;
+				int sourceY;
+
+				if (column < width && GetSymmetrySource(symmetries, numSymmetries, column, row, width, height, sourceX, sourceY) == -1)
+					continue;
+
+				if (column > runStart)
+					iterations += RenderFractalRectCPU(parameters, view, pixels, width, runStart, row, column - runStart, 1);
+
+				runStart = column + 1;
+			}
+
+			return iterations;
+		});
+
+		if (numSymmetries == 0)
+			return totalIterations;
+
+		//Then copy the rest, all of their sources are done
+		int numRoots = GetFractalNumRoots(parameters.type);
+
+		Color rootColors[NUM_MAX_ROOTS];
+
+		for (int i = 0; i < numRoots; i++)
+			rootColors[i] = GetHueColor((float)i * (360.0f / (float)numRoots));
+
+		RunOnAllThreads(height, [&](int row)
+		{
+			for (int column = 0; column < width; column++)
+			{
+				int sourceX;
+				int sourceY;
+				int symmetry = GetSymmetrySource(symmetries, numSymmetries, column, row, width, height, sourceX, sourceY);
+
+				if (symmetry == -1)
+					continue;
+
+				Color color = pixels[(size_t)sourceY * (size_t)width + (size_t)sourceX];
+
+				//the source converged to the mapped root of this pixel's root
+				for (int i = 0; i < numRoots; i++)
+				{
+					Color mappedRootColor = rootColors[symmetries[symmetry].mappedRoots[i]];
+
+					if (color.r == mappedRootColor.r && color.g == mappedRootColor.g && color.b == mappedRootColor.b)
+					{
+						color = rootColors[i];
+						break;
+					}
+				}
+
+				pixels[(size_t)row * (size_t)width + (size_t)column] = color;
+			}
+
+			return 0ll;
+		});
+
+		return totalIterations;
+	}
+
+	Image GenImageFractalCPU(const FractalParameters& parameters, int width, int height, bool flipX, bool flipY)
+	{
+		Image fractalImage = GenImageColor(width, height, BLACK);
+
+		CPUFractalView view = GetCPUFractalView(parameters, width, height, flipX, flipY);
+		RenderFractalCPU(parameters, view, (Color*)fractalImage.data, width, height);
+
+		return fractalImage;
+	}
+	#pragma endregion
+}
@@ -0,0 +1,79 @@
+#include "DynamicResolution.h"
+
+#include <cmath>
+#include <algorithm>
+
+namespace Explorer
+{
+	void DynamicResolution::Reset(float newFrameTimeBudget)
+	{
+		frameTimeBudget = newFrameTimeBudget;
+		scale = DYNAMIC_RESOLUTION_MAX_SCALE;
+
+		intervalTime = 0.0f;
+		intervalFrames = 0;
+
+		averageFrameTime = 0.0f;
+
+		scaledUp = false;
+		holdIntervals = 0;
+	}
+
+	void DynamicResolution::Update(float frameTime)
+	{
+		intervalTime += frameTime;
+		intervalFrames++;
+
+		if (intervalTime < DYNAMIC_RESOLUTION_INTERVAL)
+			return;
+
+		averageFrameTime = intervalTime / (float)intervalFrames;
+
+		intervalTime = 0.0f;
+		intervalFrames = 0;
+
+		bool missed = averageFrameTime > frameTimeBudget * DYNAMIC_RESOLUTION_MISSED_RATIO;
+		bool met = averageFrameTime <= frameTimeBudget * DYNAMIC_RESOLUTION_MET_RATIO;
+
+		if (missed && scaledUp)
+		{
+			//Just past what fits: with vsync a frame slightly over the budget takes two refresh intervals,
+			//which would make the step below drop much further than needed
+			scale /= DYNAMIC_RESOLUTION_SCALE_UP;
+			holdIntervals = DYNAMIC_RESOLUTION_HOLD_INTERVALS;
+		}
+		else if (missed)
+		{
+			//The fractal's cost goes with its pixel count, the square of the scale, so this about fits the budget at once
+			//(less so if part of the frame time isn't the fractal's, which the next intervals take care of)
+			scale *= std::max(std::sqrt(frameTimeBudget / averageFrameTime), 0.5f);
+		}
+		else if (met && holdIntervals > 0)
+		{
+			holdIntervals--;
+		}
+		else if (met)
+		{
+			scale *= DYNAMIC_RESOLUTION_SCALE_UP;
+		}
+
+		scaledUp = met && !missed && holdIntervals == 0;
+
+		scale = std::clamp(scale, DYNAMIC_RESOLUTION_MIN_SCALE, DYNAMIC_RESOLUTION_MAX_SCALE);
+	}
+
+	float DynamicResolution::GetScale() const
+	{
+		return scale;
+	}
+
+	float DynamicResolution::GetFrameTimeBudget() const
+	{
+		return frameTimeBudget;
+	}
+
+	float DynamicResolution::GetAverageFrameTime() const
+	{
+		return averageFrameTime;
+	}
+}
@@ -0,0 +1,171 @@
+#include "ExponentialMap.h"
+
+#include <cmath>
+#include <algorithm>
+
+#include "raylib.h"
+
+#include "CPUFractal.h"
+
+namespace Explorer
+{
+	bool FractalSupportsExponentialMap(FractalType type)
+	{
+		return type == FRACTAL_MULTIBROT || type == FRACTAL_MULTICORN || type == FRACTAL_BURNING_SHIP || type == FRACTAL_JULIA;
+	}
+
+	long long ExponentialMap::Render(const FractalParameters& parameters, float endZoom, int width, int height, bool flipY)
+	{
+		this->parameters = parameters;
+		this->width = width;
+		this->height = height;
+
+		samples.clear();
+		pixelColumns.assign((size_t)width * (size_t)height, 0.0f);
+		pixelRows.assign((size_t)width * (size_t)height, 0.0f);
+
+		if (!FractalSupportsExponentialMap(parameters.type) || width <= 0 || height <= 0 || parameters.zoom <= 0.0f || endZoom <= 0.0f)
+			return 0;
+
+		double positionX = (double)parameters.position.x;
+		double positionY = (double)parameters.position.y;
+
+		//The frame at zoom 1, where every pixel is from the position
+		FractalParameters unitParameters = parameters;
+		unitParameters.zoom = 1.0f;
+
+		CPUFractalView unitView = GetCPUFractalView(unitParameters, width, height, false, flipY);
+
+		//Half a pixel, pixels closer to the position than that all get the strip's first row
+		double minUnitRadius = 0.5 * std::abs(unitView.stepY);
+		double maxUnitRadius = minUnitRadius;
+
+		std::vector<double> pixelLogRadii((size_t)width * (size_t)height);
+
+		for (int y = 0; y < height; y++)
+		{
+			for (int x = 0; x < width; x++)
+			{
+				double offsetX = unitView.originX + (double)x * unitView.stepX - positionX;
+				double offsetY = unitView.originY + (double)y * unitView.stepY - positionY;
+
+				double radius = std::max(std::sqrt(offsetX * offsetX + offsetY * offsetY), minUnitRadius);
+				maxUnitRadius = std::max(maxUnitRadius, radius);
+
+				double angle = std::atan2(offsetY, offsetX);
+
+				if (angle < 0.0)
+					angle += 2.0 * (double)PI;
+
+				pixelColumns[(size_t)y * (size_t)width + (size_t)x] = (float)angle;
+				pixelLogRadii[(size_t)y * (size_t)width + (size_t)x] = std::log(radius);
+			}
+		}
+
+		//Square samples as small as the pixels at the frame's corners, the farthest from the position
+		numAngles = std::max((int)std::ceil(2.0 * (double)PI * maxUnitRadius / std::abs(unitView.stepY)), 8);
+		logRadiusStep = 2.0 * (double)PI / (double)numAngles;
+
+		//From the closest pixel zoomed in the most to the farthest zoomed out the most
+		double maxZoom = std::max((double)parameters.zoom, (double)endZoom);
+		double minZoom = std::min((double)parameters.zoom, (double)endZoom);
+
+		minLogRadius = std::log(minUnitRadius) - std::log(maxZoom);
+		double maxLogRadius = std::log(maxUnitRadius) - std::log(minZoom);
+
+		numRadii = (int)std::ceil((maxLogRadius - minLogRadius) / logRadiusStep) + 2;
+
+		for (size_t i = 0; i < pixelColumns.size(); i++)
+		{
+			pixelColumns[i] = (float)((double)pixelColumns[i] / (2.0 * (double)PI) * (double)numAngles);
+			pixelRows[i] = (float)((pixelLogRadii[i] - minLogRadius) / logRadiusStep);
+		}
+
+		samples.resize((size_t)numAngles * (size_t)numRadii);
+
+		//A row is a circle around the position
+		std::vector<double> cosines(numAngles);
+		std::vector<double> sines(numAngles);
+
+		for (int column = 0; column < numAngles; column++)
+		{
+			double angle = 2.0 * (double)PI * (double)column / (double)numAngles;
+
+			cosines[column] = std::cos(angle);
+			sines[column] = std::sin(angle);
+		}
+
+		return RunOnAllThreads(numRadii, [&](int row)
+		{
+			double radius = std::exp(minLogRadius + (double)row * logRadiusStep);
+
+			std::vector<double> pointsX(numAngles);
+			std::vector<double> pointsY(numAngles);
+
+			for (int column = 0; column < numAngles; column++)
+			{
+				pointsX[column] = positionX + radius * cosines[column];
+				pointsY[column] = positionY + radius * sines[column];
+			}
+
+			return RenderFractalPointsCPU(parameters, pointsX.data(), pointsY.data(), samples.data() + (size_t)row * (size_t)numAngles, numAngles);
+		});
+	}
+
+	void ExponentialMap::ResampleFrame(float zoom, Color* pixels) const
+	{
+		if (samples.empty())
+		{
+			std::fill(pixels, pixels + (size_t)width * (size_t)height, BLACK);
+			return;
+		}
+
+		//Zooming in moves every pixel the same number of rows towards the center
+		float rowOffset = (float)(std::log((double)zoom) / logRadiusStep);
+
+		for (int y = 0; y < height; y++)
+		{
+			for (int x = 0; x < width; x++)
+			{
+				size_t pixel = (size_t)y * (size_t)width + (size_t)x;
+
+				//Bilinear, the columns wrap around
+				float column = pixelColumns[pixel];
+				float row = std::clamp(pixelRows[pixel] - rowOffset, 0.0f, (float)(numRadii - 1));
+
+				int column0 = std::min((int)column, numAngles - 1);
+				int column1 = (column0 + 1) % numAngles;
+				int row0 = std::min((int)row, numRadii - 2);
+				int row1 = row0 + 1;
+
+				float columnAmount = column - (float)column0;
+				float rowAmount = row - (float)row0;
+
+				const Color& sample00 = samples[(size_t)row0 * (size_t)numAngles + (size_t)column0];
+				const Color& sample01 = samples[(size_t)row0 * (size_t)numAngles + (size_t)column1];
+				const Color& sample10 = samples[(size_t)row1 * (size_t)numAngles + (size_t)column0];
+				const Color& sample11 = samples[(size_t)row1 * (size_t)numAngles + (size_t)column1];
+
+				auto blend = [&](unsigned char value00, unsigned char value01, unsigned char value10, unsigned char value11)
+				{
+					float value0 = (float)value00 + ((float)value01 - (float)value00) * columnAmount;
+					float value1 = (float)value10 + ((float)value11 - (float)value10) * columnAmount;
+
+					return (unsigned char)(value0 + (value1 - value0) * rowAmount + 0.5f);
+				};
+
+				pixels[pixel] = Color{ blend(sample00.r, sample01.r, sample10.r, sample11.r), blend(sample00.g, sample01.g, sample10.g, sample11.g), blend(sample00.b, sample01.b, sample10.b, sample11.b), 255 };
+			}
+		}
+	}
+
+	int ExponentialMap::GetNumAngles() const
+	{
+		return numAngles;
+	}
+
+	int ExponentialMap::GetNumRadii() const
+	{
+		return numRadii;
+	}
+}
@@ -2,8 +2,10 @@
 
 #include <iostream>
 #include <cmath>
+#include <mutex>
 #include <string>
 #include <vector>
+#include <cstring>
 #include <filesystem>
 
 #ifdef PLATFORM_WEB
@@ -12,9 +14,24 @@
 
 #include "raylib.h"
 #include "raymath.h"
+#include "rlgl.h"
 
 #include "Resources.h"
 #include "Fractal.h"
+#include "CPUFractal.h"
+#include "Buddhabrot.h"
+#include "InverseIteration.h"
+#include "ScreenshotExporter.h"
+#include "Readback.h"
+#include "PosterExporter.h"
+#include "Animation.h"
+#include "TileTree.h"
+#include "JuliaAtlas.h"
+#include "DynamicResolution.h"
+#include "RenderJobs.h"
+#include "RenderStats.h"
+#include "GPUTimer.h"
+#include "Profiler.h"
 #include "ComplexNumbers/ComplexFloat.h"
 #include "ComplexNumbers/ComplexPolynomial.h"
 #include "UI/UIUtils.h"
@@ -28,6 +45,127 @@ namespace Explorer
 	FractalParameters fractalParameters = FractalParameters();
 	ShaderFractal shaderFractal;
 
+	//Multi-pass rendering
+
+	//iterations per pass stays below the web version's hard-coded shader limit (300)
+	const int MULTI_PASS_ITERATIONS_PER_PASS = 100;
+	const int MULTI_PASS_PASSES_PER_FRAME = 4;
+
+	bool multiPass = false;
+
+	//Interaction level of detail: while a dot or the camera is moved, the shader fractal is drawn at a lower resolution & iteration count,
+	//and at full quality again once the input has stopped for INTERACTION_REFINE_DELAY seconds
+
+	const float INTERACTION_RESOLUTION_SCALE = 0.5f;
+	const float INTERACTION_ITERATION_SCALE = 0.25f;
+	const int INTERACTION_MIN_ITERATIONS = 64;
+	const float INTERACTION_REFINE_DELAY = 0.2f;
+
+	float interactionIdleTime = INTERACTION_REFINE_DELAY;
+	bool interactionLOD = false;
+
+	//Dynamic resolution of the single pass shader, D cycles through the frame time budgets (0 fps: the monitor's refresh rate) & off
+
+	const int NUM_DYNAMIC_RESOLUTION_TARGETS = 3;
+	const int DYNAMIC_RESOLUTION_TARGET_FPS[NUM_DYNAMIC_RESOLUTION_TARGETS] = { 0, 60, 30 };
+
+	//-1: off
+	int dynamicResolutionTarget = -1;
+	DynamicResolution dynamicResolution;
+
+	//CPU rendering
+
+	bool cpuRendering = false;
+
+	Image cpuFractalImage = { 0 };
+	Texture2D cpuFractalTexture = { 0 };
+
+	//what the cpu fractal image was rendered with, it's only rendered again if these change
+	FractalParameters cpuFractalParameters = FractalParameters();
+	bool cpuFractalFlipY = false;
+
+	//escape time fractals are drawn from cached tiles instead of the image, rendered by a render job
+	//web has no job thread, the jobs render for this long every frame there
+	const float CPU_FRACTAL_JOB_FRAME_TIME = 0.03f;
+
+	FractalTileTree cpuFractalTileTree;
+
+	//Inverse iteration (julia sets only), rendered into the cpu fractal image by a render job,
+	//the last completed image is shown until the next one is done
+
+	//visits per pixel before the preimage tree is cut there
+	const int INVERSE_ITERATION_VISIT_CAP = 4;
+
+	bool inverseIteration = false;
+	long long inverseIterationPoints = 0;
+
+	//Guards the completed image, handed over by the job thread
+	std::mutex inverseIterationMutex;
+	std::vector<Color> inverseIterationPixels;
+	int inverseIterationWidth = 0;
+	long long inverseIterationCompletedPoints = 0;
+
+	//After what it uses, so it's stopped first
+	RenderJobQueue inverseIterationJobs;
+
+	//Buddhabrot
+
+	//time spent tracing orbits per frame, samples per frame adapts to it
+	const float BUDDHABROT_FRAME_TIME = 0.02f;
+
+	bool buddhabrotRendering = false;
+
+	Buddhabrot buddhabrot;
+	bool buddhabrotFlipY = false;
+	long long buddhabrotSamplesPerFrame = 10000;
+
+	Image buddhabrotImage = { 0 };
+	Texture2D buddhabrotTexture = { 0 };
+
+	//Julia atlas, shown instead of the julia set to pick c from
+
+	bool juliaAtlasOpen = false;
+	JuliaAtlas juliaAtlas;
+
+	//Screenshots
+
+	//readbacks of shader screenshots still in flight, handed to the screenshot thread once they're done
+	std::vector<int> screenshotReadbacks;
+
+	//poster export progress shown in the last notification, in percent
+	int posterProgressShown = -1;
+
+	//Animation keyframes, rendered with the fractal_animation tool
+
+	//seconds between keyframes added with A
+	const double ANIMATION_KEYFRAME_SECONDS = 5.0;
+
+	std::string animationFileName = "";
+	int animationNumKeyframes = 0;
+
+	//Render stats, measured while the debug overlay is shown (space) or logged to a JSON lines file (shift + space)
+
+	//of the last frame whose renderer rendered something
+	FractalRenderStats renderStats = FractalRenderStats{ 0.0, -1.0, 0, -1, 0, 0, 0, false };
+	const char* renderStatsRenderer = "";
+
+	//the renderer shown is measured (the buddhabrot, inverse iteration & the julia atlas aren't)
+	bool renderStatsMeasured = false;
+
+	//decided once per frame by Update, so the frame's draw ends the gpu timer its update began even if measuring is toggled in between
+	bool renderStatsFrameMeasured = false;
+	bool renderStatsGPUTimerStarted = false;
+
+	//cpu time of this frame's renderer update
+	double renderStatsUpdateSeconds = 0.0;
+	long long renderStatsFrame = 0;
+
+	RenderStatsLog renderStatsLog;
+	FractalRenderStatsSampler renderStatsSampler;
+
+	//Profiling (built with EXPLORER_PROFILER), traces written by z are numbered from 1
+	int profileTraceNumber = 0;
+
 	//Delta times
 
 	float zoomDeltaTime = 0.0f;
@@ -69,7 +207,52 @@ namespace Explorer
 	void UpdateFractalControls();
 	void UpdateFractalCamera();
 
+	void ToggleMultiPass();
+	void ToggleFastMath();
+
+	void UpdateInteractionLOD();
+
+	void CycleDynamicResolution();
+	void UpdateDynamicResolution();
+
+	//The shader fractal is drawn, single or multi-pass
+	bool IsShaderFractalShown();
+
+	//The single pass shader is drawn (at a resolution scale, see DrawScaled)
+	bool IsSinglePassShaderShown();
+	float GetShaderResolutionScale();
+
+	void ToggleCPURendering();
+	void UpdateCPUFractal();
+	void UnloadCPUFractal();
+
+	void ToggleInverseIteration();
+	bool IsInverseIterationShown();
+
+	void ToggleBuddhabrot();
+	bool IsBuddhabrotShown();
+	void UpdateBuddhabrot();
+	void UnloadBuddhabrot();
+
+	void ToggleJuliaAtlas();
+	bool IsJuliaAtlasShown();
+
 	void TakeFractalScreenshot();
+	void UpdateScreenshotReadbacks();
+
+	void ToggleFractalPoster();
+	void UpdateFractalPoster();
+
+	void AddFractalKeyframe(bool newAnimation);
+
+	bool IsRenderStatsMeasured();
+	void ToggleRenderStatsLog();
+
+	//Once the fractal is drawn, drawSeconds: the cpu time drawing it took
+	void UpdateRenderStats(double drawSeconds);
+
+	//Writes the profiler's zones to Fractal_Screenshots/trace-N.json
+	void WriteProfilerTrace();
 	#pragma endregion
 
 	#pragma region UI functions
@@ -91,12 +274,18 @@ namespace Explorer
 
 	void DrawInfoPanel();
 
+	//Render stats, in the top right corner
+	void DrawDebugInfo();
+
 	void DrawStatInfo(const char* text, Vector2 position, Vector2 textPadding, float fontSize, Color textColor, Color backgroundColor);
 
 	void DrawDraggableDot(Vector2 position, float radius, Color fillColor, Color outlineColor, bool isHovered, bool isDown);
 
 	void UpdateDrawDraggableDots();
 
+	//Highlights the cell under the cursor, clicking it picks its c & closes the atlas
+	void UpdateDrawJuliaAtlas();
+
 	void UpdateDrawNotification();
 
 	void UpdateDrawWarning();
@@ -107,6 +296,8 @@ namespace Explorer
 
 	void Init()
 	{
+		PROFILE_THREAD("Main");
+
 		int screenWidth = GetScreenWidth();
 		int screenHeight = GetScreenHeight();
 
@@ -127,34 +318,140 @@ namespace Explorer
 	{
 		UnloadFractalRenderTexture();
 		shaderFractal.Unload();
+
+		UnloadCPUFractal();
+		UnloadBuddhabrot();
+		juliaAtlas.Unload();
+
+		inverseIterationJobs.Stop();
+
+		renderStatsLog.Close();
+		renderStatsSampler.Unload();
+		UnloadGPUTimer();
+
+#ifndef PLATFORM_WEB
+		//Screenshots still being read back are written too
+		for (int readback : screenshotReadbacks)
+			QueueFractalScreenshot(WaitReadback(readback));
+
+		screenshotReadbacks.clear();
+
+		UnloadScreenshotExporter();
+		UnloadPosterExporter();
+#endif
+
+		UnloadReadback();
 	}
 
 	void UpdateDrawFrame()
 	{
+		PROFILE_ZONE("Frame");
+
 		Update();
 
 		BeginDrawing();
 		{
+			PROFILE_ZONE("Draw");
+
 			ClearBackground(BLACK);
 
-			shaderFractal.Draw(Rectangle{ 0.0f, 0.0f, (float)GetScreenWidth(), (float)GetScreenHeight()}, false, flipYAxis);
+			double drawStartTime = GetTime();
+
+			if (IsJuliaAtlasShown())
+				juliaAtlas.Draw();
+			else if (IsBuddhabrotShown())
+				DrawTexturePro(buddhabrotTexture, Rectangle{ 0.0f, 0.0f, (float)buddhabrotTexture.width, (float)buddhabrotTexture.height }, Rectangle{ 0.0f, 0.0f, (float)GetScreenWidth(), (float)GetScreenHeight() }, { 0.0f, 0.0f }, 0.0f, WHITE);
+			else if (cpuRendering && !IsInverseIterationShown())
+				cpuFractalTileTree.Draw(fractalParameters, GetFractalRenderTextureWidth(), GetFractalRenderTextureHeight(), flipYAxis);
+			else if (IsInverseIterationShown())
+				DrawTexturePro(cpuFractalTexture, Rectangle{ 0.0f, 0.0f, (float)cpuFractalTexture.width, (float)cpuFractalTexture.height }, Rectangle{ 0.0f, 0.0f, (float)GetScreenWidth(), (float)GetScreenHeight() }, { 0.0f, 0.0f }, 0.0f, WHITE);
+			else
+				shaderFractal.DrawScaled(Rectangle{ 0.0f, 0.0f, (float)GetScreenWidth(), (float)GetScreenHeight()}, GetShaderResolutionScale(), false, flipYAxis);
+
+			if (renderStatsFrameMeasured)
+			{
+				//The fractal's draws are batched, they're drawn now so they're timed
+				rlDrawRenderBatchActive();
+
+				if (renderStatsGPUTimerStarted)
+					EndGPUTimer();
+
+				renderStatsGPUTimerStarted = false;
+
+				UpdateRenderStats(GetTime() - drawStartTime);
+			}
+
 			UpdateDrawUI();
 		}
+
+		//Swaps buffers, waits for vsync & polls input
+		PROFILE_ZONE("End drawing");
 		EndDrawing();
 	}
 
 	void Update()
 	{
+		PROFILE_ZONE("Update");
+
+		renderStatsFrameMeasured = false;
+
 		if (!warningEnded)
 			return;
 
 		UpdateFractal();
+		UpdateInteractionLOD();
+		UpdateDynamicResolution();
+
+		//Timed until the fractal is drawn
+		double renderStartTime = GetTime();
+
+		renderStatsFrameMeasured = IsRenderStatsMeasured();
+		renderStatsGPUTimerStarted = renderStatsFrameMeasured && IsShaderFractalShown();
+
+		if (renderStatsGPUTimerStarted)
+			BeginGPUTimer();
+
+		if (IsJuliaAtlasShown())
+			juliaAtlas.Update(fractalParameters, GetFractalRenderTextureWidth(), GetFractalRenderTextureHeight());
+		else if (IsBuddhabrotShown())
+			UpdateBuddhabrot();
+		else if (cpuRendering || IsInverseIterationShown())
+			UpdateCPUFractal();
+		else
+			shaderFractal.UpdateMultiPass(MULTI_PASS_ITERATIONS_PER_PASS, MULTI_PASS_PASSES_PER_FRAME);
+
+		renderStatsUpdateSeconds = GetTime() - renderStartTime;
 
 		if (IsKeyPressed(KEY_SPACE))
-			showDebugInfo = !showDebugInfo;
+		{
+			if (IsKeyDown(KEY_LEFT_SHIFT))
+				ToggleRenderStatsLog();
+			else
+				showDebugInfo = !showDebugInfo;
+		}
+
+		if (IsKeyPressed(KEY_Z))
+			WriteProfilerTrace();
 
 		if (IsKeyPressed(KEY_J))
 			TakeFractalScreenshot();
+
+		if (IsKeyPressed(KEY_P))
+			ToggleFractalPoster();
+
+		if (IsKeyPressed(KEY_A))
+			AddFractalKeyframe(IsKeyDown(KEY_LEFT_SHIFT));
+
+#ifndef PLATFORM_WEB
+		UpdateScreenshotReadbacks();
+		UpdateFractalPoster();
+
+		//Screenshots written by the screenshot thread
+		Notification screenshotNotification;
+
+		if (PollFractalScreenshotNotification(screenshotNotification))
+			notificationCurrent = screenshotNotification;
+#endif
 	}
 
 	#pragma region Fractal function implementations
@@ -164,6 +461,8 @@ namespace Explorer
 
 		shaderFractal.Unload();
 		shaderFractal = LoadShaderFractal(fractalType);
+		shaderFractal.SetMultiPass(multiPass);
+		shaderFractal.SetFastMath(fractalParameters.fastMath);
 
 		shaderFractal.SetNormalizedCenterOffset(fractalParameters.normalizedCenterOffset);
 		float widthStretch = GetWidthStretchForSize((float)GetScreenWidth(), (float)GetScreenHeight());
@@ -260,6 +559,8 @@ namespace Explorer
 
 	void UpdateFractal()
 	{
+		PROFILE_ZONE("Update fractal");
+
 		int screenWidth = GetScreenWidth();
 		int screenHeight = GetScreenHeight();
 
@@ -285,6 +586,27 @@ namespace Explorer
 		if (IsKeyPressed(KEY_T))
 			ChangeFractal((FractalType)(((int)fractalParameters.type + 1) % NUM_FRACTAL_TYPES));
 
+		if (IsKeyPressed(KEY_M))
+			ToggleMultiPass();
+
+		if (IsKeyPressed(KEY_X))
+			ToggleFastMath();
+
+		if (IsKeyPressed(KEY_D))
+			CycleDynamicResolution();
+
+		if (IsKeyPressed(KEY_C))
+			ToggleCPURendering();
+
+		if (IsKeyPressed(KEY_B))
+			ToggleBuddhabrot();
+
+		if (IsKeyPressed(KEY_N))
+			ToggleInverseIteration();
+
+		if (IsKeyPressed(KEY_U))
+			ToggleJuliaAtlas();
+
 		if (IsKeyPressed(KEY_E) && FractalSupportsColorBanding(fractalParameters.type))
 		{
 			fractalParameters.colorBanding = !fractalParameters.colorBanding;
@@ -298,6 +620,9 @@ namespace Explorer
 		
 			float widthStretch = GetWidthStretchForSize((float)screenWidth, (float)screenHeight);
 			shaderFractal.SetWidthStretch(widthStretch);
+
+			//New state textures hold no passes yet (& may have failed to load)
+			shaderFractal.SetMultiPass(multiPass);
 		}
 
 		UpdateFractalControls();
@@ -318,11 +643,11 @@ namespace Explorer
 			fractalParameters.maxIterations++;
 
 #ifdef PLATFORM_WEB
-			//Limit max iterations to 300 on web
-			if (fractalParameters.maxIterations > 300)
+			//Limit max iterations to 300 on web, unless iterations are spread over multiple passes
+			if (fractalParameters.maxIterations > 300 && !multiPass)
 			{
 				fractalParameters.maxIterations = 300;
-				notificationCurrent = Notification{ "Reached iteration limit on web version, use the desktop version to add more. (300)", 5.0f, WHITE };
+				notificationCurrent = Notification{ "Reached iteration limit on web version, use multi-pass rendering (M) or the desktop version to add more. (300)", 5.0f, WHITE };
 			}
 #endif
 			
@@ -357,6 +682,12 @@ namespace Explorer
 
 	void UpdateFractalCamera()
 	{
+		PROFILE_ZONE("Update camera");
+
+		//The atlas has a fixed view, clicks pick a cell
+		if (IsJuliaAtlasShown())
+			return;
+
 		float deltaTime = GetFrameTime();
 
 		//Camera panning using keys
@@ -433,9 +764,354 @@ namespace Explorer
 		}
 	}
 
+	void ToggleMultiPass()
+	{
+		if (!IsMultiPassSupported())
+		{
+			notificationCurrent = Notification{ "Multi-pass rendering is not supported on this device.", 5.0f, WHITE };
+			return;
+		}
+
+		multiPass = !multiPass;
+		shaderFractal.SetMultiPass(multiPass);
+
+#ifdef PLATFORM_WEB
+		//Single pass rendering is limited to 300 iterations on web
+		if (!multiPass && fractalParameters.maxIterations > 300)
+		{
+			fractalParameters.maxIterations = 300;
+			shaderFractal.SetMaxIterations(fractalParameters.maxIterations);
+		}
+#endif
+
+		notificationCurrent = Notification{ multiPass ? "Multi-pass rendering enabled" : "Multi-pass rendering disabled", 3.0f, WHITE };
+	}
+
+	void ToggleFastMath()
+	{
+		fractalParameters.fastMath = !fractalParameters.fastMath;
+		shaderFractal.SetFastMath(fractalParameters.fastMath);
+
+		if (!FractalSupportsFastMath(fractalParameters.type))
+			notificationCurrent = Notification{ fractalParameters.fastMath ? "Fast math enabled, this fractal doesn't use it." : "Fast math disabled", 3.0f, WHITE };
+		else
+			notificationCurrent = Notification{ fractalParameters.fastMath ? "Fast math enabled (approximate log, exp, atan & sin/cos)" : "Fast math disabled", 3.0f, WHITE };
+	}
+
+	void UpdateInteractionLOD()
+	{
+		bool cameraMoved = (IsMouseButtonDown(MOUSE_BUTTON_LEFT) && !activePressStartedOnUI && Vector2Length(GetMouseDelta()) != 0.0f) ||
+			IsKeyDown(KEY_LEFT) || IsKeyDown(KEY_RIGHT) || IsKeyDown(KEY_UP) || IsKeyDown(KEY_DOWN) || IsKeyDown(KEY_I) || IsKeyDown(KEY_O) ||
+			GetMouseWheelMove() != 0.0f || Vector2Length(GetGesturePinchVector()) != 0.0f;
+
+		if (isDraggingDot || cameraMoved)
+			interactionIdleTime = 0.0f;
+		else
+			interactionIdleTime += GetFrameTime();
+
+		bool lod = interactionIdleTime < INTERACTION_REFINE_DELAY && IsSinglePassShaderShown();
+
+		//Set every frame while it's on, so iteration changes mid drag stay reduced
+		if (lod)
+			shaderFractal.SetMaxIterations(std::min(fractalParameters.maxIterations, std::max((int)((float)fractalParameters.maxIterations * INTERACTION_ITERATION_SCALE), INTERACTION_MIN_ITERATIONS)));
+		else if (interactionLOD)
+			shaderFractal.SetMaxIterations(fractalParameters.maxIterations);
+
+		interactionLOD = lod;
+	}
+
+	void CycleDynamicResolution()
+	{
+		dynamicResolutionTarget = dynamicResolutionTarget + 1 < NUM_DYNAMIC_RESOLUTION_TARGETS ? dynamicResolutionTarget + 1 : -1;
+
+		if (dynamicResolutionTarget == -1)
+		{
+			notificationCurrent = Notification{ "Dynamic resolution disabled", 3.0f, WHITE };
+			return;
+		}
+
+		int fps = DYNAMIC_RESOLUTION_TARGET_FPS[dynamicResolutionTarget];
+
+		//Refresh rate is 0 when it's unknown (web)
+		if (fps == 0)
+			fps = GetMonitorRefreshRate(GetCurrentMonitor()) > 0 ? GetMonitorRefreshRate(GetCurrentMonitor()) : 60;
+
+		dynamicResolution.Reset(1.0f / (float)fps);
+
+		if (!IsSinglePassShaderShown())
+			notificationCurrent = Notification{ TextFormat("Dynamic resolution enabled (%i fps), only for single pass gpu rendering.", fps), 3.0f, WHITE };
+		else
+			notificationCurrent = Notification{ TextFormat("Dynamic resolution enabled, %i fps (%.1f ms per frame)", fps, 1000.0f / (float)fps), 3.0f, WHITE };
+	}
+
+	void UpdateDynamicResolution()
+	{
+		//Frames of the interaction preview are cheaper than the scale makes them
+		if (dynamicResolutionTarget == -1 || !IsSinglePassShaderShown() || interactionLOD)
+			return;
+
+		dynamicResolution.Update(GetFrameTime());
+	}
+
+	bool IsShaderFractalShown()
+	{
+		return !cpuRendering && !IsBuddhabrotShown() && !IsInverseIterationShown() && !IsJuliaAtlasShown();
+	}
+
+	bool IsSinglePassShaderShown()
+	{
+		//Multi-pass already spreads its iterations over frames, & the cpu renderers have previews of their own
+		return !shaderFractal.IsMultiPass() && !cpuRendering && !IsBuddhabrotShown() && !IsInverseIterationShown() && !IsJuliaAtlasShown();
+	}
+
+	float GetShaderResolutionScale()
+	{
+		float scale = dynamicResolutionTarget != -1 ? dynamicResolution.GetScale() : 1.0f;
+
+		if (interactionLOD)
+			scale *= INTERACTION_RESOLUTION_SCALE;
+
+		return scale;
+	}
+
+	void ToggleCPURendering()
+	{
+		cpuRendering = !cpuRendering;
+
+		if (!cpuRendering)
+			UnloadCPUFractal();
+
+		notificationCurrent = Notification{ cpuRendering ? "CPU rendering enabled" : "CPU rendering disabled", 3.0f, WHITE };
+	}
+
+	void UpdateCPUFractal()
+	{
+		PROFILE_ZONE("Update CPU fractal");
+
+		int width = GetFractalRenderTextureWidth();
+		int height = GetFractalRenderTextureHeight();
+
+		if (!IsInverseIterationShown())
+		{
+			//Where the user is looking: the cursor (zooming is around the center, so the center once it's off the window)
+			Vector2 focus = IsCursorOnScreen() ? GetMousePosition() : Vector2{ (float)width * 0.5f, (float)height * 0.5f };
+
+			cpuFractalTileTree.Update(fractalParameters, width, height, flipYAxis, focus, CPU_FRACTAL_JOB_FRAME_TIME);
+			return;
+		}
+
+		//Resize, or render again if something changed
+		bool changed = !AreFractalParametersEqual(cpuFractalParameters, fractalParameters) || cpuFractalFlipY != flipYAxis;
+
+		if (cpuFractalImage.width != width || cpuFractalImage.height != height)
+		{
+			UnloadCPUFractal();
+
+			cpuFractalImage = GenImageColor(width, height, BLACK);
+			cpuFractalTexture = LoadTextureFromImage(cpuFractalImage);
+
+			changed = true;
+		}
+
+		if (changed)
+		{
+			FractalParameters parameters = fractalParameters;
+			CPUFractalView view = GetCPUFractalView(fractalParameters, width, height, false, flipYAxis);
+
+			//The walk can't stop part way, a job replaced while it runs still hands its image over (it's still the latest completed one)
+			inverseIterationJobs.Publish([parameters, view, width, height](long long epoch)
+			{
+				std::vector<Color> pixels((size_t)width * (size_t)height);
+				long long points = RenderJuliaInverseIteration(parameters, view, pixels.data(), width, height, INVERSE_ITERATION_VISIT_CAP);
+
+				std::lock_guard<std::mutex> lock(inverseIterationMutex);
+
+				inverseIterationPixels = std::move(pixels);
+				inverseIterationWidth = width;
+				inverseIterationCompletedPoints = points;
+
+				return false;
+			});
+
+			cpuFractalParameters = fractalParameters;
+			cpuFractalFlipY = flipYAxis;
+		}
+
+		inverseIterationJobs.RunOnThisThread(CPU_FRACTAL_JOB_FRAME_TIME);
+
+		std::lock_guard<std::mutex> lock(inverseIterationMutex);
+
+		if (inverseIterationPixels.empty())
+			return;
+
+		//Images of an older size are dropped
+		if (inverseIterationWidth == width && inverseIterationPixels.size() == (size_t)width * (size_t)height)
+		{
+			std::memcpy(cpuFractalImage.data, inverseIterationPixels.data(), inverseIterationPixels.size() * sizeof(Color));
+			UpdateTexture(cpuFractalTexture, cpuFractalImage.data);
+
+			inverseIterationPoints = inverseIterationCompletedPoints;
+		}
+
+		inverseIterationPixels.clear();
+	}
+
+	void UnloadCPUFractal()
+	{
+		if (cpuFractalImage.data != NULL)
+			UnloadImage(cpuFractalImage);
+
+		if (cpuFractalTexture.id != 0)
+			UnloadTexture(cpuFractalTexture);
+
+		cpuFractalImage = Image{ 0 };
+		cpuFractalTexture = Texture2D{ 0 };
+
+		//Rendered again (at the new size) once it's shown
+		inverseIterationJobs.Cancel();
+		cpuFractalParameters = FractalParameters();
+
+		cpuFractalTileTree.Unload();
+	}
+
+	void ToggleInverseIteration()
+	{
+		inverseIteration = !inverseIteration;
+
+		if (inverseIteration && !FractalSupportsInverseIteration(fractalParameters))
+			notificationCurrent = Notification{ "Inverse iteration enabled, only for julia sets with whole powers of 2 & above.", 3.0f, WHITE };
+		else
+			notificationCurrent = Notification{ inverseIteration ? "Inverse iteration enabled" : "Inverse iteration disabled", 3.0f, WHITE };
+	}
+
+	bool IsInverseIterationShown()
+	{
+		return inverseIteration && !IsBuddhabrotShown() && FractalSupportsInverseIteration(fractalParameters);
+	}
+
+	void ToggleBuddhabrot()
+	{
+		buddhabrotRendering = !buddhabrotRendering;
+
+		if (!buddhabrotRendering)
+			UnloadBuddhabrot();
+
+		if (buddhabrotRendering && !FractalSupportsBuddhabrot(fractalParameters.type))
+			notificationCurrent = Notification{ "Buddhabrot enabled, only for the Multibrot, Multicorn & Burning Ship.", 3.0f, WHITE };
+		else
+			notificationCurrent = Notification{ buddhabrotRendering ? "Buddhabrot enabled" : "Buddhabrot disabled", 3.0f, WHITE };
+	}
+
+	bool IsBuddhabrotShown()
+	{
+		return buddhabrotRendering && FractalSupportsBuddhabrot(fractalParameters.type);
+	}
+
+	void UpdateBuddhabrot()
+	{
+		int width = GetFractalRenderTextureWidth();
+		int height = GetFractalRenderTextureHeight();
+
+		//Start over if the view changed
+		if (buddhabrotImage.width != width || buddhabrotImage.height != height)
+		{
+			UnloadBuddhabrot();
+
+			buddhabrotImage = GenImageColor(width, height, BLACK);
+			buddhabrotTexture = LoadTextureFromImage(buddhabrotImage);
+
+			buddhabrot.Reset(fractalParameters, width, height, flipYAxis);
+			buddhabrotFlipY = flipYAxis;
+		}
+		else if (!AreFractalParametersEqual(buddhabrot.GetParameters(), fractalParameters) || buddhabrotFlipY != flipYAxis)
+		{
+			buddhabrot.Reset(fractalParameters, width, height, flipYAxis);
+			buddhabrotFlipY = flipYAxis;
+		}
+
+		//Progressive: a few samples every frame, as many as fit in BUDDHABROT_FRAME_TIME
+		double startTime = GetTime();
+		buddhabrot.AddSamples(buddhabrotSamplesPerFrame);
+		double sampleTime = GetTime() - startTime;
+
+		if (sampleTime > 0.0)
+			buddhabrotSamplesPerFrame = (long long)Clamp((float)((double)buddhabrotSamplesPerFrame * (double)BUDDHABROT_FRAME_TIME / sampleTime), 1000.0f, 10000000.0f);
+
+		buddhabrot.UpdateImage(buddhabrotImage);
+		UpdateTexture(buddhabrotTexture, buddhabrotImage.data);
+	}
+
+	void UnloadBuddhabrot()
+	{
+		if (buddhabrotImage.data != NULL)
+			UnloadImage(buddhabrotImage);
+
+		if (buddhabrotTexture.id != 0)
+			UnloadTexture(buddhabrotTexture);
+
+		buddhabrotImage = Image{ 0 };
+		buddhabrotTexture = Texture2D{ 0 };
+
+		buddhabrot = Buddhabrot();
+	}
+
+	void ToggleJuliaAtlas()
+	{
+		juliaAtlasOpen = !juliaAtlasOpen;
+
+		if (!juliaAtlasOpen)
+			juliaAtlas.Unload();
+
+		if (juliaAtlasOpen && fractalParameters.type != FRACTAL_JULIA)
+			notificationCurrent = Notification{ "Julia atlas enabled, only for the Julia set.", 3.0f, WHITE };
+		else
+			notificationCurrent = Notification{ juliaAtlasOpen ? "Julia atlas: click a julia set to pick its c (U to close)" : "Julia atlas closed", 3.0f, WHITE };
+	}
+
+	bool IsJuliaAtlasShown()
+	{
+		return juliaAtlasOpen && fractalParameters.type == FRACTAL_JULIA;
+	}
+
 	void TakeFractalScreenshot()
 	{
-		Image fractalImage = shaderFractal.GenImage(false, flipYAxis);
+		//Full quality, even mid drag
+		if (interactionLOD)
+		{
+			shaderFractal.SetMaxIterations(fractalParameters.maxIterations);
+			interactionLOD = false;
+		}
+
+		//Finish the remaining passes, so the screenshot contains every iteration
+		while (shaderFractal.IsMultiPass() && !shaderFractal.IsMultiPassComplete())
+			shaderFractal.UpdateMultiPass(MULTI_PASS_ITERATIONS_PER_PASS, MULTI_PASS_PASSES_PER_FRAME);
+
+		Image fractalImage = { 0 };
+
+		if (IsBuddhabrotShown())
+			fractalImage = ImageCopy(buddhabrotImage);
+		else if (IsInverseIterationShown())
+			fractalImage = ImageCopy(cpuFractalImage);
+		else if (cpuRendering)
+			fractalImage = GenImageFractalCPU(fractalParameters, GetFractalRenderTextureWidth(), GetFractalRenderTextureHeight(), false, flipYAxis);
+#ifndef PLATFORM_WEB
+		else if (IsReadbackAsync())
+		{
+			//Read back without waiting for the gpu, UpdateScreenshotReadbacks queues it a frame or two later
+			int readback = shaderFractal.QueueImage(false, flipYAxis);
+
+			if (readback != -1)
+			{
+				screenshotReadbacks.push_back(readback);
+				screenshotDeltaTime = -GetFrameTime();
+				return;
+			}
+
+			fractalImage = shaderFractal.GenImage(false, flipYAxis);
+		}
+#endif
+		else
+			fractalImage = shaderFractal.GenImage(false, flipYAxis);
 
 		try
 		{
@@ -451,60 +1127,252 @@ namespace Explorer
 
 			notificationCurrent = Notification{ "Exported fractal screenshot!", 5.0f, WHITE };
 #else //DESKTOP
-			//Fractal_Screenshots directory
-			std::filesystem::path fractalScreenshotsPath = std::filesystem::absolute(GetWorkingDirectory()).append("Fractal_Screenshots").make_preferred();
+			//Encoding & writing the file happens on the screenshot thread, which also takes care of unloading fractalImage
+			if (!QueueFractalScreenshot(fractalImage))
+				throw std::runtime_error("Too many screenshots are still being exported, try again in a moment");
+#endif
+		}
+		catch(std::exception& ex)
+		{
+			std::cout << ex.what() << std::endl;
+			notificationCurrent = Notification{ ex };
+		}
 
-			//Create fractal screenshots directory if it doesn't exist
-			std::cout << "Checking if fractal screenshots directory exists..." << std::endl;
-			if (!std::filesystem::exists(fractalScreenshotsPath))
-			{
-				bool success = std::filesystem::create_directories(fractalScreenshotsPath);
+#ifdef PLATFORM_WEB
+		UnloadImage(fractalImage);
+#endif
 
-				if (!success)
-				{
-					std::cout << "Failed to create fractal screenshots directory!" << std::endl;
-					return;
-				}
-				else
-				{
-					std::cout << "Created fractal screenshots directory!" << std::endl;
-				}
+		screenshotDeltaTime = -GetFrameTime();
+
+		//TODO: play screenshot sfx here
+	}
+
+	void UpdateScreenshotReadbacks()
+	{
+#ifndef PLATFORM_WEB
+		for (size_t i = 0; i < screenshotReadbacks.size();)
+		{
+			Image fractalImage;
+
+			if (!PollReadback(screenshotReadbacks[i], fractalImage))
+			{
+				i++;
+				continue;
 			}
-			else
+
+			screenshotReadbacks.erase(screenshotReadbacks.begin() + i);
+
+			if (!QueueFractalScreenshot(fractalImage))
+				notificationCurrent = Notification{ "Too many screenshots are still being exported, try again in a moment", 5.0f, WHITE };
+		}
+#endif
+	}
+
+	void ToggleFractalPoster()
+	{
+#ifdef PLATFORM_WEB
+		notificationCurrent = Notification{ "Posters are only supported on the desktop version.", 3.0f, WHITE };
+#else
+		if (IsFractalPosterExporting())
+		{
+			CancelFractalPosterExport();
+			return;
+		}
+
+		//The window's size scaled up, keeping its aspect ratio within the max size
+		float scale = std::min((float)POSTER_SCALE, (float)POSTER_MAX_SIZE / (float)std::max(GetScreenWidth(), GetScreenHeight()));
+
+		int width = std::max((int)((float)GetScreenWidth() * scale), 1);
+		int height = std::max((int)((float)GetScreenHeight() * scale), 1);
+
+		StartFractalPosterExport(fractalParameters, width, height, flipYAxis);
+
+		posterProgressShown = -1;
+#endif
+	}
+
+	void AddFractalKeyframe(bool newAnimation)
+	{
+#ifdef PLATFORM_WEB
+		notificationCurrent = Notification{ "Animations are only supported on the desktop version.", 3.0f, WHITE };
+#else
+		try
+		{
+			//Next fractal_animation-N.txt for the first keyframe
+			if (newAnimation || animationFileName.empty())
 			{
-				std::cout << "Fractal screenshots directory exists!" << std::endl;
+				std::filesystem::path fractalScreenshotsPath = std::filesystem::absolute(GetWorkingDirectory()).append("Fractal_Screenshots").make_preferred();
+				std::filesystem::create_directories(fractalScreenshotsPath);
+
+				std::filesystem::path animationPath;
+
+				for (int number = 1; animationPath.empty() || std::filesystem::exists(animationPath); number++)
+					animationPath = std::filesystem::path(fractalScreenshotsPath).append("fractal_animation-" + std::to_string(number) + ".txt");
+
+				animationFileName = animationPath.string();
+				animationNumKeyframes = 0;
 			}
 
-			std::cout << fractalScreenshotsPath.string() << std::endl;
+			AppendFractalKeyframe(animationFileName, FractalKeyframe{ animationNumKeyframes * ANIMATION_KEYFRAME_SECONDS, fractalParameters });
+			animationNumKeyframes++;
 
-			//Get first unused screenshot number for path
-			int num = 1;
+			notificationCurrent = Notification{ "Added keyframe " + std::to_string(animationNumKeyframes) + " to " + animationFileName, 3.0f, WHITE };
+		}
+		catch (std::exception& ex)
+		{
+			std::cout << ex.what() << std::endl;
+			notificationCurrent = Notification{ ex };
+		}
+#endif
+	}
 
-			while (std::filesystem::exists(std::filesystem::absolute(GetWorkingDirectory()).append("Fractal_Screenshots/fractal_screenshot-" + std::to_string(num) + ".png").make_preferred()))
-				num++;
+	bool IsRenderStatsMeasured()
+	{
+		return showDebugInfo || renderStatsLog.IsOpen();
+	}
 
-			std::filesystem::path screenshotPath = std::filesystem::absolute(GetWorkingDirectory()).append("Fractal_Screenshots/fractal_screenshot-" + std::to_string(num) + ".png").make_preferred();
+	void ToggleRenderStatsLog()
+	{
+#ifdef PLATFORM_WEB
+		notificationCurrent = Notification{ "Render stats logs are only supported on the desktop version.", 3.0f, WHITE };
+#else
+		if (renderStatsLog.IsOpen())
+		{
+			notificationCurrent = Notification{ "Logged " + std::to_string(renderStatsLog.GetNumLines()) + " frames to " + renderStatsLog.GetFileName(), 3.0f, WHITE };
+			renderStatsLog.Close();
+			return;
+		}
 
-			//Export image to file
-			bool exportSuccess = ExportImage(fractalImage, screenshotPath.string().c_str());
+		try
+		{
+			std::filesystem::path fractalScreenshotsPath = std::filesystem::absolute(GetWorkingDirectory()).append("Fractal_Screenshots").make_preferred();
+			std::filesystem::create_directories(fractalScreenshotsPath);
 
-			if (!exportSuccess)
-				throw std::runtime_error("Failed to export fractal screenshot to " + screenshotPath.string());
+			renderStatsLog.Open(std::filesystem::path(fractalScreenshotsPath).append("render_stats.jsonl").string());
 
-			notificationCurrent = Notification{ "Exported fractal screenshot to " + screenshotPath.string(), 5.0f, WHITE };
+			notificationCurrent = Notification{ "Logging render stats to " + renderStatsLog.GetFileName(), 3.0f, WHITE };
+		}
+		catch (std::exception& ex)
+		{
+			std::cout << ex.what() << std::endl;
+			notificationCurrent = Notification{ ex };
+		}
 #endif
+	}
+
+	void WriteProfilerTrace()
+	{
+#ifdef PLATFORM_WEB
+		notificationCurrent = Notification{ "Profiling traces are only supported on the desktop version.", 3.0f, WHITE };
+#else
+		if (!IsProfilerEnabled())
+		{
+			notificationCurrent = Notification{ "Profiling isn't built in, build with -DEXPLORER_PROFILER=ON to write traces.", 3.0f, WHITE };
+			return;
 		}
-		catch(std::exception& ex)
+
+		try
+		{
+			std::filesystem::path fractalScreenshotsPath = std::filesystem::absolute(GetWorkingDirectory()).append("Fractal_Screenshots").make_preferred();
+			std::filesystem::create_directories(fractalScreenshotsPath);
+
+			std::filesystem::path tracePath;
+
+			do
+				tracePath = std::filesystem::path(fractalScreenshotsPath).append("trace-" + std::to_string(++profileTraceNumber) + ".json");
+			while (std::filesystem::exists(tracePath));
+
+			int numZones = WriteProfileTrace(tracePath.string());
+
+			notificationCurrent = Notification{ "Wrote " + std::to_string(numZones) + " zones to " + tracePath.string(), 3.0f, WHITE };
+		}
+		catch (std::exception& ex)
 		{
 			std::cout << ex.what() << std::endl;
 			notificationCurrent = Notification{ ex };
 		}
+#endif
+	}
 
-		UnloadImage(fractalImage);
+	void UpdateRenderStats(double drawSeconds)
+	{
+		renderStatsFrame++;
 
-		screenshotDeltaTime = -GetFrameTime();
+		int width = GetFractalRenderTextureWidth();
+		int height = GetFractalRenderTextureHeight();
 
-		//TODO: play screenshot sfx here
+		FractalRenderStats stats = FractalRenderStats{ renderStatsUpdateSeconds + drawSeconds, -1.0, 0, -1, 0, 0, 0, false };
+		const char* renderer = "";
+
+		if (IsShaderFractalShown() && shaderFractal.IsMultiPass())
+		{
+			renderer = "shader multi-pass";
+
+			//The passes' iterations aren't known, a frame's passes cover every pixel once done
+			stats.gpuSeconds = GetGPUTimerSeconds();
+			stats.pixels = shaderFractal.IsMultiPassComplete() ? 0 : (long long)width * (long long)height;
+		}
+		else if (IsShaderFractalShown())
+		{
+			renderer = "shader";
+
+			//Timings are read a few frames late, the view changes little in between
+			stats.gpuSeconds = GetGPUTimerSeconds();
+
+			//The size DrawScaled renders at
+			float scale = GetShaderResolutionScale();
+			long long pixels = (long long)width * (long long)height;
+
+			if (scale < 1.0f)
+				pixels = (long long)std::max((int)((float)GetScreenWidth() * scale), 1) * (long long)std::max((int)((float)GetScreenHeight() * scale), 1);
+
+			renderStatsSampler.Update(fractalParameters, width, height, flipYAxis);
+
+			if (!renderStatsSampler.Estimate(pixels, stats))
+				stats.pixels = pixels;
+		}
+		else if (cpuRendering && !IsInverseIterationShown())
+		{
+			renderer = "cpu";
+
+			//Rendered by the tile tree's job, between the last two updates
+			stats = cpuFractalTileTree.GetFrameStats();
+		}
+
+		renderStatsMeasured = renderer[0] != '\0';
+
+		//Nothing was rendered, the last frame that was stays shown
+		if (stats.pixels == 0)
+			return;
+
+		renderStats = stats;
+		renderStatsRenderer = renderer;
+
+		renderStatsLog.Append(renderStatsFrame, GetTime(), renderer, fractalParameters, width, height, stats);
+	}
+
+	void UpdateFractalPoster()
+	{
+#ifndef PLATFORM_WEB
+		Notification posterNotification;
+
+		if (PollFractalPosterNotification(posterNotification))
+		{
+			notificationCurrent = posterNotification;
+			return;
+		}
+
+		if (!IsFractalPosterExporting())
+			return;
+
+		int progress = (int)(GetFractalPosterProgress() * 100.0f);
+
+		if (progress != posterProgressShown)
+		{
+			notificationCurrent = Notification{ "Exporting fractal poster: " + std::to_string(progress) + "% (P to cancel)", 5.0f, WHITE };
+			posterProgressShown = progress;
+		}
+#endif
 	}
 	#pragma endregion
 
@@ -543,6 +1411,8 @@ namespace Explorer
 
 	void DrawFractalGrid()
 	{
+		PROFILE_ZONE("Draw grid");
+
 		int screenWidth = GetScreenWidth();
 		int screenHeight = GetScreenHeight();
 
@@ -764,6 +1634,8 @@ namespace Explorer
 
 	void UpdateDrawUI()
 	{
+		PROFILE_ZONE("UI");
+
 		int screenWidth = GetScreenWidth();
 		int screenHeight = GetScreenHeight();
 
@@ -777,7 +1649,11 @@ namespace Explorer
 			return;
 		}
 
-		if (showGrid)
+		if (IsJuliaAtlasShown())
+		{
+			UpdateDrawJuliaAtlas();
+		}
+		else if (showGrid)
 		{
 			DrawFractalGrid();
 
@@ -795,6 +1671,9 @@ namespace Explorer
 		if (showInfoPanel)
 			DrawInfoPanel();
 
+		if (showDebugInfo)
+			DrawDebugInfo();
+
 		DrawFractalEquation();
 
 		//Screenshot flash
@@ -1097,6 +1976,66 @@ namespace Explorer
 		statPosition.y += statFontSize + 2.0f * textPadding.y;
 		statIndex++;
 
+		if (interactionLOD)
+		{
+			DrawStatInfo(TextFormat("Interaction preview: %i%% resolution", (int)(GetShaderResolutionScale() * 100.0f)), statPosition, textPadding, statFontSize, WHITE, statIndex % 2 == 0 ? evenColor : unevenColor);
+			statPosition.y += statFontSize + 2.0f * textPadding.y;
+			statIndex++;
+		}
+		else if (dynamicResolutionTarget != -1 && IsSinglePassShaderShown())
+		{
+			DrawStatInfo(TextFormat("Dynamic resolution: %i%% (%.1f / %.1f ms)", (int)(dynamicResolution.GetScale() * 100.0f), dynamicResolution.GetAverageFrameTime() * 1000.0f, dynamicResolution.GetFrameTimeBudget() * 1000.0f), statPosition, textPadding, statFontSize, WHITE, statIndex % 2 == 0 ? evenColor : unevenColor);
+			statPosition.y += statFontSize + 2.0f * textPadding.y;
+			statIndex++;
+		}
+
+		if (shaderFractal.IsMultiPass())
+		{
+			DrawStatInfo(TextFormat("Multi-pass: %i / %i iterations", shaderFractal.GetMultiPassIterations(), fractalParameters.maxIterations), statPosition, textPadding, statFontSize, WHITE, statIndex % 2 == 0 ? evenColor : unevenColor);
+			statPosition.y += statFontSize + 2.0f * textPadding.y;
+			statIndex++;
+		}
+
+		if (IsJuliaAtlasShown())
+		{
+			DrawStatInfo(TextFormat("Julia atlas: %i x %i in %.0f ms", juliaAtlas.GetNumColumns(), juliaAtlas.GetNumRows(), juliaAtlas.GetSeconds() * 1000.0), statPosition, textPadding, statFontSize, WHITE, statIndex % 2 == 0 ? evenColor : unevenColor);
+			statPosition.y += statFontSize + 2.0f * textPadding.y;
+			statIndex++;
+		}
+		else if (IsBuddhabrotShown())
+		{
+			DrawStatInfo(TextFormat("Buddhabrot: %lli samples", buddhabrot.GetNumSamples()), statPosition, textPadding, statFontSize, WHITE, statIndex % 2 == 0 ? evenColor : unevenColor);
+			statPosition.y += statFontSize + 2.0f * textPadding.y;
+			statIndex++;
+		}
+		else if (IsInverseIterationShown())
+		{
+			DrawStatInfo(TextFormat(inverseIterationJobs.IsBusy() ? "Inverse iteration: %lli points (rendering)" : "Inverse iteration: %lli points", inverseIterationPoints), statPosition, textPadding, statFontSize, WHITE, statIndex % 2 == 0 ? evenColor : unevenColor);
+			statPosition.y += statFontSize + 2.0f * textPadding.y;
+			statIndex++;
+		}
+		else if (cpuRendering)
+		{
+			DrawStatInfo(TextFormat(cpuFractalTileTree.IsRendering() ? "Renderer: CPU, %i tiles (%i left, rendering)" : "Renderer: CPU, %i tiles (%i left)", cpuFractalTileTree.GetNumTiles(), cpuFractalTileTree.GetNumWantedTiles()), statPosition, textPadding, statFontSize, WHITE, statIndex % 2 == 0 ? evenColor : unevenColor);
+			statPosition.y += statFontSize + 2.0f * textPadding.y;
+			statIndex++;
+
+			//Busiest thread over the mean, of the last job
+			if (cpuFractalTileTree.GetLoadImbalance() > 0.0f)
+			{
+				DrawStatInfo(TextFormat("CPU load imbalance: %.2f (busiest thread / mean)", cpuFractalTileTree.GetLoadImbalance()), statPosition, textPadding, statFontSize, WHITE, statIndex % 2 == 0 ? evenColor : unevenColor);
+				statPosition.y += statFontSize + 2.0f * textPadding.y;
+				statIndex++;
+			}
+		}
+
+		if (fractalParameters.fastMath && FractalSupportsFastMath(fractalParameters.type))
+		{
+			DrawStatInfo("Fast math", statPosition, textPadding, statFontSize, WHITE, statIndex % 2 == 0 ? evenColor : unevenColor);
+			statPosition.y += statFontSize + 2.0f * textPadding.y;
+			statIndex++;
+		}
+
 		if (FractalSupportsPower(fractalParameters.type))
 		{
 			DrawStatInfo(TextFormat("n = %g", fractalParameters.power), statPosition, textPadding, statFontSize, WHITE, statIndex % 2 == 0 ? evenColor : unevenColor);
@@ -1119,6 +2058,67 @@ namespace Explorer
 		}
 	}
 
+	void DrawDebugInfo()
+	{
+		int screenWidth = GetScreenWidth();
+
+		float screenScale = GetScreenScale(DESIGN_WIDTH, DESIGN_HEIGHT);
+
+		float statFontSize = 24.0f * sqrt(screenScale);
+
+		Font mainFontSemibold = Resources::GetFont("mainFontSemibold");
+
+		//render stats, right aligned
+
+		Vector2 textPadding = Vector2{ 5.0f * screenScale, 0.0f };
+		Vector2 statPosition = Vector2{ 0.0f, 0.0f };
+
+		Color unevenColor = ColorAlpha(GRAY, 0.4f);
+		Color evenColor = ColorAlpha(DARKGRAY, 0.4f);
+
+		int statIndex = 0;
+
+		auto drawStat = [&](const char* text, Color textColor)
+		{
+			statPosition.x = (float)screenWidth - MeasureTextEx(mainFontSemibold, text, statFontSize, statFontSize * FONT_SPACING_MULTIPLIER).x - textPadding.x * 2.0f;
+
+			DrawStatInfo(text, statPosition, textPadding, statFontSize, textColor, statIndex % 2 == 0 ? evenColor : unevenColor);
+			statPosition.y += statFontSize + 2.0f * textPadding.y;
+			statIndex++;
+		};
+
+		if (!renderStatsMeasured)
+			drawStat("Render stats: not measured for this renderer", GRAY);
+
+		if (renderStatsRenderer[0] != '\0')
+		{
+			double pixels = (double)std::max(renderStats.pixels, 1ll);
+
+			drawStat(TextFormat(renderStats.estimated ? "Renderer: %s (iterations estimated)" : "Renderer: %s", renderStatsRenderer), WHITE);
+
+			if (renderStats.gpuSeconds >= 0.0)
+				drawStat(TextFormat("CPU: %.2f ms, GPU: %.2f ms", renderStats.cpuSeconds * 1000.0, renderStats.gpuSeconds * 1000.0), WHITE);
+			else
+				drawStat(TextFormat("CPU: %.2f ms, GPU: n/a", renderStats.cpuSeconds * 1000.0), WHITE);
+
+			drawStat(TextFormat("Pixels: %lli", renderStats.pixels), WHITE);
+
+			if (renderStats.iterations >= 0)
+			{
+				drawStat(TextFormat("Iterations: %.2f M, %.1f per pixel", (double)renderStats.iterations / 1e6, (double)renderStats.iterations / pixels), WHITE);
+				drawStat(TextFormat("Escaped %.1f%%, interior %.1f%%, converged %.1f%%", 100.0 * (double)renderStats.escapedPixels / pixels, 100.0 * (double)renderStats.interiorPixels / pixels, 100.0 * (double)renderStats.convergedPixels / pixels), WHITE);
+				drawStat(TextFormat("Throughput: %.0f Miter/s", GetFractalRenderThroughput(renderStats)), WHITE);
+			}
+			else
+			{
+				drawStat("Iterations: n/a", WHITE);
+			}
+		}
+
+		if (renderStatsLog.IsOpen())
+			drawStat(TextFormat("Logging: %lli frames", renderStatsLog.GetNumLines()), RED);
+	}
+
 	void DrawStatInfo(const char* text, Vector2 position, Vector2 textPadding, float fontSize, Color textColor, Color backgroundColor)
 	{
 		Font mainFontSemibold = Resources::GetFont("mainFontSemibold");
@@ -1249,6 +2249,43 @@ namespace Explorer
 		}
 	}
 
+	void UpdateDrawJuliaAtlas()
+	{
+		float screenScaleSqrt = sqrt(GetScreenScale(DESIGN_WIDTH, DESIGN_HEIGHT));
+
+		float outlineThickness = 2.0f * screenScaleSqrt;
+		float valueFontSize = 24.0f * screenScaleSqrt;
+
+		Font& mainFontSemibold = Resources::GetFont("mainFontSemibold");
+
+		int hoveredCell = activePressStartedOnUI ? -1 : juliaAtlas.GetCellAt(GetMousePosition());
+
+		if (hoveredCell == -1)
+			return;
+
+		Rectangle cellRect = juliaAtlas.GetCellRect(hoveredCell);
+		Vector2 cellC = juliaAtlas.GetCellC(hoveredCell);
+
+		DrawRectangleLinesEx(cellRect, outlineThickness, WHITE);
+
+		const char* valueText = TextFormat("%g%+gi", cellC.x, cellC.y);
+		Vector2 valueSize = MeasureTextEx(mainFontSemibold, valueText, valueFontSize, valueFontSize * FONT_SPACING_MULTIPLIER);
+		Vector2 valuePosition = Vector2{ cellRect.x + (cellRect.width - valueSize.x) / 2.0f, cellRect.y - valueSize.y };
+
+		DrawRectangleRec(Rectangle{ valuePosition.x, valuePosition.y, valueSize.x, valueSize.y }, ColorAlpha(DARKGRAY, 0.6f));
+		DrawTextEx(mainFontSemibold, valueText, valuePosition, valueFontSize, valueFontSize * FONT_SPACING_MULTIPLIER, WHITE);
+
+		//Pick c
+		if (IsMouseButtonReleased(MOUSE_BUTTON_LEFT))
+		{
+			fractalParameters.c = cellC;
+			shaderFractal.SetC(fractalParameters.c);
+
+			ToggleJuliaAtlas();
+			notificationCurrent = Notification{ TextFormat("c = %g%+gi", cellC.x, cellC.y), 3.0f, WHITE };
+		}
+	}
+
 	void UpdateDrawNotification()
 	{
 		float deltaTime = GetFrameTime();
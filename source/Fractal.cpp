@@ -1,7 +1,15 @@
 #include "Fractal.h"
 
+#include <bit>
+#include <cmath>
+#include <algorithm>
+
 #include "raylib.h"
 #include "raymath.h"
+#include "rlgl.h"
+
+#include "Readback.h"
+#include "Profiler.h"
 
 namespace Explorer
 {
@@ -27,6 +35,20 @@ namespace Explorer
 
 	RenderTexture fractalRenderTexture;
 
+	//Reduced resolution target of ShaderFractal::DrawScaled, loaded at the destination's full size so any scale is a rectangle of it
+	RenderTexture fractalScaledRenderTexture;
+
+	//Shader render modes, must match the renderMode uniform values in the fractal shaders
+	const int RENDER_MODE_SINGLE_PASS = 0;
+	const int RENDER_MODE_ITERATE = 1;
+	const int RENDER_MODE_COLOR = 2;
+
+	//Ping-pong state textures for multi-pass rendering, each pixel stores (z.x, z.y, iterations, result)
+	RenderTexture fractalStateTextures[2];
+	int fractalStateIndex = 0;
+
+	RenderTexture LoadStateRenderTexture(int width, int height);
+
 	const char* GetFractalName(FractalType fractalType)
 	{
 		switch (fractalType)
@@ -126,6 +148,79 @@ namespace Explorer
 		return type != FRACTAL_NEWTON_3DEG && type != FRACTAL_NEWTON_4DEG && type != FRACTAL_NEWTON_5DEG && type != FRACTAL_NEWTON_SIN;
 	}
 
+	bool FractalSupportsFastMath(FractalType type)
+	{
+		//polynomial newton fractals only multiply & divide
+		return type != FRACTAL_NEWTON_3DEG && type != FRACTAL_NEWTON_4DEG && type != FRACTAL_NEWTON_5DEG;
+	}
+
+	bool AreFractalParametersEqual(const FractalParameters& a, const FractalParameters& b)
+	{
+		if (a.type != b.type || a.zoom != b.zoom || a.maxIterations != b.maxIterations || a.power != b.power || a.colorBanding != b.colorBanding || a.fastMath != b.fastMath)
+			return false;
+
+		if (a.normalizedCenterOffset.x != b.normalizedCenterOffset.x || a.normalizedCenterOffset.y != b.normalizedCenterOffset.y)
+			return false;
+
+		if (a.position.x != b.position.x || a.position.y != b.position.y || a.c.x != b.c.x || a.c.y != b.c.y || a.a.x != b.a.x || a.a.y != b.a.y)
+			return false;
+
+		for (int i = 0; i < NUM_MAX_ROOTS; i++)
+		{
+			if (a.roots[i].x != b.roots[i].x || a.roots[i].y != b.roots[i].y)
+				return false;
+		}
+
+		return true;
+	}
+
+	unsigned long long HashFractalValue(unsigned long long hash, unsigned long long value)
+	{
+		//FNV-1a, a byte at a time
+		for (int i = 0; i < 8; i++)
+		{
+			hash ^= (value >> (8 * i)) & 0xFF;
+			hash *= 0x100000001B3ull;
+		}
+
+		return hash;
+	}
+
+	//-0 & 0 are equal, so they hash the same
+	inline unsigned long long HashFractalFloat(unsigned long long hash, float value)
+	{
+		return HashFractalValue(hash, value == 0.0f ? 0ull : (unsigned long long)std::bit_cast<unsigned int>(value));
+	}
+
+	unsigned long long HashFractalParameters(const FractalParameters& parameters)
+	{
+		unsigned long long hash = 0xCBF29CE484222325ull;
+
+		hash = HashFractalValue(hash, (unsigned long long)parameters.type);
+		hash = HashFractalFloat(hash, parameters.normalizedCenterOffset.x);
+		hash = HashFractalFloat(hash, parameters.normalizedCenterOffset.y);
+		hash = HashFractalFloat(hash, parameters.position.x);
+		hash = HashFractalFloat(hash, parameters.position.y);
+		hash = HashFractalFloat(hash, parameters.zoom);
+		hash = HashFractalValue(hash, (unsigned long long)parameters.maxIterations);
+		hash = HashFractalFloat(hash, parameters.power);
+		hash = HashFractalFloat(hash, parameters.c.x);
+		hash = HashFractalFloat(hash, parameters.c.y);
+
+		for (int i = 0; i < NUM_MAX_ROOTS; i++)
+		{
+			hash = HashFractalFloat(hash, parameters.roots[i].x);
+			hash = HashFractalFloat(hash, parameters.roots[i].y);
+		}
+
+		hash = HashFractalFloat(hash, parameters.a.x);
+		hash = HashFractalFloat(hash, parameters.a.y);
+		hash = HashFractalValue(hash, parameters.colorBanding ? 1ull : 0ull);
+		hash = HashFractalValue(hash, parameters.fastMath ? 1ull : 0ull);
+
+		return hash;
+	}
+
 	#pragma endregion
 
 	#pragma region Render Texture
@@ -140,11 +235,68 @@ namespace Explorer
 			DrawRectangle(0, 0, fractalRenderTexture.texture.width, fractalRenderTexture.texture.height, BLACK);
 		}
 		EndTextureMode();
+
+		//Multi-pass state textures, unsupported if these fail to load
+		fractalStateTextures[0] = LoadStateRenderTexture(width, height);
+		fractalStateTextures[1] = LoadStateRenderTexture(width, height);
+		fractalStateIndex = 0;
+
+		if (fractalStateTextures[0].id == 0 || fractalStateTextures[1].id == 0)
+		{
+			TraceLog(LOG_WARNING, "FRACTAL: Float render textures not supported, multi-pass rendering unavailable");
+
+			UnloadRenderTexture(fractalStateTextures[0]);
+			UnloadRenderTexture(fractalStateTextures[1]);
+
+			fractalStateTextures[0] = RenderTexture{ 0 };
+			fractalStateTextures[1] = RenderTexture{ 0 };
+		}
+	}
+
+	RenderTexture LoadStateRenderTexture(int width, int height)
+	{
+		//LoadRenderTexture only creates 8-bit rgba textures, which can't hold z, so the float framebuffer is set up using rlgl
+		RenderTexture target = { 0 };
+
+		target.id = rlLoadFramebuffer(width, height);
+
+		if (target.id == 0)
+			return target;
+
+		target.texture.id = rlLoadTexture(NULL, width, height, PIXELFORMAT_UNCOMPRESSED_R32G32B32A32, 1);
+		target.texture.width = width;
+		target.texture.height = height;
+		target.texture.format = PIXELFORMAT_UNCOMPRESSED_R32G32B32A32;
+		target.texture.mipmaps = 1;
+
+		bool complete = false;
+
+		if (target.texture.id != 0)
+		{
+			rlEnableFramebuffer(target.id);
+			rlFramebufferAttach(target.id, target.texture.id, RL_ATTACHMENT_COLOR_CHANNEL0, RL_ATTACHMENT_TEXTURE2D, 0);
+			complete = rlFramebufferComplete(target.id);
+			rlDisableFramebuffer();
+		}
+
+		if (!complete)
+		{
+			UnloadRenderTexture(target);
+			return RenderTexture{ 0 };
+		}
+
+		return target;
+	}
+
+	bool IsMultiPassSupported()
+	{
+		return fractalStateTextures[0].id != 0 && fractalStateTextures[1].id != 0;
 	}
 
 	void SetFractalRenderTextureSize(int width, int height)
 	{
-		UnloadRenderTexture(fractalRenderTexture);
+		//State textures are reloaded at the new size too, so the multi-pass has to be restarted after this
+		UnloadFractalRenderTexture();
 
 		InitFractalRenderTexture(width, height);
 	}
@@ -162,6 +314,20 @@ namespace Explorer
 	void UnloadFractalRenderTexture()
 	{
 		UnloadRenderTexture(fractalRenderTexture);
+
+		if (fractalScaledRenderTexture.id != 0)
+			UnloadRenderTexture(fractalScaledRenderTexture);
+
+		fractalScaledRenderTexture = RenderTexture{ 0 };
+
+		if (IsMultiPassSupported())
+		{
+			UnloadRenderTexture(fractalStateTextures[0]);
+			UnloadRenderTexture(fractalStateTextures[1]);
+		}
+
+		fractalStateTextures[0] = RenderTexture{ 0 };
+		fractalStateTextures[1] = RenderTexture{ 0 };
 	}
 	#pragma endregion
 
@@ -181,46 +347,68 @@ namespace Explorer
 	void ShaderFractal::SetNormalizedCenterOffset(Vector2 offset)
 	{
 		SetShaderValue(fractalShader, GetShaderLocation(fractalShader, "offset"), &offset, SHADER_UNIFORM_VEC2);
+
+		RestartMultiPass();
 	}
 
 	void ShaderFractal::SetWidthStretch(float widthStretch)
 	{
 		SetShaderValue(fractalShader, GetShaderLocation(fractalShader, "widthStretch"), &widthStretch, SHADER_UNIFORM_FLOAT);
+
+		RestartMultiPass();
 	}
 
 	void ShaderFractal::SetPosition(Vector2 position)
 	{
 		SetShaderValue(fractalShader, GetShaderLocation(fractalShader, "position"), &position, SHADER_UNIFORM_VEC2);
+
+		RestartMultiPass();
 	}
 
 	void ShaderFractal::SetZoom(float zoom)
 	{
 		SetShaderValue(fractalShader, GetShaderLocation(fractalShader, "zoom"), &zoom, SHADER_UNIFORM_FLOAT);
+
+		RestartMultiPass();
 	}
 
 	void ShaderFractal::SetMaxIterations(int maxIterations)
 	{
 		SetShaderValue(fractalShader, GetShaderLocation(fractalShader, "maxIterations"), &maxIterations, SHADER_UNIFORM_INT);
+
+		//Pixels that are still iterating can continue from their stored state if max iterations went up
+		if (maxIterations < this->maxIterations)
+			RestartMultiPass();
+
+		this->maxIterations = maxIterations;
 	}
 
 	void ShaderFractal::SetPower(float power)
 	{
 		SetShaderValue(fractalShader, GetShaderLocation(fractalShader, "power"), &power, SHADER_UNIFORM_FLOAT);
+
+		RestartMultiPass();
 	}
 
 	void ShaderFractal::SetC(Vector2 c)
 	{
 		SetShaderValue(fractalShader, GetShaderLocation(fractalShader, "c"), &c, SHADER_UNIFORM_VEC2);
+
+		RestartMultiPass();
 	}
 
 	void ShaderFractal::SetRoots(const Vector2* roots, int num)
 	{
 		SetShaderValueV(fractalShader, GetShaderLocation(fractalShader, "roots"), roots, SHADER_UNIFORM_VEC2, num);
+
+		RestartMultiPass();
 	}
 
 	void ShaderFractal::SetA(Vector2 a)
 	{
 		SetShaderValue(fractalShader, GetShaderLocation(fractalShader, "a"), &a, SHADER_UNIFORM_VEC2);
+
+		RestartMultiPass();
 	}
 
 	void ShaderFractal::SetColorBanding(bool colorBanding)
@@ -228,6 +416,44 @@ namespace Explorer
 		//SetShaderValue has no way of setting uniform bools, so an integer is used instead
 		int colorBandingInt = colorBanding ? 1 : 0;
 		SetShaderValue(fractalShader, GetShaderLocation(fractalShader, "colorBanding"), &colorBandingInt, SHADER_UNIFORM_INT);
+
+		//Color banding changes the escape radius
+		RestartMultiPass();
+	}
+
+	void ShaderFractal::SetFastMath(bool fastMath)
+	{
+		int fastMathInt = fastMath ? 1 : 0;
+		SetShaderValue(fractalShader, GetShaderLocation(fractalShader, "fastMath"), &fastMathInt, SHADER_UNIFORM_INT);
+
+		RestartMultiPass();
+	}
+
+	void ShaderFractal::SetMultiPass(bool enabled)
+	{
+		multiPass = enabled && IsMultiPassSupported();
+
+		RestartMultiPass();
+	}
+
+	bool ShaderFractal::IsMultiPass() const
+	{
+		return multiPass;
+	}
+
+	void ShaderFractal::RestartMultiPass()
+	{
+		multiPassIterations = 0;
+	}
+
+	int ShaderFractal::GetMultiPassIterations() const
+	{
+		return multiPassIterations;
+	}
+
+	bool ShaderFractal::IsMultiPassComplete() const
+	{
+		return multiPassIterations >= maxIterations;
 	}
 
 	void ShaderFractal::Unload()
@@ -237,26 +463,117 @@ namespace Explorer
 	#pragma endregion
 
 	#pragma region Drawing
+	void ShaderFractal::UpdateMultiPass(int iterationsPerPass, int numPasses)
+	{
+		PROFILE_ZONE("Shader multi-pass");
+
+		if (!multiPass)
+			return;
+
+		int renderMode = RENDER_MODE_ITERATE;
+		SetShaderValue(fractalShader, GetShaderLocation(fractalShader, "renderMode"), &renderMode, SHADER_UNIFORM_INT);
+		SetShaderValue(fractalShader, GetShaderLocation(fractalShader, "passIterations"), &iterationsPerPass, SHADER_UNIFORM_INT);
+
+		for (int pass = 0; pass < numPasses && !IsMultiPassComplete(); pass++)
+		{
+			const RenderTexture& source = fractalStateTextures[fractalStateIndex];
+			const RenderTexture& target = fractalStateTextures[1 - fractalStateIndex];
+
+			//first pass starts from the pixel's position instead of the source state
+			SetShaderValue(fractalShader, GetShaderLocation(fractalShader, "iterationStart"), &multiPassIterations, SHADER_UNIFORM_INT);
+
+			BeginTextureMode(target);
+			{
+				//State has to be written as is, alpha blending would mix it with the previous contents
+				rlDisableColorBlend();
+
+				BeginShaderMode(fractalShader);
+				{
+					//Source is flipped back, so every state pixel maps to the same pixel in the target
+					Rectangle stateSource = { 0.0f, 0.0f, (float)source.texture.width, -(float)source.texture.height };
+
+					DrawTexturePro(source.texture, stateSource, Rectangle{ 0.0f, 0.0f, (float)target.texture.width, (float)target.texture.height }, { 0.0f, 0.0f }, 0.0f, WHITE);
+				}
+				EndShaderMode();
+
+				rlEnableColorBlend();
+			}
+			EndTextureMode();
+
+			fractalStateIndex = 1 - fractalStateIndex;
+			multiPassIterations = std::min(multiPassIterations + iterationsPerPass, maxIterations);
+		}
+	}
+
 	void ShaderFractal::Draw(Rectangle destination, bool flipX, bool flipY) const
 	{
+		PROFILE_ZONE("Shader draw");
+
 		int renderWidth = GetRenderWidth();
 		int renderHeight = GetRenderHeight();
 
+		//Multi-pass only colors the current state, single pass computes the whole fractal in this draw
+		int renderMode = multiPass ? RENDER_MODE_COLOR : RENDER_MODE_SINGLE_PASS;
+		SetShaderValue(fractalShader, GetShaderLocation(fractalShader, "renderMode"), &renderMode, SHADER_UNIFORM_INT);
+
+		const Texture& fractalTexture = multiPass ? fractalStateTextures[fractalStateIndex].texture : fractalRenderTexture.texture;
+
 		BeginShaderMode(fractalShader);
 		{
 			//Fractal is drawn flipped because of flipped render texture, so the vertically flipped version is actually the correct side up
 			//if flipY is true it will be flipped again
-			Rectangle fractalSource = { 0.0f, 0.0f, flipX ? -(float)fractalRenderTexture.texture.width : (float)fractalRenderTexture.texture.width, flipY ? (float)fractalRenderTexture.texture.height : -(float)fractalRenderTexture.texture.height };
+			Rectangle fractalSource = { 0.0f, 0.0f, flipX ? -(float)fractalTexture.width : (float)fractalTexture.width, flipY ? (float)fractalTexture.height : -(float)fractalTexture.height };
 
-			DrawTexturePro(fractalRenderTexture.texture, fractalSource, destination, { 0.0f, 0.0f }, 0.0f, WHITE);
+			DrawTexturePro(fractalTexture, fractalSource, destination, { 0.0f, 0.0f }, 0.0f, WHITE);
 		}
 		EndShaderMode();
 	}
 
-	Image ShaderFractal::GenImage(bool flipX, bool flipY) const
+	void ShaderFractal::DrawScaled(Rectangle destination, float resolutionScale, bool flipX, bool flipY) const
 	{
-		//Fractal render
-		RenderTexture2D fractalImageRender = LoadRenderTexture(fractalRenderTexture.texture.width, fractalRenderTexture.texture.height);
+		PROFILE_ZONE("Shader draw scaled");
+
+		if (resolutionScale >= 1.0f)
+		{
+			Draw(destination, flipX, flipY);
+			return;
+		}
+
+		int width = std::max((int)(destination.width * resolutionScale), 1);
+		int height = std::max((int)(destination.height * resolutionScale), 1);
+
+		//Only reloaded when the destination grows (the window was resized), scale changes just draw into a smaller rectangle
+		int fullWidth = std::max((int)std::ceil(destination.width), 1);
+		int fullHeight = std::max((int)std::ceil(destination.height), 1);
+
+		if (fractalScaledRenderTexture.texture.width < fullWidth || fractalScaledRenderTexture.texture.height < fullHeight)
+		{
+			if (fractalScaledRenderTexture.id != 0)
+				UnloadRenderTexture(fractalScaledRenderTexture);
+
+			fractalScaledRenderTexture = LoadRenderTexture(fullWidth, fullHeight);
+			SetTextureFilter(fractalScaledRenderTexture.texture, TEXTURE_FILTER_BILINEAR);
+		}
+
+		BeginTextureMode(fractalScaledRenderTexture);
+		{
+			//render textures are flipped, y is flipped again
+			Draw(Rectangle{ 0.0f, 0.0f, (float)width, (float)height }, flipX, !flipY);
+		}
+		EndTextureMode();
+
+		//The rectangle drawn into is the top of the texture mode, which is the bottom rows of the flipped texture,
+		//its right edge & first row are inside the texture, they're moved in by half a pixel so bilinear filtering doesn't blend in what an earlier scale left there
+		float textureHeight = (float)fractalScaledRenderTexture.texture.height;
+		Rectangle scaledSource = Rectangle{ 0.0f, textureHeight - (float)height + 0.5f, (float)width - 0.5f, -((float)height - 0.5f) };
+
+		DrawTexturePro(fractalScaledRenderTexture.texture, scaledSource, destination, { 0.0f, 0.0f }, 0.0f, WHITE);
+	}
+
+	RenderTexture2D ShaderFractal::DrawToReadbackRenderTexture(bool flipX, bool flipY) const
+	{
+		//Reused between calls, see Readback.h
+		RenderTexture2D fractalImageRender = GetReadbackRenderTexture(fractalRenderTexture.texture.width, fractalRenderTexture.texture.height);
 
 		BeginTextureMode(fractalImageRender);
 		{
@@ -267,12 +584,23 @@ namespace Explorer
 		}
 		EndTextureMode();
 
-		Image fractalImage = LoadImageFromTexture(fractalImageRender.texture);
+		return fractalImageRender;
+	}
+
+	Image ShaderFractal::GenImage(bool flipX, bool flipY) const
+	{
+		int readback = QueueReadback(DrawToReadbackRenderTexture(flipX, flipY));
+
+		//Every readback is in flight, read synchronously instead
+		if (readback == -1)
+			return LoadImageFromTexture(GetReadbackRenderTexture(fractalRenderTexture.texture.width, fractalRenderTexture.texture.height).texture);
 
-		//Unload
-		UnloadRenderTexture(fractalImageRender);
+		return WaitReadback(readback);
+	}
 
-		return fractalImage;
+	int ShaderFractal::QueueImage(bool flipX, bool flipY) const
+	{
+		return QueueReadback(DrawToReadbackRenderTexture(flipX, flipY));
 	}
 	#pragma endregion
 
@@ -0,0 +1,188 @@
+#include "GPUTimer.h"
+
+#include "raylib.h"
+
+#ifndef PLATFORM_WEB
+//raylib loads OpenGL through glfw, rlgl doesn't expose queries, so the few functions needed are loaded the same way (see Readback.cpp)
+typedef void (*GLFWglproc)(void);
+extern "C" GLFWglproc glfwGetProcAddress(const char* procname);
+
+#if defined(_WIN32) && !defined(_WIN64)
+#define GPU_TIMER_APIENTRY __stdcall
+#else
+#define GPU_TIMER_APIENTRY
+#endif
+#endif
+
+namespace Explorer
+{
+	struct GPUTimerSlot
+	{
+		bool busy;
+		unsigned int query;
+	};
+
+	GPUTimerSlot gpuTimerSlots[GPU_TIMER_RING_SIZE] = {};
+
+	//Oldest timing in flight, & the slot of the running one (-1 if there's none)
+	int gpuTimerOldestSlot = 0;
+	int gpuTimerRunningSlot = -1;
+
+	double gpuTimerSeconds = -1.0;
+
+#ifndef PLATFORM_WEB
+	#pragma region OpenGL
+	const unsigned int GL_TIME_ELAPSED_VALUE = 0x88BF;
+	const unsigned int GL_QUERY_RESULT_VALUE = 0x8866;
+	const unsigned int GL_QUERY_RESULT_AVAILABLE_VALUE = 0x8867;
+
+	typedef void (GPU_TIMER_APIENTRY* GenQueriesFunction)(int n, unsigned int* ids);
+	typedef void (GPU_TIMER_APIENTRY* DeleteQueriesFunction)(int n, const unsigned int* ids);
+	typedef void (GPU_TIMER_APIENTRY* BeginQueryFunction)(unsigned int target, unsigned int id);
+	typedef void (GPU_TIMER_APIENTRY* EndQueryFunction)(unsigned int target);
+	typedef void (GPU_TIMER_APIENTRY* GetQueryObjectivFunction)(unsigned int id, unsigned int name, int* params);
+	typedef void (GPU_TIMER_APIENTRY* GetQueryObjectui64vFunction)(unsigned int id, unsigned int name, unsigned long long* params);
+
+	struct GPUTimerFunctions
+	{
+		GenQueriesFunction genQueries;
+		DeleteQueriesFunction deleteQueries;
+		BeginQueryFunction beginQuery;
+		EndQueryFunction endQuery;
+		GetQueryObjectivFunction getQueryObjectiv;
+		GetQueryObjectui64vFunction getQueryObjectui64v;
+	};
+
+	GPUTimerFunctions gpuTimerGL = {};
+
+	//0: not loaded yet, 1: loaded, -1: unavailable
+	int gpuTimerFunctionsState = 0;
+
+	bool LoadGPUTimerFunctions()
+	{
+		if (gpuTimerFunctionsState != 0)
+			return gpuTimerFunctionsState == 1;
+
+		gpuTimerGL.genQueries = (GenQueriesFunction)glfwGetProcAddress("glGenQueries");
+		gpuTimerGL.deleteQueries = (DeleteQueriesFunction)glfwGetProcAddress("glDeleteQueries");
+		gpuTimerGL.beginQuery = (BeginQueryFunction)glfwGetProcAddress("glBeginQuery");
+		gpuTimerGL.endQuery = (EndQueryFunction)glfwGetProcAddress("glEndQuery");
+		gpuTimerGL.getQueryObjectiv = (GetQueryObjectivFunction)glfwGetProcAddress("glGetQueryObjectiv");
+		gpuTimerGL.getQueryObjectui64v = (GetQueryObjectui64vFunction)glfwGetProcAddress("glGetQueryObjectui64v");
+
+		bool loaded = gpuTimerGL.genQueries && gpuTimerGL.deleteQueries && gpuTimerGL.beginQuery && gpuTimerGL.endQuery && gpuTimerGL.getQueryObjectiv && gpuTimerGL.getQueryObjectui64v;
+
+		if (!loaded)
+			TraceLog(LOG_WARNING, "GPU TIMER: Timer queries unavailable, gpu times aren't measured");
+
+		gpuTimerFunctionsState = loaded ? 1 : -1;
+
+		return loaded;
+	}
+	#pragma endregion
+
+	//Reads the finished timings, oldest first, stops at the first one still in flight
+	void PollGPUTimer()
+	{
+		while (gpuTimerSlots[gpuTimerOldestSlot].busy && gpuTimerOldestSlot != gpuTimerRunningSlot)
+		{
+			GPUTimerSlot& slot = gpuTimerSlots[gpuTimerOldestSlot];
+
+			int available = 0;
+			gpuTimerGL.getQueryObjectiv(slot.query, GL_QUERY_RESULT_AVAILABLE_VALUE, &available);
+
+			if (!available)
+				return;
+
+			unsigned long long nanoseconds = 0;
+			gpuTimerGL.getQueryObjectui64v(slot.query, GL_QUERY_RESULT_VALUE, &nanoseconds);
+
+			gpuTimerSeconds = (double)nanoseconds / 1e9;
+
+			slot.busy = false;
+			gpuTimerOldestSlot = (gpuTimerOldestSlot + 1) % GPU_TIMER_RING_SIZE;
+		}
+	}
+#endif
+
+	bool IsGPUTimerAvailable()
+	{
+#ifdef PLATFORM_WEB
+		return false;
+#else
+		return LoadGPUTimerFunctions();
+#endif
+	}
+
+	void BeginGPUTimer()
+	{
+#ifndef PLATFORM_WEB
+		if (!IsGPUTimerAvailable() || gpuTimerRunningSlot != -1)
+			return;
+
+		PollGPUTimer();
+
+		//The slot after the newest one, skipped if the ring is full
+		int slotIndex = gpuTimerOldestSlot;
+
+		while (gpuTimerSlots[slotIndex].busy)
+		{
+			slotIndex = (slotIndex + 1) % GPU_TIMER_RING_SIZE;
+
+			if (slotIndex == gpuTimerOldestSlot)
+				return;
+		}
+
+		GPUTimerSlot& slot = gpuTimerSlots[slotIndex];
+
+		if (slot.query == 0)
+			gpuTimerGL.genQueries(1, &slot.query);
+
+		gpuTimerGL.beginQuery(GL_TIME_ELAPSED_VALUE, slot.query);
+
+		slot.busy = true;
+		gpuTimerRunningSlot = slotIndex;
+#endif
+	}
+
+	void EndGPUTimer()
+	{
+#ifndef PLATFORM_WEB
+		if (gpuTimerRunningSlot == -1)
+			return;
+
+		gpuTimerGL.endQuery(GL_TIME_ELAPSED_VALUE);
+		gpuTimerRunningSlot = -1;
+#endif
+	}
+
+	double GetGPUTimerSeconds()
+	{
+#ifndef PLATFORM_WEB
+		if (IsGPUTimerAvailable())
+			PollGPUTimer();
+#endif
+
+		return gpuTimerSeconds;
+	}
+
+	void UnloadGPUTimer()
+	{
+#ifndef PLATFORM_WEB
+		EndGPUTimer();
+
+		for (GPUTimerSlot& slot : gpuTimerSlots)
+		{
+			if (slot.query != 0)
+				gpuTimerGL.deleteQueries(1, &slot.query);
+
+			slot = GPUTimerSlot{};
+		}
+#endif
+
+		gpuTimerOldestSlot = 0;
+		gpuTimerRunningSlot = -1;
+
+		gpuTimerSeconds = -1.0;
+	}
+}
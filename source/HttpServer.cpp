@@ -0,0 +1,219 @@
+#include "HttpServer.h"
+
+#include <cctype>
+#include <thread>
+#include <string>
+#include <semaphore>
+#include <stdexcept>
+#include <algorithm>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <csignal>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#endif
+
+namespace Explorer
+{
+	#pragma region Sockets
+#ifdef _WIN32
+	typedef SOCKET HttpSocket;
+
+	const HttpSocket INVALID_HTTP_SOCKET = INVALID_SOCKET;
+
+	void CloseHttpSocket(HttpSocket socket)
+	{
+		closesocket(socket);
+	}
+#else
+	typedef int HttpSocket;
+
+	const HttpSocket INVALID_HTTP_SOCKET = -1;
+
+	void CloseHttpSocket(HttpSocket socket)
+	{
+		close(socket);
+	}
+#endif
+
+	bool SendAll(HttpSocket socket, const char* data, size_t size)
+	{
+		while (size > 0)
+		{
+			int sent = (int)send(socket, data, (int)std::min(size, (size_t)1 << 20), 0);
+
+			if (sent <= 0)
+				return false;
+
+			data += sent;
+			size -= (size_t)sent;
+		}
+
+		return true;
+	}
+	#pragma endregion
+
+	#pragma region Requests
+	const size_t HTTP_MAX_HEADER_SIZE = 16384;
+
+	std::string DecodeUrl(const std::string& text)
+	{
+		std::string decoded;
+
+		for (size_t i = 0; i < text.size(); i++)
+		{
+			if (text[i] == '%' && i + 2 < text.size() && std::isxdigit((unsigned char)text[i + 1]) && std::isxdigit((unsigned char)text[i + 2]))
+			{
+				decoded += (char)std::stoi(text.substr(i + 1, 2), nullptr, 16);
+				i += 2;
+			}
+			else
+			{
+				decoded += text[i] == '+' ? ' ' : text[i];
+			}
+		}
+
+		return decoded;
+	}
+
+	const char* GetHttpStatusText(int status)
+	{
+		switch (status)
+		{
+			case 200:
+				return "OK";
+			case 400:
+				return "Bad Request";
+			case 404:
+				return "Not Found";
+			case 405:
+				return "Method Not Allowed";
+			default:
+				return "Internal Server Error";
+		}
+	}
+
+	//Reads the request's header (there's no body for a GET), answers it & closes the connection
+	void HandleHttpConnection(HttpSocket socket, const std::function<HttpResponse(const HttpRequest&)>& handler)
+	{
+		std::string header;
+		char buffer[4096];
+
+		while (header.find("\r\n\r\n") == std::string::npos && header.size() < HTTP_MAX_HEADER_SIZE)
+		{
+			int received = (int)recv(socket, buffer, (int)sizeof(buffer), 0);
+
+			if (received <= 0)
+				break;
+
+			header.append(buffer, (size_t)received);
+		}
+
+		HttpResponse response = HttpResponse{ 400, "text/plain", "Bad request\n" };
+
+		//"GET /path?query HTTP/1.1"
+		size_t methodEnd = header.find(' ');
+		size_t targetEnd = methodEnd == std::string::npos ? std::string::npos : header.find(' ', methodEnd + 1);
+
+		if (targetEnd != std::string::npos && header.find("\r\n\r\n") != std::string::npos)
+		{
+			HttpRequest request;
+			request.method = header.substr(0, methodEnd);
+
+			std::string target = header.substr(methodEnd + 1, targetEnd - methodEnd - 1);
+			size_t queryStart = target.find('?');
+
+			request.path = DecodeUrl(target.substr(0, queryStart));
+			request.query = queryStart == std::string::npos ? "" : target.substr(queryStart + 1);
+
+			if (request.method != "GET")
+			{
+				response = HttpResponse{ 405, "text/plain", "Only GET is supported\n" };
+			}
+			else
+			{
+				try
+				{
+					response = handler(request);
+				}
+				catch (std::exception& ex)
+				{
+					response = HttpResponse{ 500, "text/plain", std::string(ex.what()) + "\n" };
+				}
+			}
+		}
+
+		//Any origin, so web pages served from elsewhere can show the tiles
+		std::string responseHeader = "HTTP/1.1 " + std::to_string(response.status) + " " + GetHttpStatusText(response.status) + "\r\n";
+		responseHeader += "Content-Type: " + response.contentType + "\r\n";
+		responseHeader += "Content-Length: " + std::to_string(response.body.size()) + "\r\n";
+		responseHeader += "Access-Control-Allow-Origin: *\r\n";
+		responseHeader += "Connection: close\r\n\r\n";
+
+		if (SendAll(socket, responseHeader.data(), responseHeader.size()))
+			SendAll(socket, response.body.data(), response.body.size());
+
+		CloseHttpSocket(socket);
+	}
+	#pragma endregion
+
+	void RunHttpServer(int port, const std::function<HttpResponse(const HttpRequest&)>& handler)
+	{
+#ifdef _WIN32
+		WSADATA data;
+
+		if (WSAStartup(MAKEWORD(2, 2), &data) != 0)
+			throw std::runtime_error("Failed to start winsock");
+#else
+		//A client closing its connection early would stop the process
+		std::signal(SIGPIPE, SIG_IGN);
+#endif
+
+		HttpSocket listener = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+
+		if (listener == INVALID_HTTP_SOCKET)
+			throw std::runtime_error("Failed to create a socket");
+
+		int reuse = 1;
+		setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, (const char*)&reuse, sizeof(reuse));
+
+		sockaddr_in address = {};
+		address.sin_family = AF_INET;
+		address.sin_port = htons((unsigned short)port);
+		address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+		if (bind(listener, (const sockaddr*)&address, sizeof(address)) != 0 || listen(listener, SOMAXCONN) != 0)
+		{
+			CloseHttpSocket(listener);
+			throw std::runtime_error("Failed to listen on port " + std::to_string(port));
+		}
+
+		//A slot per connection thread, a burst of connections waits in the listen queue instead of starting a thread each
+		std::counting_semaphore<> connectionSlots(HTTP_MAX_CONNECTIONS);
+
+		while (true)
+		{
+			connectionSlots.acquire();
+
+			HttpSocket connection = accept(listener, nullptr, nullptr);
+
+			if (connection == INVALID_HTTP_SOCKET)
+			{
+				connectionSlots.release();
+				continue;
+			}
+
+			std::thread([connection, &handler, &connectionSlots]()
+			{
+				HandleHttpConnection(connection, handler);
+				connectionSlots.release();
+			}).detach();
+		}
+	}
+}
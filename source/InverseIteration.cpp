@@ -0,0 +1,156 @@
+#include "InverseIteration.h"
+
+#include <cmath>
+#include <atomic>
+#include <vector>
+#include <random>
+#include <algorithm>
+
+#include "raylib.h"
+
+namespace Explorer
+{
+	//Cells per side of the grid that counts visits outside of the view, so branches leaving the view are cut too
+	const int INVERSE_ITERATION_OUTSIDE_GRID_SIZE = 1024;
+
+	//Random preimages taken from the starting point before walking the tree, which lands it (very close to) on the julia set
+	const int INVERSE_ITERATION_WARM_UP_STEPS = 64;
+
+	bool FractalSupportsInverseIteration(const FractalParameters& parameters)
+	{
+		return parameters.type == FRACTAL_JULIA && std::fmod(parameters.power, 1.0f) == 0.0f && parameters.power >= 2.0f;
+	}
+
+	//The power-th roots of z - c, the preimages of z under z^power + c
+	inline void GetPreimages(double zX, double zY, double cX, double cY, int power, double* preimagesX, double* preimagesY)
+	{
+		double wX = zX - cX;
+		double wY = zY - cY;
+
+		double magnitude = std::pow(wX * wX + wY * wY, 0.5 / (double)power);
+		double angle = std::atan2(wY, wX) / (double)power;
+
+		for (int i = 0; i < power; i++)
+		{
+			double branchAngle = angle + 2.0 * (double)PI * (double)i / (double)power;
+
+			preimagesX[i] = magnitude * std::cos(branchAngle);
+			preimagesY[i] = magnitude * std::sin(branchAngle);
+		}
+	}
+
+	long long RenderJuliaInverseIteration(const FractalParameters& parameters, const CPUFractalView& view, Color* pixels, int width, int height, int visitCap)
+	{
+		std::fill(pixels, pixels + (size_t)width * (size_t)height, BLACK);
+
+		if (!FractalSupportsInverseIteration(parameters) || width <= 0 || height <= 0)
+			return 0;
+
+		int power = (int)parameters.power;
+
+		double cX = (double)parameters.c.x;
+		double cY = (double)parameters.c.y;
+
+		//The julia set is within |z| <= max(|c|, 2^(1 / (power - 1)))
+		double radius = std::max(std::sqrt(cX * cX + cY * cY), std::pow(2.0, 1.0 / (double)(power - 1)));
+		double outsideCellSize = 2.0 * radius / (double)INVERSE_ITERATION_OUTSIDE_GRID_SIZE;
+
+		//Visit counts shared by all threads
+		std::vector<std::atomic<int>> viewVisits((size_t)width * (size_t)height);
+		std::vector<std::atomic<int>> outsideVisits((size_t)INVERSE_ITERATION_OUTSIDE_GRID_SIZE * (size_t)INVERSE_ITERATION_OUTSIDE_GRID_SIZE);
+
+		//Counts a visit to z, false if its pixel (or cell outside the view) already had visitCap visits
+		auto visit = [&](double zX, double zY)
+		{
+			double pixelX = std::floor((zX - view.originX) / view.stepX + 0.5);
+			double pixelY = std::floor((zY - view.originY) / view.stepY + 0.5);
+
+			if (pixelX >= 0.0 && pixelX < (double)width && pixelY >= 0.0 && pixelY < (double)height)
+				return viewVisits[(size_t)pixelY * (size_t)width + (size_t)pixelX].fetch_add(1, std::memory_order_relaxed) < visitCap;
+
+			int cellX = std::clamp((int)((zX + radius) / outsideCellSize), 0, INVERSE_ITERATION_OUTSIDE_GRID_SIZE - 1);
+			int cellY = std::clamp((int)((zY + radius) / outsideCellSize), 0, INVERSE_ITERATION_OUTSIDE_GRID_SIZE - 1);
+
+			return outsideVisits[(size_t)cellY * (size_t)INVERSE_ITERATION_OUTSIDE_GRID_SIZE + (size_t)cellX].fetch_add(1, std::memory_order_relaxed) < visitCap;
+		};
+
+		//Each thread walks its own tree from its own random starting point, the shared visit counts cut the parts another thread already walked
+		long long numPoints = RunOnAllThreads(GetCPUFractalNumThreads(), [&](int thread)
+		{
+			std::mt19937_64 random((unsigned long long)thread + 1);
+			std::uniform_real_distribution<double> startDistribution(-1.0, 1.0);
+			std::uniform_int_distribution<int> branchDistribution(0, power - 1);
+
+			std::vector<double> preimagesX(power);
+			std::vector<double> preimagesY(power);
+
+			double zX = startDistribution(random);
+			double zY = startDistribution(random);
+
+			for (int step = 0; step < INVERSE_ITERATION_WARM_UP_STEPS; step++)
+			{
+				GetPreimages(zX, zY, cX, cY, power, preimagesX.data(), preimagesY.data());
+
+				int branch = branchDistribution(random);
+				zX = preimagesX[branch];
+				zY = preimagesY[branch];
+			}
+
+			//Depth first, so the stack holds at most (power - 1) * depth points
+			struct TreePoint
+			{
+				double x;
+				double y;
+				int depth;
+			};
+
+			std::vector<TreePoint> stack;
+			stack.push_back(TreePoint{ zX, zY, 0 });
+
+			long long threadPoints = 0;
+
+			while (!stack.empty())
+			{
+				TreePoint point = stack.back();
+				stack.pop_back();
+
+				threadPoints++;
+
+				if (!visit(point.x, point.y) || point.depth >= parameters.maxIterations)
+					continue;
+
+				GetPreimages(point.x, point.y, cX, cY, power, preimagesX.data(), preimagesY.data());
+
+				//Random branch order, so the threads spread out over the set
+				int firstBranch = branchDistribution(random);
+
+				for (int i = 0; i < power; i++)
+				{
+					int branch = (firstBranch + i) % power;
+					stack.push_back(TreePoint{ preimagesX[branch], preimagesY[branch], point.depth + 1 });
+				}
+			}
+
+			return threadPoints;
+		});
+
+		//Brighter the more often a pixel was visited
+		RunOnAllThreads(height, [&](int row)
+		{
+			for (int column = 0; column < width; column++)
+			{
+				int visits = viewVisits[(size_t)row * (size_t)width + (size_t)column].load(std::memory_order_relaxed);
+
+				if (visits == 0)
+					continue;
+
+				unsigned char brightness = (unsigned char)(127 + (128 * std::min(visits, visitCap)) / visitCap);
+				pixels[(size_t)row * (size_t)width + (size_t)column] = Color{ brightness, brightness, brightness, 255 };
+			}
+
+			return 0ll;
+		});
+
+		return numPoints;
+	}
+}
@@ -0,0 +1,136 @@
+#include "JuliaAtlas.h"
+
+#include <cmath>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+
+#include "raylib.h"
+
+#include "ParameterSweep.h"
+
+namespace Explorer
+{
+	//The parameters every thumbnail shares, the ones that make the atlas render again when they change
+	FractalParameters GetJuliaAtlasBaseParameters(const FractalParameters& parameters)
+	{
+		FractalParameters baseParameters = parameters;
+
+		baseParameters.type = FRACTAL_JULIA;
+		baseParameters.position = Vector2{ 0.0f, 0.0f };
+		baseParameters.zoom = JULIA_ATLAS_THUMBNAIL_ZOOM;
+		baseParameters.c = Vector2{ 0.0f, 0.0f };
+		baseParameters.maxIterations = std::min(parameters.maxIterations, JULIA_ATLAS_MAX_ITERATIONS);
+
+		return baseParameters;
+	}
+
+	Vector2 JuliaAtlas::GetOrigin() const
+	{
+		float sheetWidth = (float)(numColumns * (JULIA_ATLAS_CELL_SIZE + JULIA_ATLAS_SPACING) + JULIA_ATLAS_SPACING);
+		float sheetHeight = (float)(numRows * (JULIA_ATLAS_CELL_SIZE + JULIA_ATLAS_SPACING) + JULIA_ATLAS_SPACING);
+
+		return Vector2{ std::floor(((float)width - sheetWidth) / 2.0f), std::floor(((float)height - sheetHeight) / 2.0f) };
+	}
+
+	void JuliaAtlas::Update(const FractalParameters& newParameters, int newWidth, int newHeight)
+	{
+		FractalParameters baseParameters = GetJuliaAtlasBaseParameters(newParameters);
+
+		if (image.data != NULL && newWidth == width && newHeight == height && AreFractalParametersEqual(baseParameters, parameters))
+			return;
+
+		Unload();
+
+		parameters = baseParameters;
+		width = newWidth;
+		height = newHeight;
+
+		//As many cells as fit on screen
+		numColumns = std::max((width - JULIA_ATLAS_SPACING) / (JULIA_ATLAS_CELL_SIZE + JULIA_ATLAS_SPACING), 1);
+		numRows = std::max((height - JULIA_ATLAS_SPACING) / (JULIA_ATLAS_CELL_SIZE + JULIA_ATLAS_SPACING), 1);
+
+		std::vector<FractalParameters> cells(numColumns * numRows, parameters);
+
+		for (int cell = 0; cell < (int)cells.size(); cell++)
+			cells[cell].c = GetCellC(cell);
+
+		auto startTime = std::chrono::steady_clock::now();
+
+		std::vector<ContactSheetCellStats> cellStats;
+		image = RenderContactSheet(cells, ContactSheetSettings{ numColumns, JULIA_ATLAS_CELL_SIZE, JULIA_ATLAS_CELL_SIZE, JULIA_ATLAS_SPACING, false }, cellStats);
+
+		seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+		texture = LoadTextureFromImage(image);
+	}
+
+	void JuliaAtlas::Draw() const
+	{
+		if (texture.id == 0)
+			return;
+
+		DrawTextureV(texture, GetOrigin(), WHITE);
+	}
+
+	int JuliaAtlas::GetCellAt(Vector2 screenPosition) const
+	{
+		Vector2 origin = GetOrigin();
+
+		int column = (int)std::floor((screenPosition.x - origin.x - (float)JULIA_ATLAS_SPACING) / (float)(JULIA_ATLAS_CELL_SIZE + JULIA_ATLAS_SPACING));
+		int row = (int)std::floor((screenPosition.y - origin.y - (float)JULIA_ATLAS_SPACING) / (float)(JULIA_ATLAS_CELL_SIZE + JULIA_ATLAS_SPACING));
+
+		if (column < 0 || column >= numColumns || row < 0 || row >= numRows)
+			return -1;
+
+		return row * numColumns + column;
+	}
+
+	Rectangle JuliaAtlas::GetCellRect(int cell) const
+	{
+		Vector2 origin = GetOrigin();
+
+		return Rectangle{
+			origin.x + (float)(JULIA_ATLAS_SPACING + (cell % numColumns) * (JULIA_ATLAS_CELL_SIZE + JULIA_ATLAS_SPACING)),
+			origin.y + (float)(JULIA_ATLAS_SPACING + (cell / numColumns) * (JULIA_ATLAS_CELL_SIZE + JULIA_ATLAS_SPACING)),
+			(float)JULIA_ATLAS_CELL_SIZE,
+			(float)JULIA_ATLAS_CELL_SIZE
+		};
+	}
+
+	Vector2 JuliaAtlas::GetCellC(int cell) const
+	{
+		//c at the cell's center, so the atlas is laid out like the Mandelbrot set it covers
+		float u = ((float)(cell % numColumns) + 0.5f) / (float)numColumns;
+		float v = ((float)(cell / numColumns) + 0.5f) / (float)numRows;
+
+		return Vector2{ JULIA_ATLAS_C_MIN.x + (JULIA_ATLAS_C_MAX.x - JULIA_ATLAS_C_MIN.x) * u, JULIA_ATLAS_C_MAX.y - (JULIA_ATLAS_C_MAX.y - JULIA_ATLAS_C_MIN.y) * v };
+	}
+
+	int JuliaAtlas::GetNumColumns() const
+	{
+		return numColumns;
+	}
+
+	int JuliaAtlas::GetNumRows() const
+	{
+		return numRows;
+	}
+
+	double JuliaAtlas::GetSeconds() const
+	{
+		return seconds;
+	}
+
+	void JuliaAtlas::Unload()
+	{
+		if (image.data != NULL)
+			UnloadImage(image);
+
+		if (texture.id != 0)
+			UnloadTexture(texture);
+
+		image = Image{ 0 };
+		texture = Texture2D{ 0 };
+	}
+}
@@ -0,0 +1,198 @@
+#include "ParameterSweep.h"
+
+#include <cmath>
+#include <chrono>
+#include <algorithm>
+
+#include "raylib.h"
+
+#include "CPUFractal.h"
+
+namespace Explorer
+{
+	#pragma region Parameters
+	const char* GetSweepParameterName(SweepParameter parameter)
+	{
+		switch (parameter)
+		{
+			case SWEEP_POWER:
+				return "power";
+			case SWEEP_C_REAL:
+				return "c.x";
+			case SWEEP_C_IMAGINARY:
+				return "c.y";
+			case SWEEP_A_REAL:
+				return "a.x";
+			case SWEEP_A_IMAGINARY:
+				return "a.y";
+			case SWEEP_MAX_ITERATIONS:
+				return "iterations";
+			case SWEEP_ZOOM:
+				return "zoom";
+			default:
+				return "none";
+		}
+	}
+
+	SweepParameter GetSweepParameterByName(const std::string& name)
+	{
+		for (int i = 0; i < NUM_SWEEP_PARAMETERS; i++)
+		{
+			if (name == GetSweepParameterName((SweepParameter)i))
+				return (SweepParameter)i;
+		}
+
+		return SWEEP_NONE;
+	}
+
+	double GetSweepParameterValue(const FractalParameters& parameters, SweepParameter parameter)
+	{
+		switch (parameter)
+		{
+			case SWEEP_POWER:
+				return (double)parameters.power;
+			case SWEEP_C_REAL:
+				return (double)parameters.c.x;
+			case SWEEP_C_IMAGINARY:
+				return (double)parameters.c.y;
+			case SWEEP_A_REAL:
+				return (double)parameters.a.x;
+			case SWEEP_A_IMAGINARY:
+				return (double)parameters.a.y;
+			case SWEEP_MAX_ITERATIONS:
+				return (double)parameters.maxIterations;
+			case SWEEP_ZOOM:
+				return (double)parameters.zoom;
+			default:
+				return 0.0;
+		}
+	}
+
+	void SetSweepParameterValue(FractalParameters& parameters, SweepParameter parameter, double value)
+	{
+		switch (parameter)
+		{
+			case SWEEP_POWER:
+				parameters.power = (float)value;
+				break;
+			case SWEEP_C_REAL:
+				parameters.c.x = (float)value;
+				break;
+			case SWEEP_C_IMAGINARY:
+				parameters.c.y = (float)value;
+				break;
+			case SWEEP_A_REAL:
+				parameters.a.x = (float)value;
+				break;
+			case SWEEP_A_IMAGINARY:
+				parameters.a.y = (float)value;
+				break;
+			case SWEEP_MAX_ITERATIONS:
+				parameters.maxIterations = std::max((int)std::lround(value), 1);
+				break;
+			case SWEEP_ZOOM:
+				parameters.zoom = (float)value;
+				break;
+			default:
+				break;
+		}
+	}
+
+	double GetSweepAxisValue(const SweepAxis& axis, int index)
+	{
+		if (axis.count <= 1)
+			return axis.from;
+
+		return axis.from + (axis.to - axis.from) * (double)index / (double)(axis.count - 1);
+	}
+
+	std::vector<FractalParameters> GetParameterSweepGrid(const FractalParameters& base, const SweepAxis& columns, const SweepAxis& rows)
+	{
+		std::vector<FractalParameters> cells;
+
+		int numColumns = std::max(columns.count, 1);
+		int numRows = std::max(rows.count, 1);
+
+		for (int row = 0; row < numRows; row++)
+		{
+			for (int column = 0; column < numColumns; column++)
+			{
+				FractalParameters parameters = base;
+
+				SetSweepParameterValue(parameters, rows.parameter, GetSweepAxisValue(rows, row));
+				SetSweepParameterValue(parameters, columns.parameter, GetSweepAxisValue(columns, column));
+
+				cells.push_back(parameters);
+			}
+		}
+
+		return cells;
+	}
+	#pragma endregion
+
+	#pragma region Rendering
+	//Rows of a cell rendered by a thread at a time, small enough for cells to be shared by all threads
+	const int CONTACT_SHEET_BAND_HEIGHT = 16;
+
+	Image RenderContactSheet(const std::vector<FractalParameters>& cells, const ContactSheetSettings& settings, std::vector<ContactSheetCellStats>& cellStats)
+	{
+		int numCells = (int)cells.size();
+		int numColumns = std::max(std::min(settings.columns, numCells), 1);
+		int numRows = (numCells + numColumns - 1) / numColumns;
+
+		int width = numColumns * settings.cellWidth + (numColumns + 1) * settings.spacing;
+		int height = numRows * settings.cellHeight + (numRows + 1) * settings.spacing;
+
+		Image sheet = GenImageColor(width, height, Color{ 24, 24, 24, 255 });
+		Color* sheetPixels = (Color*)sheet.data;
+
+		cellStats.assign(numCells, ContactSheetCellStats{ 0.0, 0 });
+
+		if (numCells == 0 || settings.cellWidth <= 0 || settings.cellHeight <= 0)
+			return sheet;
+
+		std::vector<CPUFractalView> views(numCells);
+
+		for (int cell = 0; cell < numCells; cell++)
+			views[cell] = GetCPUFractalView(cells[cell], settings.cellWidth, settings.cellHeight, false, settings.flipY);
+
+		//Every band of every cell, cell by cell, so a cell's bands are mostly rendered at the same time
+		int bandsPerCell = (settings.cellHeight + CONTACT_SHEET_BAND_HEIGHT - 1) / CONTACT_SHEET_BAND_HEIGHT;
+
+		std::vector<double> bandSeconds((size_t)numCells * (size_t)bandsPerCell);
+		std::vector<long long> bandIterations((size_t)numCells * (size_t)bandsPerCell);
+
+		RunOnAllThreads(numCells * bandsPerCell, [&](int item)
+		{
+			int cell = item / bandsPerCell;
+			int band = item % bandsPerCell;
+
+			int cellX = settings.spacing + (cell % numColumns) * (settings.cellWidth + settings.spacing);
+			int cellY = settings.spacing + (cell / numColumns) * (settings.cellHeight + settings.spacing);
+
+			int bandY = band * CONTACT_SHEET_BAND_HEIGHT;
+			int bandHeight = std::min(CONTACT_SHEET_BAND_HEIGHT, settings.cellHeight - bandY);
+
+			//The cell's pixel (0, 0) in the sheet, rows are the sheet's width apart
+			Color* cellPixels = sheetPixels + (size_t)cellY * (size_t)width + (size_t)cellX;
+
+			auto startTime = std::chrono::steady_clock::now();
+
+			long long iterations = RenderFractalRectCPU(cells[cell], views[cell], cellPixels, width, 0, bandY, settings.cellWidth, bandHeight);
+
+			bandSeconds[item] = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+			bandIterations[item] = iterations;
+
+			return iterations;
+		});
+
+		for (int item = 0; item < numCells * bandsPerCell; item++)
+		{
+			cellStats[item / bandsPerCell].threadSeconds += bandSeconds[item];
+			cellStats[item / bandsPerCell].iterations += bandIterations[item];
+		}
+
+		return sheet;
+	}
+	#pragma endregion
+}
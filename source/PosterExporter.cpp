@@ -0,0 +1,531 @@
+#include "PosterExporter.h"
+
+#ifndef PLATFORM_WEB
+
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <stdexcept>
+#include <algorithm>
+#include <filesystem>
+
+#include "raylib.h"
+
+#include "CPUFractal.h"
+#include "RenderJournal.h"
+#include "Profiler.h"
+
+namespace Explorer
+{
+	#pragma region TIFF
+	const unsigned short TIFF_SHORT = 3;
+	const unsigned short TIFF_LONG = 4;
+	const unsigned short TIFF_LONG8 = 16;
+
+	const unsigned short TIFF_COMPRESSION_DEFLATE = 8;
+	const unsigned short TIFF_PHOTOMETRIC_RGB = 2;
+	const unsigned short TIFF_PLANAR_CONTIGUOUS = 1;
+	const unsigned short TIFF_PREDICTOR_HORIZONTAL = 2;
+
+	//Files that might not fit 32 bit offsets are written as BigTIFF
+	const unsigned long long TIFF_MAX_CLASSIC_SIZE = 0xF0000000ull;
+
+	//Little endian TIFF (or BigTIFF) written front to back: header, strips, then the strip tables & the IFD
+	struct PosterFile
+	{
+		std::ofstream stream;
+		bool bigTiff;
+
+		void Write(unsigned long long value, int bytes)
+		{
+			for (int i = 0; i < bytes; i++)
+				stream.put((char)((value >> (8 * i)) & 0xFF));
+		}
+
+		//Offsets are 4 bytes, 8 in BigTIFF
+		void WriteOffset(unsigned long long value)
+		{
+			Write(value, bigTiff ? 8 : 4);
+		}
+
+		unsigned long long Position()
+		{
+			return (unsigned long long)stream.tellp();
+		}
+
+		//value is the value itself if it fits the entry (left justified, little endian), otherwise its offset
+		void WriteEntry(unsigned short tag, unsigned short type, unsigned long long count, unsigned long long value)
+		{
+			Write(tag, 2);
+			Write(type, 2);
+			WriteOffset(count);
+			WriteOffset(value);
+		}
+	};
+
+	//Strips are zlib streams: raylib's CompressData (raw deflate) between a zlib header & an adler-32 checksum
+	std::vector<unsigned char> CompressPosterStrip(const std::vector<unsigned char>& data)
+	{
+		unsigned int a = 1;
+		unsigned int b = 0;
+
+		for (unsigned char byte : data)
+		{
+			a = (a + byte) % 65521;
+			b = (b + a) % 65521;
+		}
+
+		int compressedSize = 0;
+		unsigned char* compressed = CompressData(data.data(), (int)data.size(), &compressedSize);
+
+		if (compressed == NULL)
+			throw std::runtime_error("Failed to compress a poster strip");
+
+		std::vector<unsigned char> strip;
+		strip.reserve((size_t)compressedSize + 6);
+
+		strip.push_back(0x78);
+		strip.push_back(0x01);
+		strip.insert(strip.end(), compressed, compressed + compressedSize);
+
+		MemFree(compressed);
+
+		unsigned int adler = (b << 16) | a;
+
+		for (int i = 3; i >= 0; i--)
+			strip.push_back((unsigned char)((adler >> (8 * i)) & 0xFF));
+
+		return strip;
+	}
+
+	//RGB rows of pixels with the horizontal predictor applied (every sample minus the one of the pixel before it), which compresses smooth coloring much better
+	std::vector<unsigned char> GetPosterStripData(const Color* pixels, int width, int numRows)
+	{
+		std::vector<unsigned char> data((size_t)width * (size_t)numRows * 3);
+
+		for (int row = 0; row < numRows; row++)
+		{
+			const Color* rowPixels = pixels + (size_t)row * (size_t)width;
+			unsigned char* rowData = data.data() + (size_t)row * (size_t)width * 3;
+
+			Color previous = Color{ 0, 0, 0, 255 };
+
+			for (int column = 0; column < width; column++)
+			{
+				Color pixel = rowPixels[column];
+
+				rowData[column * 3] = (unsigned char)(pixel.r - previous.r);
+				rowData[column * 3 + 1] = (unsigned char)(pixel.g - previous.g);
+				rowData[column * 3 + 2] = (unsigned char)(pixel.b - previous.b);
+
+				previous = pixel;
+			}
+		}
+
+		return data;
+	}
+	#pragma endregion
+
+	unsigned long long GetFractalPosterHash(const FractalParameters& parameters, int width, int height, bool flipX, bool flipY)
+	{
+		unsigned long long hash = HashFractalParameters(parameters);
+
+		hash = HashFractalValue(hash, (unsigned long long)width);
+		hash = HashFractalValue(hash, (unsigned long long)height);
+		hash = HashFractalValue(hash, (flipX ? 1ull : 0ull) | (flipY ? 2ull : 0ull));
+
+		//The band layout, a journal of other bands can't be resumed
+		hash = HashFractalValue(hash, (unsigned long long)POSTER_STRIP_HEIGHT);
+		hash = HashFractalValue(hash, (unsigned long long)POSTER_BAND_PIXELS);
+
+		return hash;
+	}
+
+	//Band tiles in the journal: the offset & byte count of each of the band's strips
+	std::string GetPosterBandJournalData(const std::vector<unsigned long long>& stripOffsets, const std::vector<unsigned long long>& stripByteCounts, int firstStrip)
+	{
+		std::string data;
+
+		for (size_t strip = (size_t)firstStrip; strip < stripOffsets.size(); strip++)
+			data += (strip > (size_t)firstStrip ? " " : "") + std::to_string(stripOffsets[strip]) + " " + std::to_string(stripByteCounts[strip]);
+
+		return data;
+	}
+
+	bool ExportFractalPoster(const FractalParameters& parameters, int width, int height, bool flipX, bool flipY, const std::string& fileName, const std::function<bool(int rowsWritten)>& progress)
+	{
+		if (width <= 0 || height <= 0 || width > POSTER_MAX_SIZE || height > POSTER_MAX_SIZE)
+			throw std::runtime_error("Poster size " + std::to_string(width) + "x" + std::to_string(height) + " is out of range");
+
+		//Bands of whole strips
+		int bandHeight = std::max(POSTER_STRIP_HEIGHT, (int)(POSTER_BAND_PIXELS / width) / POSTER_STRIP_HEIGHT * POSTER_STRIP_HEIGHT);
+		bandHeight = std::min(bandHeight, (height + POSTER_STRIP_HEIGHT - 1) / POSTER_STRIP_HEIGHT * POSTER_STRIP_HEIGHT);
+
+		int numStrips = (height + POSTER_STRIP_HEIGHT - 1) / POSTER_STRIP_HEIGHT;
+		int numBands = (height + bandHeight - 1) / bandHeight;
+
+		std::vector<unsigned long long> stripOffsets;
+		std::vector<unsigned long long> stripByteCounts;
+
+		PosterFile file;
+		file.bigTiff = (unsigned long long)width * (unsigned long long)height * 3ull >= TIFF_MAX_CLASSIC_SIZE;
+
+		unsigned long long ifdOffsetPosition = file.bigTiff ? 8 : 4;
+
+		//Every band is a tile of the journal, the finished bands at the start of a poster that was stopped are kept
+		std::string journalFileName = GetRenderJournalFileName(fileName);
+
+		if (!std::filesystem::exists(fileName))
+		{
+			std::error_code errorCode;
+			std::filesystem::remove(journalFileName, errorCode);
+		}
+
+		RenderJournal journal;
+		journal.Open(journalFileName, GetFractalPosterHash(parameters, width, height, flipX, flipY));
+
+		int firstBand = 0;
+
+		while (firstBand < numBands && journal.IsTileFinished(firstBand))
+		{
+			std::istringstream data(journal.GetTileData(firstBand));
+
+			int bandRows = std::min(bandHeight, height - firstBand * bandHeight);
+			int numBandStrips = (bandRows + POSTER_STRIP_HEIGHT - 1) / POSTER_STRIP_HEIGHT;
+
+			std::vector<unsigned long long> bandData;
+			unsigned long long value = 0;
+
+			while (data >> value)
+				bandData.push_back(value);
+
+			//Not a band of this layout after all, it's rendered again
+			if ((int)bandData.size() != 2 * numBandStrips)
+				break;
+
+			for (int strip = 0; strip < numBandStrips; strip++)
+			{
+				stripOffsets.push_back(bandData[2 * strip]);
+				stripByteCounts.push_back(bandData[2 * strip + 1]);
+			}
+
+			firstBand++;
+		}
+
+		//The poster was cut short (or changed) after the journal was written
+		if (firstBand > 0 && std::filesystem::file_size(fileName) < stripOffsets.back() + stripByteCounts.back())
+		{
+			firstBand = 0;
+
+			stripOffsets.clear();
+			stripByteCounts.clear();
+		}
+
+		if (firstBand > 0)
+		{
+			//Cut off whatever was written after the last finished band
+			std::filesystem::resize_file(fileName, stripOffsets.back() + stripByteCounts.back());
+
+			file.stream.open(fileName, std::ios::binary | std::ios::in | std::ios::out);
+			file.stream.seekp(0, std::ios::end);
+
+			if (!file.stream)
+				throw std::runtime_error("Failed to open " + fileName);
+
+			if (!progress(std::min(firstBand * bandHeight, height)))
+				return false;
+		}
+		else
+		{
+			file.stream.open(fileName, std::ios::binary | std::ios::trunc);
+
+			if (!file.stream)
+				throw std::runtime_error("Failed to open " + fileName);
+
+			//Header, the IFD's offset is filled in at the end
+			file.Write('I', 1);
+			file.Write('I', 1);
+
+			if (file.bigTiff)
+			{
+				file.Write(43, 2);
+				file.Write(8, 2);
+				file.Write(0, 2);
+			}
+			else
+			{
+				file.Write(42, 2);
+			}
+
+			file.WriteOffset(0);
+		}
+
+		std::vector<Color> band((size_t)width * (size_t)bandHeight);
+		std::vector<std::vector<unsigned char>> bandStrips(bandHeight / POSTER_STRIP_HEIGHT);
+
+		CPUFractalView view = GetCPUFractalView(parameters, width, height, flipX, flipY);
+
+		for (int bandIndex = firstBand; bandIndex < numBands; bandIndex++)
+		{
+			int bandY = bandIndex * bandHeight;
+			int bandRows = std::min(bandHeight, height - bandY);
+
+			//The poster's view moved down to the band
+			CPUFractalView bandView = view;
+			bandView.originY += (double)bandY * view.stepY;
+
+			RenderFractalCPU(parameters, bandView, band.data(), width, bandRows);
+
+			int numBandStrips = (bandRows + POSTER_STRIP_HEIGHT - 1) / POSTER_STRIP_HEIGHT;
+
+			RunOnAllThreads(numBandStrips, [&](int strip)
+			{
+				int stripRows = std::min(POSTER_STRIP_HEIGHT, bandRows - strip * POSTER_STRIP_HEIGHT);
+				const Color* stripPixels = band.data() + (size_t)strip * POSTER_STRIP_HEIGHT * (size_t)width;
+
+				bandStrips[strip] = CompressPosterStrip(GetPosterStripData(stripPixels, width, stripRows));
+
+				return 0ll;
+			});
+
+			int firstBandStrip = (int)stripOffsets.size();
+
+			for (int strip = 0; strip < numBandStrips; strip++)
+			{
+				stripOffsets.push_back(file.Position());
+				stripByteCounts.push_back(bandStrips[strip].size());
+
+				file.stream.write((const char*)bandStrips[strip].data(), (std::streamsize)bandStrips[strip].size());
+			}
+
+			//On disk before it's in the journal
+			file.stream.flush();
+
+			if (!file.stream)
+				throw std::runtime_error("Failed to write to " + fileName);
+
+			journal.FinishTile(bandIndex, GetPosterBandJournalData(stripOffsets, stripByteCounts, firstBandStrip));
+
+			if (!progress(bandY + bandRows))
+				return false;
+		}
+
+		//Strip tables, unless a single value fits in the entry
+		auto writeTable = [&](const std::vector<unsigned long long>& values)
+		{
+			if (numStrips == 1)
+				return values[0];
+
+			unsigned long long offset = file.Position();
+
+			for (unsigned long long value : values)
+				file.WriteOffset(value);
+
+			return offset;
+		};
+
+		unsigned long long stripOffsetsValue = writeTable(stripOffsets);
+		unsigned long long stripByteCountsValue = writeTable(stripByteCounts);
+
+		//Bits per sample (8, 8, 8) only fits in a BigTIFF entry
+		unsigned long long bitsPerSampleValue = 8ull | (8ull << 16) | (8ull << 32);
+
+		if (!file.bigTiff)
+		{
+			bitsPerSampleValue = file.Position();
+
+			for (int i = 0; i < 3; i++)
+				file.Write(8, 2);
+		}
+
+		//IFD on a word boundary, entries sorted by tag
+		if (file.Position() % 2 != 0)
+			file.Write(0, 1);
+
+		unsigned long long ifdOffset = file.Position();
+		unsigned short tableType = file.bigTiff ? TIFF_LONG8 : TIFF_LONG;
+
+		const int NUM_IFD_ENTRIES = 11;
+		file.Write(NUM_IFD_ENTRIES, file.bigTiff ? 8 : 2);
+
+		file.WriteEntry(256, TIFF_LONG, 1, (unsigned long long)width);
+		file.WriteEntry(257, TIFF_LONG, 1, (unsigned long long)height);
+		file.WriteEntry(258, TIFF_SHORT, 3, bitsPerSampleValue);
+		file.WriteEntry(259, TIFF_SHORT, 1, TIFF_COMPRESSION_DEFLATE);
+		file.WriteEntry(262, TIFF_SHORT, 1, TIFF_PHOTOMETRIC_RGB);
+		file.WriteEntry(273, tableType, (unsigned long long)numStrips, stripOffsetsValue);
+		file.WriteEntry(277, TIFF_SHORT, 1, 3);
+		file.WriteEntry(278, TIFF_LONG, 1, POSTER_STRIP_HEIGHT);
+		file.WriteEntry(279, tableType, (unsigned long long)numStrips, stripByteCountsValue);
+		file.WriteEntry(284, TIFF_SHORT, 1, TIFF_PLANAR_CONTIGUOUS);
+		file.WriteEntry(317, TIFF_SHORT, 1, TIFF_PREDICTOR_HORIZONTAL);
+
+		//No next IFD
+		file.WriteOffset(0);
+
+		file.stream.seekp((std::streamoff)ifdOffsetPosition);
+		file.WriteOffset(ifdOffset);
+
+		file.stream.close();
+
+		if (!file.stream)
+			throw std::runtime_error("Failed to write to " + fileName);
+
+		journal.Remove();
+
+		return true;
+	}
+
+	#pragma region Viewer
+	std::thread posterThread;
+
+	std::atomic<bool> posterExporting = false;
+	std::atomic<bool> posterCancelled = false;
+
+	//Stopped without deleting it, to be resumed next time
+	std::atomic<bool> posterStopping = false;
+
+	std::atomic<int> posterRowsWritten = 0;
+	int posterHeight = 0;
+
+	std::mutex posterNotificationMutex;
+	std::vector<Notification> posterNotifications;
+
+	//A poster of the same render that was stopped before it was finished (the process was closed or crashed), so it's resumed,
+	//otherwise the first fractal_poster-N.tiff that doesn't exist yet
+	std::filesystem::path GetNextPosterPath(unsigned long long posterHash)
+	{
+		std::filesystem::path fractalScreenshotsPath = std::filesystem::absolute(GetWorkingDirectory()).append("Fractal_Screenshots").make_preferred();
+
+		if (!std::filesystem::exists(fractalScreenshotsPath) && !std::filesystem::create_directories(fractalScreenshotsPath))
+			throw std::runtime_error("Failed to create fractal screenshots directory " + fractalScreenshotsPath.string());
+
+		for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(fractalScreenshotsPath))
+		{
+			std::string journalFileName = entry.path().string();
+			std::string posterFileName = journalFileName.substr(0, journalFileName.size() - GetRenderJournalFileName("").size());
+
+			if (journalFileName == GetRenderJournalFileName(posterFileName) && posterFileName.ends_with(".tiff") && std::filesystem::exists(posterFileName) && IsRenderJournalOf(journalFileName, posterHash))
+				return std::filesystem::path(posterFileName);
+		}
+
+		for (int number = 1;; number++)
+		{
+			std::filesystem::path posterPath = std::filesystem::path(fractalScreenshotsPath).append("fractal_poster-" + std::to_string(number) + ".tiff");
+
+			if (!std::filesystem::exists(posterPath))
+				return posterPath;
+		}
+	}
+
+	void UpdatePosterThread(FractalParameters parameters, int width, int height, bool flipY)
+	{
+		PROFILE_THREAD("Poster export");
+		PROFILE_ZONE("Export poster");
+
+		Notification notification;
+		std::filesystem::path posterPath;
+
+		try
+		{
+			posterPath = GetNextPosterPath(GetFractalPosterHash(parameters, width, height, false, flipY));
+
+			bool finished = ExportFractalPoster(parameters, width, height, false, flipY, posterPath.string(), [](int rowsWritten)
+			{
+				posterRowsWritten = rowsWritten;
+				return !posterCancelled && !posterStopping;
+			});
+
+			if (finished)
+			{
+				notification = Notification{ "Exported " + std::to_string(width) + "x" + std::to_string(height) + " fractal poster to " + posterPath.string(), 5.0f, WHITE };
+			}
+			else if (posterCancelled)
+			{
+				std::filesystem::remove(posterPath);
+				std::filesystem::remove(GetRenderJournalFileName(posterPath.string()));
+
+				notification = Notification{ "Fractal poster cancelled", 3.0f, WHITE };
+			}
+		}
+		catch (std::exception& ex)
+		{
+			std::cout << ex.what() << std::endl;
+			notification = Notification{ ex };
+
+			//Kept with its journal to be resumed, if it got that far
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(posterNotificationMutex);
+			posterNotifications.push_back(notification);
+		}
+
+		posterExporting = false;
+	}
+
+	bool StartFractalPosterExport(const FractalParameters& parameters, int width, int height, bool flipY)
+	{
+		if (posterExporting)
+			return false;
+
+		//The last poster's thread is done
+		if (posterThread.joinable())
+			posterThread.join();
+
+		posterExporting = true;
+		posterCancelled = false;
+		posterStopping = false;
+		posterRowsWritten = 0;
+		posterHeight = height;
+
+		posterThread = std::thread(UpdatePosterThread, parameters, width, height, flipY);
+
+		return true;
+	}
+
+	bool IsFractalPosterExporting()
+	{
+		return posterExporting;
+	}
+
+	float GetFractalPosterProgress()
+	{
+		return posterHeight > 0 ? (float)posterRowsWritten / (float)posterHeight : 0.0f;
+	}
+
+	void CancelFractalPosterExport()
+	{
+		posterCancelled = true;
+	}
+
+	bool PollFractalPosterNotification(Notification& notification)
+	{
+		std::lock_guard<std::mutex> lock(posterNotificationMutex);
+
+		if (posterNotifications.empty())
+			return false;
+
+		notification = posterNotifications.front();
+		posterNotifications.erase(posterNotifications.begin());
+
+		return true;
+	}
+
+	void UnloadPosterExporter()
+	{
+		posterStopping = true;
+
+		if (posterThread.joinable())
+			posterThread.join();
+
+		posterNotifications.clear();
+	}
+	#pragma endregion
+}
+
+#endif
@@ -0,0 +1,64 @@
+#include "ProcessMemory.h"
+
+#include <string>
+#include <fstream>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace Explorer
+{
+	long long GetPeakResidentBytes()
+	{
+#if defined(_WIN32)
+		PROCESS_MEMORY_COUNTERS counters = {};
+
+		if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+			return -1;
+
+		return (long long)counters.PeakWorkingSetSize;
+#else
+#ifdef __linux__
+		//VmHWM follows ResetPeakResidentBytes, ru_maxrss doesn't
+		std::ifstream status("/proc/self/status");
+		std::string line;
+
+		while (std::getline(status, line))
+		{
+			if (line.rfind("VmHWM:", 0) == 0)
+				return std::stoll(line.substr(6)) * 1024ll;
+		}
+#endif
+
+		rusage usage = {};
+
+		if (getrusage(RUSAGE_SELF, &usage) != 0)
+			return -1;
+
+#ifdef __APPLE__
+		return (long long)usage.ru_maxrss;
+#else
+		//Kilobytes everywhere but macos
+		return (long long)usage.ru_maxrss * 1024ll;
+#endif
+#endif
+	}
+
+	bool ResetPeakResidentBytes()
+	{
+#ifdef __linux__
+		std::ofstream clearRefs("/proc/self/clear_refs");
+		clearRefs << "5";
+		clearRefs.flush();
+
+		return (bool)clearRefs;
+#else
+		return false;
+#endif
+	}
+}
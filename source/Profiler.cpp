@@ -0,0 +1,155 @@
+#include "Profiler.h"
+
+#include <map>
+#include <set>
+#include <mutex>
+#include <chrono>
+#include <vector>
+#include <fstream>
+#include <algorithm>
+#include <stdexcept>
+
+namespace Explorer
+{
+#ifdef EXPLORER_PROFILER
+	struct ProfileEvent
+	{
+		const char* name;
+		int thread;
+
+		long long startNanoseconds;
+		long long endNanoseconds;
+	};
+
+	//Guards everything below, zones are coarse enough (functions, render steps) that a lock per zone doesn't show
+	std::mutex profileMutex;
+
+	std::vector<ProfileEvent> profileEvents;
+	long long profileNumEvents = 0;
+
+	//Thread ids are small numbers, the ids of threads that ended are given out again (lowest first)
+	int profileNextThread = 0;
+	std::set<int> profileFreeThreads;
+	std::map<int, const char*> profileThreadNames;
+
+	//Trace time 0
+	const std::chrono::steady_clock::time_point profileStartTime = std::chrono::steady_clock::now();
+
+	struct ProfileThread
+	{
+		int id;
+
+		ProfileThread()
+		{
+			std::lock_guard<std::mutex> lock(profileMutex);
+
+			if (profileFreeThreads.empty())
+			{
+				id = profileNextThread++;
+			}
+			else
+			{
+				id = *profileFreeThreads.begin();
+				profileFreeThreads.erase(profileFreeThreads.begin());
+			}
+		}
+
+		~ProfileThread()
+		{
+			std::lock_guard<std::mutex> lock(profileMutex);
+			profileFreeThreads.insert(id);
+		}
+	};
+
+	thread_local ProfileThread profileThread;
+
+	long long GetProfileNanoseconds()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - profileStartTime).count();
+	}
+
+	void RecordProfileZone(const char* name, long long startNanoseconds, long long endNanoseconds)
+	{
+		int thread = profileThread.id;
+
+		std::lock_guard<std::mutex> lock(profileMutex);
+
+		if (profileEvents.empty())
+			profileEvents.resize(PROFILER_RING_SIZE);
+
+		profileEvents[(size_t)(profileNumEvents % PROFILER_RING_SIZE)] = ProfileEvent{ name, thread, startNanoseconds, endNanoseconds };
+		profileNumEvents++;
+	}
+#endif
+
+	bool IsProfilerEnabled()
+	{
+#ifdef EXPLORER_PROFILER
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	void SetProfileThreadName(const char* name)
+	{
+#ifdef EXPLORER_PROFILER
+		int thread = profileThread.id;
+
+		std::lock_guard<std::mutex> lock(profileMutex);
+		profileThreadNames[thread] = name;
+#endif
+	}
+
+	int WriteProfileTrace(const std::string& fileName)
+	{
+#ifdef EXPLORER_PROFILER
+		std::vector<ProfileEvent> events;
+		std::map<int, const char*> threadNames;
+
+		//Copied, zones keep being recorded while it's written
+		{
+			std::lock_guard<std::mutex> lock(profileMutex);
+
+			long long first = std::max(profileNumEvents - (long long)PROFILER_RING_SIZE, 0ll);
+
+			for (long long i = first; i < profileNumEvents; i++)
+				events.push_back(profileEvents[(size_t)(i % PROFILER_RING_SIZE)]);
+
+			threadNames = profileThreadNames;
+		}
+
+		std::ofstream trace(fileName);
+		trace.setf(std::ios::fixed);
+		trace.precision(3);
+
+		//Complete events ("X"), in microseconds
+		trace << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+
+		//Between entries, names & zones can each be missing
+		const char* separator = "";
+
+		for (const auto& [thread, name] : threadNames)
+		{
+			trace << separator << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, \"tid\": " << thread << ", \"args\": {\"name\": \"" << name << "\"}}";
+			separator = ",\n";
+		}
+
+		for (const ProfileEvent& event : events)
+		{
+			trace << separator << "{\"name\": \"" << event.name << "\", \"ph\": \"X\", \"pid\": 0, \"tid\": " << event.thread
+				<< ", \"ts\": " << (double)event.startNanoseconds / 1000.0 << ", \"dur\": " << (double)(event.endNanoseconds - event.startNanoseconds) / 1000.0 << "}";
+			separator = ",\n";
+		}
+
+		trace << "\n]}\n";
+
+		if (!trace)
+			throw std::runtime_error("Failed to write " + fileName);
+
+		return (int)events.size();
+#else
+		throw std::runtime_error("Profiling isn't compiled in, build with EXPLORER_PROFILER to write traces");
+#endif
+	}
+}
@@ -0,0 +1,292 @@
+#include "Readback.h"
+
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+
+#include "raylib.h"
+#include "rlgl.h"
+
+#ifndef PLATFORM_WEB
+//raylib loads OpenGL through glfw, rlgl doesn't expose buffer objects, so the few functions needed are loaded the same way
+typedef void (*GLFWglproc)(void);
+extern "C" GLFWglproc glfwGetProcAddress(const char* procname);
+
+#if defined(_WIN32) && !defined(_WIN64)
+#define READBACK_APIENTRY __stdcall
+#else
+#define READBACK_APIENTRY
+#endif
+#endif
+
+namespace Explorer
+{
+	struct ReadbackSlot
+	{
+		bool busy;
+
+		int width;
+		int height;
+
+		//Async: the pbo & the fence signaled once the gpu wrote it
+		unsigned int pixelBuffer;
+		void* fence;
+
+		//Sync: the image, read when queued
+		Image image;
+	};
+
+	RenderTexture2D readbackRenderTexture = { 0 };
+
+	ReadbackSlot readbackSlots[READBACK_RING_SIZE] = {};
+	int readbackNextSlot = 0;
+
+#ifndef PLATFORM_WEB
+	#pragma region OpenGL
+	const unsigned int GL_PIXEL_PACK_BUFFER_VALUE = 0x88EB;
+	const unsigned int GL_STREAM_READ_VALUE = 0x88E1;
+	const unsigned int GL_MAP_READ_BIT_VALUE = 0x0001;
+	const unsigned int GL_RGBA_VALUE = 0x1908;
+	const unsigned int GL_UNSIGNED_BYTE_VALUE = 0x1401;
+	const unsigned int GL_SYNC_GPU_COMMANDS_COMPLETE_VALUE = 0x9117;
+	const unsigned int GL_SYNC_FLUSH_COMMANDS_BIT_VALUE = 0x0001;
+	const unsigned int GL_ALREADY_SIGNALED_VALUE = 0x911A;
+	const unsigned int GL_CONDITION_SATISFIED_VALUE = 0x911C;
+	const unsigned long long GL_TIMEOUT_IGNORED_VALUE = 0xFFFFFFFFFFFFFFFFull;
+
+	typedef void (READBACK_APIENTRY* GenBuffersFunction)(int n, unsigned int* buffers);
+	typedef void (READBACK_APIENTRY* DeleteBuffersFunction)(int n, const unsigned int* buffers);
+	typedef void (READBACK_APIENTRY* BindBufferFunction)(unsigned int target, unsigned int buffer);
+	typedef void (READBACK_APIENTRY* BufferDataFunction)(unsigned int target, ptrdiff_t size, const void* data, unsigned int usage);
+	typedef void* (READBACK_APIENTRY* MapBufferRangeFunction)(unsigned int target, ptrdiff_t offset, ptrdiff_t length, unsigned int access);
+	typedef unsigned char (READBACK_APIENTRY* UnmapBufferFunction)(unsigned int target);
+	typedef void (READBACK_APIENTRY* ReadPixelsFunction)(int x, int y, int width, int height, unsigned int format, unsigned int type, void* pixels);
+	typedef void* (READBACK_APIENTRY* FenceSyncFunction)(unsigned int condition, unsigned int flags);
+	typedef unsigned int (READBACK_APIENTRY* ClientWaitSyncFunction)(void* sync, unsigned int flags, unsigned long long timeout);
+	typedef void (READBACK_APIENTRY* DeleteSyncFunction)(void* sync);
+
+	struct ReadbackFunctions
+	{
+		GenBuffersFunction genBuffers;
+		DeleteBuffersFunction deleteBuffers;
+		BindBufferFunction bindBuffer;
+		BufferDataFunction bufferData;
+		MapBufferRangeFunction mapBufferRange;
+		UnmapBufferFunction unmapBuffer;
+		ReadPixelsFunction readPixels;
+		FenceSyncFunction fenceSync;
+		ClientWaitSyncFunction clientWaitSync;
+		DeleteSyncFunction deleteSync;
+	};
+
+	ReadbackFunctions readbackGL = {};
+
+	//0: not loaded yet, 1: loaded, -1: unavailable
+	int readbackFunctionsState = 0;
+
+	bool LoadReadbackFunctions()
+	{
+		if (readbackFunctionsState != 0)
+			return readbackFunctionsState == 1;
+
+		readbackGL.genBuffers = (GenBuffersFunction)glfwGetProcAddress("glGenBuffers");
+		readbackGL.deleteBuffers = (DeleteBuffersFunction)glfwGetProcAddress("glDeleteBuffers");
+		readbackGL.bindBuffer = (BindBufferFunction)glfwGetProcAddress("glBindBuffer");
+		readbackGL.bufferData = (BufferDataFunction)glfwGetProcAddress("glBufferData");
+		readbackGL.mapBufferRange = (MapBufferRangeFunction)glfwGetProcAddress("glMapBufferRange");
+		readbackGL.unmapBuffer = (UnmapBufferFunction)glfwGetProcAddress("glUnmapBuffer");
+		readbackGL.readPixels = (ReadPixelsFunction)glfwGetProcAddress("glReadPixels");
+		readbackGL.fenceSync = (FenceSyncFunction)glfwGetProcAddress("glFenceSync");
+		readbackGL.clientWaitSync = (ClientWaitSyncFunction)glfwGetProcAddress("glClientWaitSync");
+		readbackGL.deleteSync = (DeleteSyncFunction)glfwGetProcAddress("glDeleteSync");
+
+		bool loaded = readbackGL.genBuffers && readbackGL.deleteBuffers && readbackGL.bindBuffer && readbackGL.bufferData && readbackGL.mapBufferRange && readbackGL.unmapBuffer && readbackGL.readPixels && readbackGL.fenceSync && readbackGL.clientWaitSync && readbackGL.deleteSync;
+
+		if (!loaded)
+			TraceLog(LOG_WARNING, "READBACK: Pixel buffer objects unavailable, readbacks are synchronous");
+
+		readbackFunctionsState = loaded ? 1 : -1;
+
+		return loaded;
+	}
+	#pragma endregion
+#endif
+
+	RenderTexture2D GetReadbackRenderTexture(int width, int height)
+	{
+		if (readbackRenderTexture.id != 0 && readbackRenderTexture.texture.width == width && readbackRenderTexture.texture.height == height)
+			return readbackRenderTexture;
+
+		if (readbackRenderTexture.id != 0)
+			UnloadRenderTexture(readbackRenderTexture);
+
+		readbackRenderTexture = LoadRenderTexture(width, height);
+
+		return readbackRenderTexture;
+	}
+
+	bool IsReadbackAsync()
+	{
+#ifdef PLATFORM_WEB
+		return false;
+#else
+		return LoadReadbackFunctions();
+#endif
+	}
+
+	int QueueReadback(const RenderTexture2D& renderTexture)
+	{
+		//Next free slot of the ring
+		int id = -1;
+
+		for (int i = 0; i < READBACK_RING_SIZE && id == -1; i++)
+		{
+			if (!readbackSlots[(readbackNextSlot + i) % READBACK_RING_SIZE].busy)
+				id = (readbackNextSlot + i) % READBACK_RING_SIZE;
+		}
+
+		if (id == -1)
+			return -1;
+
+		readbackNextSlot = (id + 1) % READBACK_RING_SIZE;
+
+		ReadbackSlot& slot = readbackSlots[id];
+
+		slot.busy = true;
+		slot.width = renderTexture.texture.width;
+		slot.height = renderTexture.texture.height;
+
+		if (!IsReadbackAsync())
+		{
+			slot.image = LoadImageFromTexture(renderTexture.texture);
+			return id;
+		}
+
+#ifndef PLATFORM_WEB
+		size_t size = (size_t)slot.width * (size_t)slot.height * 4;
+
+		//Anything raylib still has batched has to be drawn before reading
+		rlDrawRenderBatchActive();
+
+		if (slot.pixelBuffer == 0)
+			readbackGL.genBuffers(1, &slot.pixelBuffer);
+
+		readbackGL.bindBuffer(GL_PIXEL_PACK_BUFFER_VALUE, slot.pixelBuffer);
+		readbackGL.bufferData(GL_PIXEL_PACK_BUFFER_VALUE, (ptrdiff_t)size, NULL, GL_STREAM_READ_VALUE);
+
+		rlEnableFramebuffer(renderTexture.id);
+		readbackGL.readPixels(0, 0, slot.width, slot.height, GL_RGBA_VALUE, GL_UNSIGNED_BYTE_VALUE, NULL);
+		rlDisableFramebuffer();
+
+		readbackGL.bindBuffer(GL_PIXEL_PACK_BUFFER_VALUE, 0);
+
+		slot.fence = readbackGL.fenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE_VALUE, 0);
+#endif
+
+		return id;
+	}
+
+#ifndef PLATFORM_WEB
+	//Copies the pbo into a new image & frees the slot
+	Image MapReadbackSlot(ReadbackSlot& slot)
+	{
+		size_t size = (size_t)slot.width * (size_t)slot.height * 4;
+
+		Image image = { 0 };
+		image.data = MemAlloc((unsigned int)size);
+		image.width = slot.width;
+		image.height = slot.height;
+		image.mipmaps = 1;
+		image.format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8;
+
+		readbackGL.bindBuffer(GL_PIXEL_PACK_BUFFER_VALUE, slot.pixelBuffer);
+
+		void* pixels = readbackGL.mapBufferRange(GL_PIXEL_PACK_BUFFER_VALUE, 0, (ptrdiff_t)size, GL_MAP_READ_BIT_VALUE);
+
+		if (pixels != NULL)
+		{
+			std::memcpy(image.data, pixels, size);
+			readbackGL.unmapBuffer(GL_PIXEL_PACK_BUFFER_VALUE);
+		}
+
+		readbackGL.bindBuffer(GL_PIXEL_PACK_BUFFER_VALUE, 0);
+
+		readbackGL.deleteSync(slot.fence);
+		slot.fence = NULL;
+		slot.busy = false;
+
+		return image;
+	}
+#endif
+
+	bool PollReadback(int id, Image& image)
+	{
+		if (id < 0 || id >= READBACK_RING_SIZE || !readbackSlots[id].busy)
+			return false;
+
+		ReadbackSlot& slot = readbackSlots[id];
+
+		if (!IsReadbackAsync())
+		{
+			image = slot.image;
+			slot.image = Image{ 0 };
+			slot.busy = false;
+			return true;
+		}
+
+#ifndef PLATFORM_WEB
+		//Not waiting, just checking the fence
+		unsigned int status = readbackGL.clientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT_VALUE, 0);
+
+		if (status != GL_ALREADY_SIGNALED_VALUE && status != GL_CONDITION_SATISFIED_VALUE)
+			return false;
+
+		image = MapReadbackSlot(slot);
+#endif
+
+		return true;
+	}
+
+	Image WaitReadback(int id)
+	{
+		Image image = { 0 };
+
+		if (id < 0 || id >= READBACK_RING_SIZE || !readbackSlots[id].busy)
+			return image;
+
+#ifndef PLATFORM_WEB
+		if (IsReadbackAsync())
+			readbackGL.clientWaitSync(readbackSlots[id].fence, GL_SYNC_FLUSH_COMMANDS_BIT_VALUE, GL_TIMEOUT_IGNORED_VALUE);
+#endif
+
+		PollReadback(id, image);
+
+		return image;
+	}
+
+	void UnloadReadback()
+	{
+		for (ReadbackSlot& slot : readbackSlots)
+		{
+#ifndef PLATFORM_WEB
+			if (slot.fence != NULL)
+				readbackGL.deleteSync(slot.fence);
+
+			if (slot.pixelBuffer != 0)
+				readbackGL.deleteBuffers(1, &slot.pixelBuffer);
+#endif
+
+			if (slot.image.data != NULL)
+				UnloadImage(slot.image);
+
+			slot = ReadbackSlot{};
+		}
+
+		readbackNextSlot = 0;
+
+		if (readbackRenderTexture.id != 0)
+			UnloadRenderTexture(readbackRenderTexture);
+
+		readbackRenderTexture = RenderTexture2D{ 0 };
+	}
+}
@@ -0,0 +1,164 @@
+#include "RenderJobs.h"
+
+#include <chrono>
+
+#include "Profiler.h"
+
+namespace Explorer
+{
+#ifndef PLATFORM_WEB
+	void RenderJobQueue::UpdateThread()
+	{
+		PROFILE_THREAD("Render job");
+
+		while (true)
+		{
+			RenderJobStep step;
+			long long jobEpoch = 0;
+
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				condition.wait(lock, [&]() { return job != nullptr || stopping; });
+
+				if (stopping)
+					return;
+
+				step = std::move(job);
+				job = nullptr;
+
+				jobEpoch = epoch;
+				running = true;
+			}
+
+			{
+				PROFILE_ZONE("Render job");
+
+				while (!IsCancelled(jobEpoch) && step(jobEpoch))
+					continue;
+			}
+
+			std::lock_guard<std::mutex> lock(mutex);
+
+			running = false;
+			busy = job != nullptr;
+		}
+	}
+
+	long long RenderJobQueue::Publish(RenderJobStep step)
+	{
+		long long jobEpoch = 0;
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+
+			job = std::move(step);
+			jobEpoch = ++epoch;
+			busy = true;
+
+			//Started on the first job
+			if (!thread.joinable())
+				thread = std::thread(&RenderJobQueue::UpdateThread, this);
+		}
+
+		condition.notify_one();
+
+		return jobEpoch;
+	}
+
+	void RenderJobQueue::Cancel()
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+
+		//A queued job that didn't start yet never runs, a running one stops at its next step (then the thread clears busy)
+		job = nullptr;
+		epoch++;
+
+		busy = running;
+	}
+
+	void RenderJobQueue::RunOnThisThread(float /*frameTime*/)
+	{
+		//The job thread runs the steps
+	}
+
+	void RenderJobQueue::Stop()
+	{
+		if (!thread.joinable())
+			return;
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+
+			job = nullptr;
+			epoch++;
+			stopping = true;
+		}
+
+		condition.notify_one();
+		thread.join();
+
+		stopping = false;
+		running = false;
+		busy = false;
+	}
+#else //Web
+	void RenderJobQueue::UpdateThread()
+	{
+	}
+
+	long long RenderJobQueue::Publish(RenderJobStep step)
+	{
+		job = std::move(step);
+		busy = true;
+
+		return ++epoch;
+	}
+
+	void RenderJobQueue::Cancel()
+	{
+		job = nullptr;
+		busy = false;
+
+		epoch++;
+	}
+
+	void RenderJobQueue::RunOnThisThread(float frameTime)
+	{
+		auto startTime = std::chrono::steady_clock::now();
+
+		while (job != nullptr)
+		{
+			PROFILE_ZONE("Render job");
+
+			//The step is moved out, it might publish the next job
+			RenderJobStep step = std::move(job);
+			long long jobEpoch = epoch;
+
+			job = nullptr;
+
+			if (step(jobEpoch) && !IsCancelled(jobEpoch) && job == nullptr)
+				job = std::move(step);
+
+			busy = job != nullptr;
+
+			if (std::chrono::duration<float>(std::chrono::steady_clock::now() - startTime).count() >= frameTime)
+				break;
+		}
+	}
+
+	void RenderJobQueue::Stop()
+	{
+		Cancel();
+	}
+#endif
+
+	bool RenderJobQueue::IsCancelled(long long jobEpoch) const
+	{
+		return epoch != jobEpoch;
+	}
+
+	bool RenderJobQueue::IsBusy() const
+	{
+		return busy;
+	}
+}
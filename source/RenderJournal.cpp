@@ -0,0 +1,160 @@
+#include "RenderJournal.h"
+
+#include <sstream>
+#include <charconv>
+#include <stdexcept>
+#include <filesystem>
+
+namespace Explorer
+{
+	const std::string RENDER_JOURNAL_EXTENSION = ".journal";
+	const std::string RENDER_JOURNAL_HEADER = "fractal-explorer-journal";
+
+	std::string GetRenderJournalFileName(const std::string& fileName)
+	{
+		return fileName + RENDER_JOURNAL_EXTENSION;
+	}
+
+	//Reads the journal's hash & finished tiles, false if it doesn't exist or isn't a journal
+	bool ReadRenderJournal(const std::string& fileName, unsigned long long& renderHash, std::map<int, std::string>& finishedTiles)
+	{
+		std::ifstream file(fileName, std::ios::binary);
+
+		if (!file)
+			return false;
+
+		std::stringstream contents;
+		contents << file.rdbuf();
+
+		std::string text = contents.str();
+
+		//Complete lines only
+		size_t lineStart = 0;
+		size_t lineEnd = text.find('\n');
+		bool header = true;
+
+		while (lineEnd != std::string::npos)
+		{
+			std::string line = text.substr(lineStart, lineEnd - lineStart);
+
+			if (header)
+			{
+				if (!line.starts_with(RENDER_JOURNAL_HEADER + " "))
+					return false;
+
+				const char* hashStart = line.data() + RENDER_JOURNAL_HEADER.size() + 1;
+				std::from_chars_result result = std::from_chars(hashStart, line.data() + line.size(), renderHash, 16);
+
+				if (result.ec != std::errc())
+					return false;
+
+				header = false;
+			}
+			else
+			{
+				int tile = 0;
+				std::from_chars_result result = std::from_chars(line.data(), line.data() + line.size(), tile);
+
+				if (result.ec == std::errc())
+				{
+					size_t dataStart = (size_t)(result.ptr - line.data()) + 1;
+					finishedTiles[tile] = dataStart < line.size() ? line.substr(dataStart) : std::string();
+				}
+			}
+
+			lineStart = lineEnd + 1;
+			lineEnd = text.find('\n', lineStart);
+		}
+
+		return !header;
+	}
+
+	bool IsRenderJournalOf(const std::string& fileName, unsigned long long renderHash)
+	{
+		unsigned long long journalHash = 0;
+		std::map<int, std::string> finishedTiles;
+
+		return ReadRenderJournal(fileName, journalHash, finishedTiles) && journalHash == renderHash;
+	}
+
+	void RenderJournal::Write()
+	{
+		//Rewritten whole, which also drops a torn last line
+		stream.open(fileName, std::ios::binary | std::ios::trunc);
+
+		if (!stream)
+			throw std::runtime_error("Failed to open render journal " + fileName);
+
+		std::ostringstream hash;
+		hash << std::hex << renderHash;
+
+		stream << RENDER_JOURNAL_HEADER << ' ' << hash.str() << '\n';
+
+		for (const auto& [tile, data] : finishedTiles)
+			stream << tile << ' ' << data << '\n';
+
+		stream.flush();
+
+		if (!stream)
+			throw std::runtime_error("Failed to write render journal " + fileName);
+	}
+
+	bool RenderJournal::Open(const std::string& fileName, unsigned long long renderHash)
+	{
+		if (stream.is_open())
+			stream.close();
+
+		this->fileName = fileName;
+		this->renderHash = renderHash;
+
+		finishedTiles.clear();
+
+		unsigned long long journalHash = 0;
+
+		if (!ReadRenderJournal(fileName, journalHash, finishedTiles) || journalHash != renderHash)
+			finishedTiles.clear();
+
+		Write();
+
+		return !finishedTiles.empty();
+	}
+
+	bool RenderJournal::IsTileFinished(int tile) const
+	{
+		return finishedTiles.contains(tile);
+	}
+
+	std::string RenderJournal::GetTileData(int tile) const
+	{
+		auto finishedTile = finishedTiles.find(tile);
+
+		return finishedTile != finishedTiles.end() ? finishedTile->second : std::string();
+	}
+
+	int RenderJournal::GetNumFinishedTiles() const
+	{
+		return (int)finishedTiles.size();
+	}
+
+	void RenderJournal::FinishTile(int tile, const std::string& data)
+	{
+		finishedTiles[tile] = data;
+
+		stream << tile << ' ' << data << '\n';
+		stream.flush();
+
+		if (!stream)
+			throw std::runtime_error("Failed to write render journal " + fileName);
+	}
+
+	void RenderJournal::Remove()
+	{
+		if (stream.is_open())
+			stream.close();
+
+		std::error_code errorCode;
+		std::filesystem::remove(fileName, errorCode);
+
+		finishedTiles.clear();
+	}
+}
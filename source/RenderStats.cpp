@@ -0,0 +1,189 @@
+#include "RenderStats.h"
+
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+
+#include "raylib.h"
+
+#include "CPUFractal.h"
+
+namespace Explorer
+{
+	void CountFractalPixelClasses(FractalType type, const Color* pixels, size_t numPixels, FractalRenderStats& stats)
+	{
+		//Escape colors are hues at full value, never black
+		long long numInterior = 0;
+
+		for (size_t i = 0; i < numPixels; i++)
+		{
+			if (pixels[i].r == 0 && pixels[i].g == 0 && pixels[i].b == 0)
+				numInterior++;
+		}
+
+		bool newton = type == FRACTAL_NEWTON_3DEG || type == FRACTAL_NEWTON_4DEG || type == FRACTAL_NEWTON_5DEG || type == FRACTAL_NEWTON_SIN;
+
+		stats.interiorPixels += numInterior;
+		(newton ? stats.convergedPixels : stats.escapedPixels) += (long long)numPixels - numInterior;
+	}
+
+	double GetFractalRenderThroughput(const FractalRenderStats& stats)
+	{
+		double seconds = stats.gpuSeconds > 0.0 ? stats.gpuSeconds : stats.cpuSeconds;
+
+		if (stats.iterations < 0 || seconds <= 0.0)
+			return 0.0;
+
+		return (double)stats.iterations / seconds / 1e6;
+	}
+
+	#pragma region Sampler
+	void FractalRenderStatsSampler::Update(const FractalParameters& parameters, int width, int height, bool flipY)
+	{
+		int sampleWidth = RENDER_STATS_SAMPLE_WIDTH;
+		int sampleHeight = std::max((int)std::lround((double)RENDER_STATS_SAMPLE_WIDTH * (double)height / (double)std::max(width, 1)), 1);
+
+		unsigned long long hash = HashFractalValue(HashFractalParameters(parameters), flipY ? 1ull : 0ull);
+		hash = HashFractalValue(HashFractalValue(hash, (unsigned long long)sampleWidth), (unsigned long long)sampleHeight);
+
+		if (hash != publishedHash)
+		{
+			publishedHash = hash;
+
+			jobs.Publish([this, parameters, sampleWidth, sampleHeight, flipY](long long epoch)
+			{
+				std::vector<Color> pixels((size_t)sampleWidth * (size_t)sampleHeight);
+
+				CPUFractalView view = GetCPUFractalView(parameters, sampleWidth, sampleHeight, false, flipY);
+
+				FractalRenderStats rendered = FractalRenderStats{ -1.0, -1.0, (long long)pixels.size(), 0, 0, 0, 0, true };
+				rendered.iterations = RenderFractalRectCPU(parameters, view, pixels.data(), sampleWidth, 0, 0, sampleWidth, sampleHeight);
+
+				CountFractalPixelClasses(parameters.type, pixels.data(), pixels.size(), rendered);
+
+				std::lock_guard<std::mutex> lock(mutex);
+
+				if (!jobs.IsCancelled(epoch))
+				{
+					sample = rendered;
+					hasSample = true;
+				}
+
+				return false;
+			});
+		}
+
+		//Web: a sample is small enough for a single step
+		jobs.RunOnThisThread(0.0f);
+	}
+
+	bool FractalRenderStatsSampler::Estimate(long long numPixels, FractalRenderStats& stats)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+
+		if (!hasSample || sample.pixels == 0)
+			return false;
+
+		double scale = (double)numPixels / (double)sample.pixels;
+
+		stats.pixels = numPixels;
+		stats.iterations = std::llround((double)sample.iterations * scale);
+
+		stats.interiorPixels = std::llround((double)sample.interiorPixels * scale);
+		stats.escapedPixels = std::llround((double)sample.escapedPixels * scale);
+		stats.convergedPixels = std::llround((double)sample.convergedPixels * scale);
+
+		stats.estimated = true;
+
+		return true;
+	}
+
+	void FractalRenderStatsSampler::Unload()
+	{
+		jobs.Cancel();
+
+		std::lock_guard<std::mutex> lock(mutex);
+
+		hasSample = false;
+		publishedHash = 0;
+	}
+	#pragma endregion
+
+	#pragma region Log
+	void RenderStatsLog::Open(const std::string& newFileName)
+	{
+		Close();
+
+		stream.open(newFileName, std::ios::app);
+
+		if (!stream)
+			throw std::runtime_error("Failed to open " + newFileName);
+
+		stream.precision(9);
+
+		fileName = newFileName;
+		numLines = 0;
+	}
+
+	bool RenderStatsLog::IsOpen() const
+	{
+		return stream.is_open();
+	}
+
+	void RenderStatsLog::Append(long long frame, double time, const char* renderer, const FractalParameters& parameters, int width, int height, const FractalRenderStats& stats)
+	{
+		if (!stream.is_open())
+			return;
+
+		double pixels = (double)std::max(stats.pixels, 1ll);
+
+		stream << "{\"frame\": " << frame << ", \"time\": " << time << ", \"renderer\": \"" << renderer << "\", \"fractal\": \"" << GetFractalName(parameters.type) << "\"";
+		stream << ", \"width\": " << width << ", \"height\": " << height << ", \"zoom\": " << parameters.zoom << ", \"maxIterations\": " << parameters.maxIterations;
+		stream << ", \"cpuMs\": " << stats.cpuSeconds * 1000.0 << ", \"gpuMs\": ";
+
+		if (stats.gpuSeconds >= 0.0)
+			stream << stats.gpuSeconds * 1000.0;
+		else
+			stream << "null";
+
+		stream << ", \"pixels\": " << stats.pixels;
+
+		if (stats.iterations >= 0)
+		{
+			stream << ", \"iterations\": " << stats.iterations << ", \"iterationsPerPixel\": " << (double)stats.iterations / pixels;
+			stream << ", \"escaped\": " << (double)stats.escapedPixels / pixels << ", \"interior\": " << (double)stats.interiorPixels / pixels << ", \"converged\": " << (double)stats.convergedPixels / pixels;
+			stream << ", \"miterPerSecond\": " << GetFractalRenderThroughput(stats);
+		}
+		else
+		{
+			stream << ", \"iterations\": null, \"iterationsPerPixel\": null, \"escaped\": null, \"interior\": null, \"converged\": null, \"miterPerSecond\": null";
+		}
+
+		stream << ", \"estimated\": " << (stats.estimated ? "true" : "false") << "}\n";
+
+		//Flushed every line, the log is read while the explorer runs
+		stream.flush();
+
+		numLines++;
+	}
+
+	const std::string& RenderStatsLog::GetFileName() const
+	{
+		return fileName;
+	}
+
+	long long RenderStatsLog::GetNumLines() const
+	{
+		return numLines;
+	}
+
+	void RenderStatsLog::Close()
+	{
+		if (stream.is_open())
+			stream.close();
+
+		stream.clear();
+	}
+	#pragma endregion
+}
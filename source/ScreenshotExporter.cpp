@@ -0,0 +1,191 @@
+#include "ScreenshotExporter.h"
+
+#ifndef PLATFORM_WEB
+
+#include <iostream>
+#include <string>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <charconv>
+#include <stdexcept>
+#include <algorithm>
+#include <filesystem>
+#include <condition_variable>
+
+#include "raylib.h"
+
+#include "Profiler.h"
+
+namespace Explorer
+{
+	const std::string SCREENSHOT_FILE_PREFIX = "fractal_screenshot-";
+	const std::string SCREENSHOT_FILE_EXTENSION = ".png";
+
+	std::thread screenshotThread;
+
+	//Guards everything below
+	std::mutex screenshotMutex;
+	std::condition_variable screenshotCondition;
+
+	std::deque<Image> screenshotQueue;
+	std::deque<Notification> screenshotNotifications;
+
+	bool screenshotThreadStopping = false;
+
+	//Only used by the screenshot thread: the last screenshot number, -1 until the directory was scanned
+	int lastScreenshotNumber = -1;
+
+	//Highest N of the fractal_screenshot-N.png files in directory, scanned once instead of probing every number
+	int FindLastScreenshotNumber(const std::filesystem::path& directory)
+	{
+		int lastNumber = 0;
+
+		for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(directory))
+		{
+			std::string fileName = entry.path().filename().string();
+
+			if (!fileName.starts_with(SCREENSHOT_FILE_PREFIX) || !fileName.ends_with(SCREENSHOT_FILE_EXTENSION))
+				continue;
+
+			const char* numberStart = fileName.data() + SCREENSHOT_FILE_PREFIX.size();
+			const char* numberEnd = fileName.data() + fileName.size() - SCREENSHOT_FILE_EXTENSION.size();
+
+			int number = 0;
+			std::from_chars_result result = std::from_chars(numberStart, numberEnd, number);
+
+			if (result.ec == std::errc() && result.ptr == numberEnd)
+				lastNumber = std::max(lastNumber, number);
+		}
+
+		return lastNumber;
+	}
+
+	Notification ExportFractalScreenshot(Image image)
+	{
+		PROFILE_ZONE("Export screenshot");
+
+		try
+		{
+			//Fractal_Screenshots directory
+			std::filesystem::path fractalScreenshotsPath = std::filesystem::absolute(GetWorkingDirectory()).append("Fractal_Screenshots").make_preferred();
+
+			//Create fractal screenshots directory if it doesn't exist
+			if (!std::filesystem::exists(fractalScreenshotsPath))
+			{
+				bool success = std::filesystem::create_directories(fractalScreenshotsPath);
+
+				if (!success)
+					throw std::runtime_error("Failed to create fractal screenshots directory " + fractalScreenshotsPath.string());
+
+				std::cout << "Created fractal screenshots directory!" << std::endl;
+
+				lastScreenshotNumber = 0;
+			}
+			else if (lastScreenshotNumber == -1)
+			{
+				lastScreenshotNumber = FindLastScreenshotNumber(fractalScreenshotsPath);
+			}
+
+			lastScreenshotNumber++;
+
+			std::filesystem::path screenshotPath = std::filesystem::path(fractalScreenshotsPath).append(SCREENSHOT_FILE_PREFIX + std::to_string(lastScreenshotNumber) + SCREENSHOT_FILE_EXTENSION);
+
+			//Export image to file
+			bool exportSuccess = ExportImage(image, screenshotPath.string().c_str());
+
+			if (!exportSuccess)
+				throw std::runtime_error("Failed to export fractal screenshot to " + screenshotPath.string());
+
+			return Notification{ "Exported fractal screenshot to " + screenshotPath.string(), 5.0f, WHITE };
+		}
+		catch (std::exception& ex)
+		{
+			std::cout << ex.what() << std::endl;
+			return Notification{ ex };
+		}
+	}
+
+	void UpdateScreenshotThread()
+	{
+		PROFILE_THREAD("Screenshot export");
+
+		while (true)
+		{
+			Image image;
+
+			{
+				std::unique_lock<std::mutex> lock(screenshotMutex);
+				screenshotCondition.wait(lock, []() { return !screenshotQueue.empty() || screenshotThreadStopping; });
+
+				//Stopping, & everything was written
+				if (screenshotQueue.empty())
+					return;
+
+				image = screenshotQueue.front();
+				screenshotQueue.pop_front();
+			}
+
+			Notification notification = ExportFractalScreenshot(image);
+			UnloadImage(image);
+
+			std::lock_guard<std::mutex> lock(screenshotMutex);
+			screenshotNotifications.push_back(notification);
+		}
+	}
+
+	bool QueueFractalScreenshot(Image image)
+	{
+		{
+			std::lock_guard<std::mutex> lock(screenshotMutex);
+
+			if ((int)screenshotQueue.size() >= SCREENSHOT_QUEUE_CAPACITY)
+			{
+				UnloadImage(image);
+				return false;
+			}
+
+			screenshotQueue.push_back(image);
+		}
+
+		//Started on the first screenshot
+		if (!screenshotThread.joinable())
+			screenshotThread = std::thread(UpdateScreenshotThread);
+
+		screenshotCondition.notify_one();
+
+		return true;
+	}
+
+	bool PollFractalScreenshotNotification(Notification& notification)
+	{
+		std::lock_guard<std::mutex> lock(screenshotMutex);
+
+		if (screenshotNotifications.empty())
+			return false;
+
+		notification = screenshotNotifications.front();
+		screenshotNotifications.pop_front();
+
+		return true;
+	}
+
+	void UnloadScreenshotExporter()
+	{
+		if (!screenshotThread.joinable())
+			return;
+
+		{
+			std::lock_guard<std::mutex> lock(screenshotMutex);
+			screenshotThreadStopping = true;
+		}
+
+		screenshotCondition.notify_one();
+		screenshotThread.join();
+
+		screenshotThreadStopping = false;
+		screenshotNotifications.clear();
+	}
+}
+
+#endif
@@ -0,0 +1,255 @@
+#include "TileCache.h"
+
+#include <cmath>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <fstream>
+#include <iterator>
+#include <algorithm>
+#include <filesystem>
+
+namespace Explorer
+{
+	#pragma region Tiers
+	std::string TileCache::GetDiskFileName(unsigned long long key) const
+	{
+		char fileName[32];
+		std::snprintf(fileName, sizeof(fileName), "%016llx.tile", key);
+
+		return (std::filesystem::path(diskDirectory) / fileName).string();
+	}
+
+	void TileCache::AddToMemory(unsigned long long key, const CachedTile& tile)
+	{
+		if (tileEntries.count(key) > 0)
+			return;
+
+		tiles.emplace_front(key, tile);
+		tileEntries[key] = tiles.begin();
+		memoryBytes += (long long)tile->size();
+
+		//The newest tile is kept even if it's over the budget on its own
+		while (memoryBytes > memoryBudget && tiles.size() > 1)
+		{
+			memoryBytes -= (long long)tiles.back().second->size();
+			tileEntries.erase(tiles.back().first);
+			tiles.pop_back();
+		}
+	}
+
+	bool ReadTileFile(const std::string& fileName, std::string& bytes)
+	{
+		std::ifstream file(fileName, std::ios::binary);
+
+		if (!file)
+			return false;
+
+		bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+		return !file.bad() && !bytes.empty();
+	}
+
+	//Written next to the file & renamed, so another process never reads a tile half written
+	void WriteTileFile(const std::string& fileName, const std::string& bytes)
+	{
+		std::string temporaryFileName = fileName + ".tmp" + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+
+		{
+			std::ofstream file(temporaryFileName, std::ios::binary);
+			file.write(bytes.data(), (std::streamsize)bytes.size());
+
+			if (!file)
+				return;
+		}
+
+		std::error_code error;
+		std::filesystem::rename(temporaryFileName, fileName, error);
+
+		if (error)
+			std::filesystem::remove(temporaryFileName, error);
+	}
+	#pragma endregion
+
+	#pragma region Stats
+	void TileCache::AddLatency(std::vector<double>& latencies, long long& numLatencies, double milliseconds)
+	{
+		if (latencies.size() < (size_t)TILE_CACHE_LATENCY_SAMPLES)
+			latencies.push_back(milliseconds);
+		else
+			latencies[(size_t)(numLatencies % TILE_CACHE_LATENCY_SAMPLES)] = milliseconds;
+
+		numLatencies++;
+	}
+
+	//Nearest rank, 0 without samples
+	double GetLatencyPercentile(const std::vector<double>& sortedLatencies, double percentile)
+	{
+		if (sortedLatencies.empty())
+			return 0.0;
+
+		size_t rank = (size_t)std::ceil(percentile / 100.0 * (double)sortedLatencies.size());
+
+		return sortedLatencies[std::clamp(rank, (size_t)1, sortedLatencies.size()) - 1];
+	}
+
+	TileCacheStats TileCache::GetStats()
+	{
+		std::vector<double> sortedRenderLatencies;
+		std::vector<double> sortedRequestLatencies;
+
+		TileCacheStats stats = {};
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+
+			stats.numRequests = numRequests;
+			stats.numMemoryHits = numMemoryHits;
+			stats.numDiskHits = numDiskHits;
+			stats.numCoalesced = numCoalesced;
+			stats.numRenders = numRenders;
+			stats.numFailedRenders = numFailedRenders;
+
+			stats.memoryBytes = memoryBytes;
+			stats.memoryBudget = memoryBudget;
+			stats.numMemoryTiles = (long long)tiles.size();
+
+			sortedRenderLatencies = renderLatencies;
+			sortedRequestLatencies = requestLatencies;
+		}
+
+		//Coalesced requests & failed renders aren't hits, neither found the tile cached
+		stats.hitRate = stats.numRequests > 0 ? (double)(stats.numMemoryHits + stats.numDiskHits) / (double)stats.numRequests : 0.0;
+
+		std::sort(sortedRenderLatencies.begin(), sortedRenderLatencies.end());
+		std::sort(sortedRequestLatencies.begin(), sortedRequestLatencies.end());
+
+		stats.renderLatencyP50 = GetLatencyPercentile(sortedRenderLatencies, 50.0);
+		stats.renderLatencyP90 = GetLatencyPercentile(sortedRenderLatencies, 90.0);
+		stats.renderLatencyP99 = GetLatencyPercentile(sortedRenderLatencies, 99.0);
+		stats.renderLatencyMax = GetLatencyPercentile(sortedRenderLatencies, 100.0);
+
+		stats.requestLatencyP50 = GetLatencyPercentile(sortedRequestLatencies, 50.0);
+		stats.requestLatencyP90 = GetLatencyPercentile(sortedRequestLatencies, 90.0);
+		stats.requestLatencyP99 = GetLatencyPercentile(sortedRequestLatencies, 99.0);
+		stats.requestLatencyMax = GetLatencyPercentile(sortedRequestLatencies, 100.0);
+
+		return stats;
+	}
+	#pragma endregion
+
+	void TileCache::Reset(long long memoryBudget, const std::string& diskDirectory)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+
+		tiles.clear();
+		tileEntries.clear();
+
+		memoryBytes = 0;
+		this->memoryBudget = memoryBudget;
+		this->diskDirectory = diskDirectory;
+
+		if (!diskDirectory.empty())
+			std::filesystem::create_directories(diskDirectory);
+	}
+
+	CachedTile TileCache::GetTile(unsigned long long key, const std::function<std::string()>& render)
+	{
+		auto startTime = std::chrono::steady_clock::now();
+
+		auto getMilliseconds = [](std::chrono::steady_clock::time_point since)
+		{
+			return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - since).count();
+		};
+
+		std::promise<CachedTile> promise;
+
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			numRequests++;
+
+			auto entry = tileEntries.find(key);
+
+			if (entry != tileEntries.end())
+			{
+				//Most recently used
+				tiles.splice(tiles.begin(), tiles, entry->second);
+				numMemoryHits++;
+
+				CachedTile tile = entry->second->second;
+				AddLatency(requestLatencies, numRequestLatencies, getMilliseconds(startTime));
+
+				return tile;
+			}
+
+			auto pending = pendingTiles.find(key);
+
+			if (pending != pendingTiles.end())
+			{
+				numCoalesced++;
+
+				std::shared_future<CachedTile> future = pending->second;
+				lock.unlock();
+
+				CachedTile tile = future.get();
+
+				lock.lock();
+				AddLatency(requestLatencies, numRequestLatencies, getMilliseconds(startTime));
+
+				return tile;
+			}
+
+			pendingTiles[key] = promise.get_future().share();
+		}
+
+		//Disk first, then render, both outside of the lock so other tiles aren't held up
+		std::string bytes;
+		bool fromDisk = !diskDirectory.empty() && ReadTileFile(GetDiskFileName(key), bytes);
+
+		double renderMilliseconds = 0.0;
+
+		if (!fromDisk)
+		{
+			try
+			{
+				auto renderStartTime = std::chrono::steady_clock::now();
+				bytes = render();
+				renderMilliseconds = getMilliseconds(renderStartTime);
+			}
+			catch (...)
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				numFailedRenders++;
+				pendingTiles.erase(key);
+				promise.set_exception(std::current_exception());
+
+				throw;
+			}
+
+			if (!diskDirectory.empty())
+				WriteTileFile(GetDiskFileName(key), bytes);
+		}
+
+		CachedTile tile = std::make_shared<const std::string>(std::move(bytes));
+
+		std::lock_guard<std::mutex> lock(mutex);
+
+		if (fromDisk)
+		{
+			numDiskHits++;
+		}
+		else
+		{
+			numRenders++;
+			AddLatency(renderLatencies, numRenderLatencies, renderMilliseconds);
+		}
+
+		AddToMemory(key, tile);
+		pendingTiles.erase(key);
+		promise.set_value(tile);
+
+		AddLatency(requestLatencies, numRequestLatencies, getMilliseconds(startTime));
+
+		return tile;
+	}
+}
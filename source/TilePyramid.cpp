@@ -0,0 +1,435 @@
+#include "TilePyramid.h"
+
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <algorithm>
+#include <stdexcept>
+#include <filesystem>
+#include <unordered_map>
+
+#include "raylib.h"
+
+#include "Animation.h"
+
+namespace Explorer
+{
+	#pragma region Levels
+	struct PyramidLevel
+	{
+		//The level as a number in the layout, {z} or the deep zoom level
+		int number;
+
+		//Width & height of the whole level in pixels
+		long long size;
+
+		//Levels smaller than a tile (deep zoom's first levels) are a single tile that isn't split any further
+		bool isQuadtree;
+	};
+
+	//Deep zoom numbers its levels from 1x1 pixels, every level is twice the size of the one before (rounded up)
+	std::vector<PyramidLevel> GetPyramidLevels(const TilePyramidSettings& settings)
+	{
+		std::vector<PyramidLevel> levels;
+
+		long long fullSize = (long long)settings.tileSize << (settings.numLevels - 1);
+
+		if (settings.layout == TILE_PYRAMID_DZI)
+		{
+			int maxLevel = 0;
+
+			while ((1ll << maxLevel) < fullSize)
+				maxLevel++;
+
+			for (int level = 0; level <= maxLevel - settings.numLevels; level++)
+			{
+				long long scale = 1ll << (maxLevel - level);
+				levels.push_back(PyramidLevel{ level, (fullSize + scale - 1) / scale, false });
+			}
+		}
+
+		for (int z = 0; z < settings.numLevels; z++)
+		{
+			int number = settings.layout == TILE_PYRAMID_DZI ? (int)levels.size() : z;
+			levels.push_back(PyramidLevel{ number, (long long)settings.tileSize << z, true });
+		}
+
+		return levels;
+	}
+
+	//The level's first pixel & the step to the next one, from the transforms that map the screen onto the fractal
+	CPUFractalView GetPyramidLevelView(const FractalParameters& parameters, long long size, bool flipY)
+	{
+		Rectangle levelRect = Rectangle{ 0.0f, 0.0f, (float)size, (float)size };
+
+		Vector2 topLeft = GetRectToFractalPosition(Vector2{ 0.0f, 0.0f }, parameters.position, parameters.normalizedCenterOffset, levelRect, parameters.zoom, false, flipY);
+		Vector2 bottomRight = GetRectToFractalPosition(Vector2{ (float)size, (float)size }, parameters.position, parameters.normalizedCenterOffset, levelRect, parameters.zoom, false, flipY);
+
+		//The corners are the same fractal positions at every level, only the step between pixels shrinks,
+		//deep levels' pixels end up closer than float can tell apart, their tiles are rendered in double (see RenderFractalRectCPUDeep)
+		CPUFractalView view;
+
+		view.stepX = ((double)bottomRight.x - (double)topLeft.x) / (double)size;
+		view.stepY = ((double)bottomRight.y - (double)topLeft.y) / (double)size;
+
+		view.originX = (double)topLeft.x + 0.5 * view.stepX;
+		view.originY = (double)topLeft.y + 0.5 * view.stepY;
+
+		return view;
+	}
+
+	CPUFractalView OffsetPyramidLevelView(CPUFractalView view, int tileSize, int x, int y)
+	{
+		view.originX += (double)x * (double)tileSize * view.stepX;
+		view.originY += (double)y * (double)tileSize * view.stepY;
+
+		return view;
+	}
+
+	CPUFractalView GetTilePyramidTileView(const FractalParameters& parameters, int tileSize, int z, int x, int y, bool flipY)
+	{
+		return OffsetPyramidLevelView(GetPyramidLevelView(parameters, (long long)tileSize << z, flipY), tileSize, x, y);
+	}
+	#pragma endregion
+
+	#pragma region Tiles
+	struct PyramidTile
+	{
+		int x;
+		int y;
+
+		//Under a uniformly interior tile, linked instead of rendered
+		bool skipped;
+	};
+
+	std::filesystem::path GetTileFilePath(const std::filesystem::path& directory, const TilePyramidSettings& settings, int level, int x, int y)
+	{
+		if (settings.layout == TILE_PYRAMID_DZI)
+			return directory / "fractal_files" / std::to_string(level) / (std::to_string(x) + "_" + std::to_string(y) + ".png");
+
+		return directory / std::to_string(level) / std::to_string(x) / (std::to_string(y) + ".png");
+	}
+
+	bool IsTileInterior(const Color* pixels, int numPixels)
+	{
+		for (int i = 0; i < numPixels; i++)
+		{
+			if (pixels[i].r != 0 || pixels[i].g != 0 || pixels[i].b != 0)
+				return false;
+		}
+
+		return true;
+	}
+
+	unsigned long long HashTilePixels(const Color* pixels, int width, int height)
+	{
+		unsigned long long hash = HashFractalValue((unsigned long long)width, (unsigned long long)height);
+
+		const unsigned char* bytes = (const unsigned char*)pixels;
+		size_t numBytes = (size_t)width * (size_t)height * sizeof(Color);
+
+		for (size_t i = 0; i + 8 <= numBytes; i += 8)
+		{
+			unsigned long long value;
+			std::memcpy(&value, bytes + i, 8);
+
+			hash = HashFractalValue(hash, value);
+		}
+
+		//Tiles are whole pixels, an odd count leaves 4 bytes
+		if (numBytes % 8 != 0)
+		{
+			unsigned int value;
+			std::memcpy(&value, bytes + numBytes - 4, 4);
+
+			hash = HashFractalValue(hash, (unsigned long long)value);
+		}
+
+		return hash;
+	}
+
+	//A hard link to a tile that's already written, or a copy of it
+	bool LinkTileFile(const std::filesystem::path& existingFile, const std::filesystem::path& file)
+	{
+		std::error_code error;
+		std::filesystem::remove(file, error);
+
+		std::filesystem::create_hard_link(existingFile, file, error);
+
+		if (!error)
+			return true;
+
+		return std::filesystem::copy_file(existingFile, file, std::filesystem::copy_options::overwrite_existing, error);
+	}
+
+	//Tiles already written by their pixels' hash, the first one of each is the file, the others link to it
+	//a hash collision (two different tiles) is about one in 2^64 per pair
+	struct TileFiles
+	{
+		std::mutex mutex;
+		std::unordered_map<unsigned long long, std::filesystem::path> files;
+
+		//The tile linked in for tiles under interior tiles, always a full tileSize one
+		//(deep zoom's first levels are interior single pixels if the view's center is)
+		int tileSize;
+		std::filesystem::path interiorFile;
+	};
+
+	//Writes the tile or links it to one with the same pixels, false if it can't be written, deduplicated is set if it was linked
+	bool WriteTile(TileFiles& tileFiles, Color* pixels, int width, int height, bool interior, const std::filesystem::path& file, bool& deduplicated)
+	{
+		unsigned long long hash = HashTilePixels(pixels, width, height);
+
+		std::filesystem::path existingFile;
+
+		{
+			std::lock_guard<std::mutex> lock(tileFiles.mutex);
+			auto found = tileFiles.files.find(hash);
+
+			if (found != tileFiles.files.end())
+				existingFile = found->second;
+		}
+
+		deduplicated = !existingFile.empty() && LinkTileFile(existingFile, file);
+
+		if (deduplicated)
+			return true;
+
+		//The file may be a link from an earlier run, writing into it would change the tiles it's linked to
+		std::error_code error;
+		std::filesystem::remove(file, error);
+
+		Image image = Image{ pixels, width, height, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 };
+
+		if (!ExportImage(image, file.string().c_str()))
+			return false;
+
+		//Two threads with the same new tile both write it, the first one to finish is kept for the next ones
+		std::lock_guard<std::mutex> lock(tileFiles.mutex);
+		tileFiles.files.emplace(hash, file);
+
+		if (interior && width == tileFiles.tileSize && height == tileFiles.tileSize && tileFiles.interiorFile.empty())
+			tileFiles.interiorFile = file;
+
+		return true;
+	}
+	#pragma endregion
+
+	#pragma region Manifest
+	std::string GetJsonString(const std::string& text)
+	{
+		std::string json = "\"";
+
+		for (char character : text)
+		{
+			if (character == '"' || character == '\\')
+				json += '\\';
+
+			json += character;
+		}
+
+		return json + "\"";
+	}
+
+	void WriteTilePyramidManifest(const std::filesystem::path& directory, const FractalParameters& parameters, const TilePyramidSettings& settings,
+		const std::vector<PyramidLevel>& levels, const std::vector<TilePyramidLevelStats>& levelStats, const std::filesystem::path& interiorFile)
+	{
+		const PyramidLevel& lastLevel = levels.back();
+		const PyramidLevel& firstQuadtreeLevel = levels[levels.size() - settings.numLevels];
+
+		if (settings.layout == TILE_PYRAMID_DZI)
+		{
+			std::ofstream dzi(directory / "fractal.dzi");
+
+			dzi << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+			dzi << "<Image xmlns=\"http://schemas.microsoft.com/deepzoom/2008\" TileSize=\"" << settings.tileSize << "\" Overlap=\"0\" Format=\"png\">\n";
+			dzi << "\t<Size Width=\"" << lastLevel.size << "\" Height=\"" << lastLevel.size << "\"/>\n";
+			dzi << "</Image>\n";
+
+			if (!dzi)
+				throw std::runtime_error("Failed to write " + (directory / "fractal.dzi").string());
+		}
+
+		//The fractal's corners, from the top left one
+		CPUFractalView view = GetPyramidLevelView(parameters, firstQuadtreeLevel.size, settings.flipY);
+
+		double left = view.originX - 0.5 * view.stepX;
+		double top = view.originY - 0.5 * view.stepY;
+		double right = left + view.stepX * (double)firstQuadtreeLevel.size;
+		double bottom = top + view.stepY * (double)firstQuadtreeLevel.size;
+
+		std::ofstream manifest(directory / "tiles.json");
+		manifest.precision(17);
+
+		manifest << "{\n";
+		manifest << "\t\"format\": " << (settings.layout == TILE_PYRAMID_DZI ? "\"dzi\"" : "\"xyz\"") << ",\n";
+		manifest << "\t\"tiles\": " << (settings.layout == TILE_PYRAMID_DZI ? "\"fractal.dzi\"" : "\"{z}/{x}/{y}.png\"") << ",\n";
+		manifest << "\t\"tileSize\": " << settings.tileSize << ",\n";
+		manifest << "\t\"minZoom\": " << levels.front().number << ",\n";
+		manifest << "\t\"maxZoom\": " << lastLevel.number << ",\n";
+		manifest << "\t\"size\": " << lastLevel.size << ",\n";
+		manifest << "\t\"fillInterior\": " << (settings.fillInterior ? "true" : "false") << ",\n";
+		manifest << "\t\"interiorTile\": " << (interiorFile.empty() ? "null" : GetJsonString(interiorFile.lexically_relative(directory).generic_string())) << ",\n";
+		manifest << "\t\"fractal\": " << GetJsonString(GetFractalName(parameters.type)) << ",\n";
+		manifest << "\t\"parameters\": " << GetJsonString(GetFractalKeyframeLine(FractalKeyframe{ 0.0, parameters })) << ",\n";
+		manifest << "\t\"bounds\": [" << left << ", " << top << ", " << right << ", " << bottom << "],\n";
+		manifest << "\t\"levels\": [\n";
+
+		for (size_t i = 0; i < levelStats.size(); i++)
+		{
+			const TilePyramidLevelStats& stats = levelStats[i];
+
+			manifest << "\t\t{ \"level\": " << stats.level << ", \"rendered\": " << stats.numRendered << ", \"skipped\": " << stats.numSkipped
+				<< ", \"deduplicated\": " << stats.numDeduplicated << ", \"seconds\": " << stats.seconds << " }" << (i + 1 < levelStats.size() ? "," : "") << "\n";
+		}
+
+		manifest << "\t]\n";
+		manifest << "}\n";
+
+		if (!manifest)
+			throw std::runtime_error("Failed to write " + (directory / "tiles.json").string());
+	}
+	#pragma endregion
+
+	std::vector<TilePyramidLevelStats> GenerateTilePyramid(const FractalParameters& parameters, const TilePyramidSettings& settings, const std::string& directory,
+		const std::function<void(int level, long long tilesDone, long long numTiles)>& progress)
+	{
+		if (settings.tileSize <= 0 || settings.numLevels <= 0 || settings.numLevels > 31)
+			throw std::runtime_error("Invalid tile size or number of levels");
+
+		std::filesystem::path directoryPath = directory;
+		std::filesystem::create_directories(directoryPath);
+
+		std::vector<PyramidLevel> levels = GetPyramidLevels(settings);
+		std::vector<TilePyramidLevelStats> levelStats;
+
+		//Past double precision the deepest tiles would be blocks of the same pixel
+		CPUFractalView deepestView = GetPyramidLevelView(parameters, levels.back().size, settings.flipY);
+
+		if (!IsCPUFractalRectResolvable(deepestView, 0, 0, settings.tileSize, settings.tileSize))
+			throw std::runtime_error("Level " + std::to_string(levels.back().number) + " is zoomed in past double precision, use fewer levels");
+
+		TileFiles tileFiles;
+		tileFiles.tileSize = settings.tileSize;
+
+		//The level's work queue, & whether each of its tiles turned out uniformly interior
+		std::vector<PyramidTile> tiles;
+		std::vector<char> tilesInterior;
+
+		for (const PyramidLevel& level : levels)
+		{
+			auto startTime = std::chrono::steady_clock::now();
+
+			//The children of the last level's tiles, the ones under an interior tile are only written if the interior is filled
+			std::vector<PyramidTile> parentTiles;
+			parentTiles.swap(tiles);
+
+			if (!level.isQuadtree || level.size == (long long)settings.tileSize)
+			{
+				tiles.push_back(PyramidTile{ 0, 0, false });
+			}
+			else
+			{
+				for (size_t i = 0; i < parentTiles.size(); i++)
+				{
+					bool skipped = parentTiles[i].skipped || tilesInterior[i];
+
+					if (skipped && !settings.fillInterior)
+						continue;
+
+					for (int child = 0; child < 4; child++)
+						tiles.push_back(PyramidTile{ parentTiles[i].x * 2 + (child & 1), parentTiles[i].y * 2 + (child >> 1), skipped });
+				}
+			}
+
+			parentTiles = std::vector<PyramidTile>();
+			tilesInterior.assign(tiles.size(), 0);
+
+			CPUFractalView levelView = GetPyramidLevelView(parameters, level.size, settings.flipY);
+
+			int tileSize = (int)std::min(level.size, (long long)settings.tileSize);
+			long long numTiles = (long long)tiles.size();
+
+			std::mutex progressMutex;
+			long long tilesDone = 0;
+
+			std::atomic<long long> numSkipped = 0;
+			std::atomic<long long> numDeduplicated = 0;
+			std::atomic<int> numFailed = 0;
+
+			//Every tile is rendered by a single thread, the threads take the next tile in the queue when they're done
+			long long numRendered = RunOnAllThreads((int)tiles.size(), [&](int item)
+			{
+				const PyramidTile& tile = tiles[item];
+
+				std::filesystem::path file = GetTileFilePath(directoryPath, settings, level.number, tile.x, tile.y);
+
+				std::error_code error;
+				std::filesystem::create_directories(file.parent_path(), error);
+
+				bool rendered = !tile.skipped;
+
+				if (tile.skipped)
+				{
+					std::filesystem::path interiorFile;
+
+					{
+						std::lock_guard<std::mutex> lock(tileFiles.mutex);
+						interiorFile = tileFiles.interiorFile;
+					}
+
+					tilesInterior[item] = 1;
+
+					if (LinkTileFile(interiorFile, file))
+						numSkipped++;
+					else
+						numFailed++;
+				}
+				else
+				{
+					CPUFractalView view = OffsetPyramidLevelView(levelView, tileSize, tile.x, tile.y);
+
+					std::vector<Color> pixels((size_t)tileSize * (size_t)tileSize);
+					RenderFractalRectCPUDeep(parameters, view, pixels.data(), tileSize, 0, 0, tileSize, tileSize);
+
+					tilesInterior[item] = IsTileInterior(pixels.data(), (int)pixels.size()) ? 1 : 0;
+
+					bool deduplicated = false;
+
+					if (!WriteTile(tileFiles, pixels.data(), tileSize, tileSize, tilesInterior[item] != 0, file, deduplicated))
+						numFailed++;
+					else if (deduplicated)
+						numDeduplicated++;
+				}
+
+				std::lock_guard<std::mutex> lock(progressMutex);
+				tilesDone++;
+				progress(level.number, tilesDone, numTiles);
+
+				return rendered ? 1ll : 0ll;
+			});
+
+			if (numFailed > 0)
+				throw std::runtime_error(std::to_string(numFailed.load()) + " tiles of level " + std::to_string(level.number) + " failed to be written");
+
+			//The tiles left out under interior tiles count as skipped too
+			long long numLeftOut = 0;
+
+			if (!settings.fillInterior && level.isQuadtree && level.size > (long long)settings.tileSize)
+			{
+				long long tilesPerSide = level.size / (long long)settings.tileSize;
+				numLeftOut = tilesPerSide * tilesPerSide - numTiles;
+			}
+
+			double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+			levelStats.push_back(TilePyramidLevelStats{ level.number, numRendered, numSkipped + numLeftOut, numDeduplicated, seconds });
+		}
+
+		WriteTilePyramidManifest(directoryPath, parameters, settings, levels, levelStats, tileFiles.interiorFile);
+
+		return levelStats;
+	}
+}
@@ -0,0 +1,657 @@
+#include "TileTree.h"
+
+#include <bit>
+#include <cmath>
+#include <chrono>
+#include <atomic>
+#include <vector>
+#include <numeric>
+#include <algorithm>
+
+#include "raylib.h"
+
+#include "CPUFractal.h"
+#include "Profiler.h"
+
+namespace Explorer
+{
+	#pragma region Tiles
+	//Tiles stay valid while only the view (position, zoom, center offset) changes
+	unsigned long long GetTileTreeContentHash(const FractalParameters& parameters)
+	{
+		FractalParameters content = parameters;
+		content.position = Vector2{ 0.0f, 0.0f };
+		content.normalizedCenterOffset = Vector2{ 0.0f, 0.0f };
+		content.zoom = 1.0f;
+
+		return HashFractalParameters(content);
+	}
+
+	unsigned long long GetTileTreeKey(unsigned long long contentHash, int level, long long x, long long y)
+	{
+		unsigned long long key = HashFractalValue(contentHash, (unsigned long long)(long long)level);
+		key = HashFractalValue(key, (unsigned long long)x);
+
+		return HashFractalValue(key, (unsigned long long)y);
+	}
+
+	double GetTileTreeTileSize(int level)
+	{
+		return std::ldexp(TILE_TREE_ROOT_SIZE, -level);
+	}
+
+	//The tiles of level covering the view's pixels
+	struct TileTreeRange
+	{
+		long long minX;
+		long long maxX;
+		long long minY;
+		long long maxY;
+	};
+
+	TileTreeRange GetTileTreeRange(const CPUFractalView& view, int width, int height, int level)
+	{
+		double left = view.originX - 0.5 * view.stepX;
+		double right = left + (double)width * view.stepX;
+		double top = view.originY - 0.5 * view.stepY;
+		double bottom = top + (double)height * view.stepY;
+
+		double tileSize = GetTileTreeTileSize(level);
+
+		return TileTreeRange{
+			(long long)std::floor(std::min(left, right) / tileSize), (long long)std::floor(std::max(left, right) / tileSize),
+			(long long)std::floor(std::min(top, bottom) / tileSize), (long long)std::floor(std::max(top, bottom) / tileSize)
+		};
+	}
+
+	//Tile pixels from the top left, like the screen
+	CPUFractalView GetTileTreeTileView(int level, long long x, long long y)
+	{
+		double tileSize = GetTileTreeTileSize(level);
+		double pixelSize = tileSize / (double)TILE_TREE_TILE_SIZE;
+
+		return CPUFractalView{ (double)x * tileSize + 0.5 * pixelSize, (double)(y + 1) * tileSize - 0.5 * pixelSize, pixelSize, -pixelSize };
+	}
+
+	int FractalTileTree::GetViewLevel(const FractalParameters& parameters, int height) const
+	{
+		//Tile pixels the closest to screen pixels, from 0.7 to 1.4 of them
+		double pixelSize = 1.0 / ((double)height * (double)parameters.zoom);
+		int level = (int)std::lround(std::log2(TILE_TREE_ROOT_SIZE / ((double)TILE_TREE_TILE_SIZE * pixelSize)));
+
+		return std::clamp(level, TILE_TREE_MIN_LEVEL, TILE_TREE_MAX_LEVEL);
+	}
+
+	const TileTreeTile* FractalTileTree::FindTile(unsigned long long contentHash, int level, long long x, long long y) const
+	{
+		auto found = tiles.find(GetTileTreeKey(contentHash, level, x, y));
+
+		if (found == tiles.end() || found->second.level != level || found->second.x != x || found->second.y != y || found->second.contentHash != contentHash)
+			return nullptr;
+
+		return &found->second;
+	}
+	#pragma endregion
+
+	#pragma region Updating
+	void FractalTileTree::Update(const FractalParameters& parameters, int width, int height, bool flipY, Vector2 focus, float frameTime)
+	{
+		frame++;
+
+		LoadRenderedTiles();
+
+		unsigned long long contentHash = GetTileTreeContentHash(parameters);
+		CPUFractalView view = GetCPUFractalView(parameters, width, height, false, flipY);
+
+		int viewLevel = GetViewLevel(parameters, height);
+		int previewLevel = std::max(viewLevel - TILE_TREE_PREVIEW_LEVELS, TILE_TREE_MIN_LEVEL);
+
+		//Where the focus is in tiles of the view's level, pixel x covers [x, x + 1] of the screen
+		double viewTileSize = GetTileTreeTileSize(viewLevel);
+		double focusX = (view.originX + ((double)std::clamp(focus.x, 0.0f, (float)width) - 0.5) * view.stepX) / viewTileSize;
+		double focusY = (view.originY + ((double)std::clamp(focus.y, 0.0f, (float)height) - 0.5) * view.stepY) / viewTileSize;
+
+		auto markUsed = [&](int level, long long x, long long y)
+		{
+			const TileTreeTile* tile = FindTile(contentHash, level, x, y);
+
+			if (tile != nullptr)
+				tiles[GetTileTreeKey(contentHash, level, x, y)].lastUsedFrame = frame;
+
+			return tile != nullptr;
+		};
+
+		wantedTiles.clear();
+
+		for (int level : { previewLevel, viewLevel })
+		{
+			TileTreeRange range = GetTileTreeRange(view, width, height, level);
+			size_t firstWanted = wantedTiles.size();
+
+			for (long long y = range.minY; y <= range.maxY; y++)
+			{
+				for (long long x = range.minX; x <= range.maxX; x++)
+				{
+					if (markUsed(level, x, y))
+						continue;
+
+					wantedTiles.push_back(TileTreeTile{ level, x, y, contentHash, Texture2D{ 0 }, 0 });
+
+					if (level != viewLevel)
+						continue;
+
+					//What Draw fills the missing tile in with is kept too
+					for (int levelsUp = 1; levelsUp <= TILE_TREE_FALLBACK_LEVELS && level - levelsUp >= TILE_TREE_MIN_LEVEL; levelsUp++)
+					{
+						if (markUsed(level - levelsUp, x >> levelsUp, y >> levelsUp))
+							break;
+					}
+
+					for (int child = 0; child < 4; child++)
+						markUsed(level + 1, x * 2 + (child & 1), y * 2 + (child >> 1));
+				}
+			}
+
+			//The level's tiles closest to the focus first (in rings around it), coarser levels before finer ones
+			double scale = std::ldexp(1.0, level - viewLevel);
+
+			auto getDistance = [&](const TileTreeTile& tile)
+			{
+				double distanceX = ((double)tile.x + 0.5) / scale - focusX;
+				double distanceY = ((double)tile.y + 0.5) / scale - focusY;
+
+				return distanceX * distanceX + distanceY * distanceY;
+			};
+
+			std::sort(wantedTiles.begin() + firstWanted, wantedTiles.end(), [&](const TileTreeTile& a, const TileTreeTile& b)
+			{
+				return getDistance(a) < getDistance(b);
+			});
+		}
+
+		//A new job when the view changed, the focus moved to another tile (for the new order), or if the last one ended with tiles missing
+		unsigned long long viewHash = contentHash;
+
+		for (double value : { view.originX, view.originY, view.stepX, view.stepY })
+			viewHash = HashFractalValue(viewHash, std::bit_cast<unsigned long long>(value));
+
+		viewHash = HashFractalValue(HashFractalValue(viewHash, (unsigned long long)width), (unsigned long long)height);
+		viewHash = HashFractalValue(HashFractalValue(viewHash, (unsigned long long)(long long)std::floor(focusX)), (unsigned long long)(long long)std::floor(focusY));
+
+		if (viewHash != publishedViewHash || (!wantedTiles.empty() && !renderJobs.IsBusy()))
+		{
+			PublishRenderJob(parameters);
+			publishedViewHash = viewHash;
+		}
+
+		renderJobs.RunOnThisThread(frameTime);
+
+		EvictTiles();
+	}
+
+	void FractalTileTree::LoadRenderedTiles()
+	{
+		std::vector<TileTreeRenderedTile> loadedTiles;
+
+		{
+			std::lock_guard<std::mutex> lock(renderMutex);
+			loadedTiles.swap(renderedTiles);
+
+			if (jobMeanBusySeconds > 0.0)
+				loadImbalance = (float)(jobMaxBusySeconds / jobMeanBusySeconds);
+
+			frameStats = jobFrameStats;
+			jobFrameStats = FractalRenderStats{ 0.0, -1.0, 0, 0, 0, 0, 0, false };
+		}
+
+		//Textures are loaded on this thread, the one with the gl context
+		for (TileTreeRenderedTile& rendered : loadedTiles)
+		{
+			TileTreeTile tile = rendered.tile;
+
+			Image image = Image{ rendered.pixels.data(), TILE_TREE_TILE_SIZE, TILE_TREE_TILE_SIZE, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 };
+
+			tile.texture = LoadTextureFromImage(image);
+			tile.lastUsedFrame = frame;
+
+			SetTextureFilter(tile.texture, TEXTURE_FILTER_BILINEAR);
+
+			//A different tile with the same key (a hash collision) is replaced
+			unsigned long long key = GetTileTreeKey(tile.contentHash, tile.level, tile.x, tile.y);
+			auto replaced = tiles.find(key);
+
+			if (replaced != tiles.end())
+			{
+				UnloadTexture(replaced->second.texture);
+				memoryBytes -= (long long)TILE_TREE_TILE_SIZE * (long long)TILE_TREE_TILE_SIZE * 4ll;
+			}
+
+			tiles[key] = tile;
+			memoryBytes += (long long)TILE_TREE_TILE_SIZE * (long long)TILE_TREE_TILE_SIZE * 4ll;
+		}
+	}
+
+	void FractalTileTree::PublishRenderJob(const FractalParameters& parameters)
+	{
+		{
+			std::lock_guard<std::mutex> lock(renderMutex);
+
+			jobKeys.clear();
+
+			for (const TileTreeTile& tile : wantedTiles)
+				jobKeys.insert(GetTileTreeKey(tile.contentHash, tile.level, tile.x, tile.y));
+
+			//Only the tiles that weren't loaded yet can be wanted again, the rest are in the cache
+			renderedKeys.clear();
+
+			for (const TileTreeRenderedTile& rendered : renderedTiles)
+				renderedKeys.insert(GetTileTreeKey(rendered.tile.contentHash, rendered.tile.level, rendered.tile.x, rendered.tile.y));
+		}
+
+		if (wantedTiles.empty())
+		{
+			renderJobs.Cancel();
+			return;
+		}
+
+		//Predicted here, the cache is the ui thread's
+		std::vector<long long> bandCosts(wantedTiles.size() * (size_t)TILE_TREE_COST_CELLS);
+
+		for (size_t i = 0; i < wantedTiles.size(); i++)
+			PredictBandCosts(wantedTiles[i], &bandCosts[i * (size_t)TILE_TREE_COST_CELLS]);
+
+		renderJobs.Publish([this, parameters, tiles = wantedTiles, bandCosts = std::move(bandCosts), nextTile = (size_t)0](long long epoch) mutable
+		{
+			return RenderTiles(parameters, tiles, bandCosts, nextTile, epoch);
+		});
+	}
+
+	void FractalTileTree::PredictBandCosts(const TileTreeTile& tile, long long* bandCosts) const
+	{
+		std::fill(bandCosts, bandCosts + TILE_TREE_COST_CELLS, -1ll);
+
+		for (int levelsUp = 1; levelsUp <= TILE_TREE_FALLBACK_LEVELS && tile.level - levelsUp >= TILE_TREE_MIN_LEVEL; levelsUp++)
+		{
+			const TileTreeTile* ancestor = FindTile(tile.contentHash, tile.level - levelsUp, tile.x >> levelsUp, tile.y >> levelsUp);
+
+			if (ancestor == nullptr || ancestor->costs.empty())
+				continue;
+
+			//The tile in the ancestor's pixels (rows go down, y goes up), an ancestor pixel is cells * cells of the tile's
+			long long cells = 1ll << levelsUp;
+			double size = (double)TILE_TREE_TILE_SIZE / (double)cells;
+			double density = (double)cells * (double)cells;
+
+			double left = (double)(tile.x - (ancestor->x << levelsUp)) * size;
+			double right = left + size;
+
+			double bandHeight = size / (double)TILE_TREE_COST_CELLS;
+			double cellSize = (double)TILE_TREE_BAND_HEIGHT;
+
+			for (int band = 0; band < TILE_TREE_COST_CELLS; band++)
+			{
+				double top = (double)(cells - 1 - (tile.y - (ancestor->y << levelsUp))) * size + (double)band * bandHeight;
+				double bottom = top + bandHeight;
+
+				//The ancestor's cells under the band, by how much of them it covers
+				double cost = 0.0;
+
+				for (int row = (int)(top / cellSize); row <= std::min((int)(bottom / cellSize), TILE_TREE_COST_CELLS - 1); row++)
+				{
+					double coveredY = std::min(bottom, (double)(row + 1) * cellSize) - std::max(top, (double)row * cellSize);
+
+					for (int column = (int)(left / cellSize); column <= std::min((int)(right / cellSize), TILE_TREE_COST_CELLS - 1); column++)
+					{
+						double coveredX = std::min(right, (double)(column + 1) * cellSize) - std::max(left, (double)column * cellSize);
+
+						if (coveredX > 0.0 && coveredY > 0.0)
+							cost += (double)ancestor->costs[(size_t)row * (size_t)TILE_TREE_COST_CELLS + (size_t)column] * coveredX * coveredY / (cellSize * cellSize);
+					}
+				}
+
+				bandCosts[band] = std::llround(cost * density);
+			}
+
+			return;
+		}
+	}
+
+	bool FractalTileTree::RenderTiles(const FractalParameters& parameters, const std::vector<TileTreeTile>& tiles, const std::vector<long long>& bandCosts, size_t& nextTile, long long epoch)
+	{
+		PROFILE_ZONE("Render tiles");
+
+		//Indices in tiles
+		std::vector<size_t> batch;
+
+		{
+			std::lock_guard<std::mutex> lock(renderMutex);
+
+			while (nextTile < tiles.size() && (int)batch.size() < GetCPUFractalNumThreads())
+			{
+				const TileTreeTile& tile = tiles[nextTile];
+
+				if (!renderedKeys.contains(GetTileTreeKey(tile.contentHash, tile.level, tile.x, tile.y)))
+					batch.push_back(nextTile);
+
+				nextTile++;
+			}
+		}
+
+		if (batch.empty())
+			return false;
+
+		//Once the job is cancelled its tiles are only finished if the newer job wants them too
+		auto isWanted = [&](unsigned long long key)
+		{
+			if (!renderJobs.IsCancelled(epoch))
+				return true;
+
+			std::lock_guard<std::mutex> lock(renderMutex);
+			return jobKeys.contains(key);
+		};
+
+		std::vector<TileTreeRenderedTile> rendered(batch.size());
+		std::vector<unsigned long long> keys(batch.size());
+
+		//Set once a band finds its tile isn't wanted anymore, its other bands are skipped
+		std::vector<std::atomic<bool>> dropped(batch.size());
+
+		for (size_t i = 0; i < batch.size(); i++)
+		{
+			const TileTreeTile& tile = tiles[batch[i]];
+
+			rendered[i].tile = tile;
+			rendered[i].tile.costs.assign((size_t)TILE_TREE_COST_CELLS * (size_t)TILE_TREE_COST_CELLS, 0);
+			rendered[i].pixels.resize((size_t)TILE_TREE_TILE_SIZE * (size_t)TILE_TREE_TILE_SIZE);
+
+			keys[i] = GetTileTreeKey(tile.contentHash, tile.level, tile.x, tile.y);
+		}
+
+		//Item tile * TILE_TREE_COST_CELLS + band, the bands without a predicted cost first (they could be anything), then the most expensive
+		std::vector<int> items(batch.size() * (size_t)TILE_TREE_COST_CELLS);
+		std::iota(items.begin(), items.end(), 0);
+
+		auto getCost = [&](int item)
+		{
+			return bandCosts[batch[item / TILE_TREE_COST_CELLS] * (size_t)TILE_TREE_COST_CELLS + (size_t)(item % TILE_TREE_COST_CELLS)];
+		};
+
+		std::stable_sort(items.begin(), items.end(), [&](int a, int b)
+		{
+			long long costA = getCost(a);
+			long long costB = getCost(b);
+
+			if ((costA < 0) != (costB < 0))
+				return costA < 0;
+
+			return costA > costB;
+		});
+
+		CPUFractalThreadStats stats;
+
+		//Of the bands rendered, for the frame's stats
+		std::atomic<long long> numBands = 0;
+		std::atomic<long long> numInterior = 0;
+		std::atomic<long long> numEscaped = 0;
+		std::atomic<long long> numConverged = 0;
+
+		auto startTime = std::chrono::steady_clock::now();
+
+		long long iterations = RunOnAllThreadsStealing(items, [&](int item)
+		{
+			int tileIndex = item / TILE_TREE_COST_CELLS;
+			int band = item % TILE_TREE_COST_CELLS;
+
+			if (dropped[tileIndex])
+				return 0ll;
+
+			if (!isWanted(keys[tileIndex]))
+			{
+				dropped[tileIndex] = true;
+				return 0ll;
+			}
+
+			TileTreeRenderedTile& tile = rendered[tileIndex];
+			CPUFractalView view = GetTileTreeTileView(tile.tile.level, tile.tile.x, tile.tile.y);
+
+			//Deep levels are rendered in double, picked for the whole tile so its cells don't differ
+			bool deep = GetCPUFractalRectPrecision(view, 0, 0, TILE_TREE_TILE_SIZE, TILE_TREE_TILE_SIZE) == CPU_FRACTAL_DOUBLE;
+
+			//A cell at a time for the costs
+			long long bandIterations = 0;
+
+			for (int cell = 0; cell < TILE_TREE_COST_CELLS; cell++)
+			{
+				int cellX = cell * TILE_TREE_BAND_HEIGHT;
+				int cellY = band * TILE_TREE_BAND_HEIGHT;
+
+				long long cellIterations = deep
+					? RenderFractalRectCPUVariant(parameters, view, CPU_FRACTAL_DOUBLE, 1, tile.pixels.data(), TILE_TREE_TILE_SIZE, cellX, cellY, TILE_TREE_BAND_HEIGHT, TILE_TREE_BAND_HEIGHT)
+					: RenderFractalRectCPU(parameters, view, tile.pixels.data(), TILE_TREE_TILE_SIZE, cellX, cellY, TILE_TREE_BAND_HEIGHT, TILE_TREE_BAND_HEIGHT);
+
+				tile.tile.costs[(size_t)band * (size_t)TILE_TREE_COST_CELLS + (size_t)cell] = cellIterations;
+				bandIterations += cellIterations;
+			}
+
+			//The band's rows are contiguous
+			FractalRenderStats bandStats = FractalRenderStats{};
+			CountFractalPixelClasses(parameters.type, tile.pixels.data() + (size_t)band * (size_t)TILE_TREE_BAND_HEIGHT * (size_t)TILE_TREE_TILE_SIZE, (size_t)TILE_TREE_BAND_HEIGHT * (size_t)TILE_TREE_TILE_SIZE, bandStats);
+
+			numBands++;
+			numInterior += bandStats.interiorPixels;
+			numEscaped += bandStats.escapedPixels;
+			numConverged += bandStats.convergedPixels;
+
+			return bandIterations;
+		}, &stats);
+
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+		std::lock_guard<std::mutex> lock(renderMutex);
+
+		jobFrameStats.cpuSeconds += seconds;
+		jobFrameStats.pixels += numBands * (long long)TILE_TREE_BAND_HEIGHT * (long long)TILE_TREE_TILE_SIZE;
+		jobFrameStats.iterations += iterations;
+		jobFrameStats.interiorPixels += numInterior;
+		jobFrameStats.escapedPixels += numEscaped;
+		jobFrameStats.convergedPixels += numConverged;
+
+		if (statsEpoch != epoch)
+		{
+			statsEpoch = epoch;
+			jobMaxBusySeconds = 0.0;
+			jobMeanBusySeconds = 0.0;
+		}
+
+		jobMaxBusySeconds += stats.maxBusySeconds;
+		jobMeanBusySeconds += stats.meanBusySeconds;
+
+		//isWanted again, without taking the lock twice
+		bool cancelled = renderJobs.IsCancelled(epoch);
+
+		for (size_t i = 0; i < batch.size(); i++)
+		{
+			if (dropped[i] || (cancelled && !jobKeys.contains(keys[i])))
+				continue;
+
+			renderedTiles.push_back(std::move(rendered[i]));
+			renderedKeys.insert(keys[i]);
+		}
+
+		return nextTile < tiles.size();
+	}
+
+	//Least recently drawn first, never the ones drawn this frame
+	void FractalTileTree::EvictTiles()
+	{
+		if (memoryBytes <= TILE_TREE_MEMORY_BUDGET)
+			return;
+
+		std::vector<std::pair<long long, unsigned long long>> candidates;
+
+		for (const auto& [key, tile] : tiles)
+		{
+			if (tile.lastUsedFrame < frame)
+				candidates.emplace_back(tile.lastUsedFrame, key);
+		}
+
+		std::sort(candidates.begin(), candidates.end());
+
+		for (size_t i = 0; i < candidates.size() && memoryBytes > TILE_TREE_MEMORY_BUDGET; i++)
+		{
+			UnloadTexture(tiles[candidates[i].second].texture);
+			tiles.erase(candidates[i].second);
+
+			memoryBytes -= (long long)TILE_TREE_TILE_SIZE * (long long)TILE_TREE_TILE_SIZE * 4ll;
+		}
+	}
+	#pragma endregion
+
+	#pragma region Drawing
+	//source is in the tile's pixels, the fractal rect (left, bottom, right, top) is where it goes
+	void DrawTileTreeTexture(const Texture2D& texture, Rectangle source, const CPUFractalView& view, double left, double bottom, double right, double top)
+	{
+		double screenLeft = (left - view.originX) / view.stepX + 0.5;
+		double screenRight = (right - view.originX) / view.stepX + 0.5;
+		double screenTop = (top - view.originY) / view.stepY + 0.5;
+		double screenBottom = (bottom - view.originY) / view.stepY + 0.5;
+
+		//Flipped, the top of the tile is at the bottom of the screen
+		if (screenTop > screenBottom)
+			source.height = -source.height;
+
+		Rectangle dest = Rectangle{ (float)std::min(screenLeft, screenRight), (float)std::min(screenTop, screenBottom), (float)std::abs(screenRight - screenLeft), (float)std::abs(screenBottom - screenTop) };
+
+		DrawTexturePro(texture, source, dest, Vector2{ 0.0f, 0.0f }, 0.0f, WHITE);
+	}
+
+	void FractalTileTree::Draw(const FractalParameters& parameters, int width, int height, bool flipY) const
+	{
+		unsigned long long contentHash = GetTileTreeContentHash(parameters);
+		CPUFractalView view = GetCPUFractalView(parameters, width, height, false, flipY);
+
+		int level = GetViewLevel(parameters, height);
+		double tileSize = GetTileTreeTileSize(level);
+
+		TileTreeRange range = GetTileTreeRange(view, width, height, level);
+
+		for (long long y = range.minY; y <= range.maxY; y++)
+		{
+			for (long long x = range.minX; x <= range.maxX; x++)
+			{
+				double left = (double)x * tileSize;
+				double bottom = (double)y * tileSize;
+
+				const TileTreeTile* tile = FindTile(contentHash, level, x, y);
+
+				if (tile != nullptr)
+				{
+					DrawTileTreeTexture(tile->texture, Rectangle{ 0.0f, 0.0f, (float)TILE_TREE_TILE_SIZE, (float)TILE_TREE_TILE_SIZE }, view, left, bottom, left + tileSize, bottom + tileSize);
+					continue;
+				}
+
+				//The part of the closest level above that has the tile, scaled up
+				bool filled = false;
+
+				for (int levelsUp = 1; levelsUp <= TILE_TREE_FALLBACK_LEVELS && level - levelsUp >= TILE_TREE_MIN_LEVEL && !filled; levelsUp++)
+				{
+					const TileTreeTile* ancestor = FindTile(contentHash, level - levelsUp, x >> levelsUp, y >> levelsUp);
+
+					if (ancestor == nullptr)
+						continue;
+
+					long long cells = 1ll << levelsUp;
+					float cellSize = (float)TILE_TREE_TILE_SIZE / (float)cells;
+
+					//Rows go down in the texture, y goes up
+					long long cellX = x - (ancestor->x << levelsUp);
+					long long cellY = cells - 1 - (y - (ancestor->y << levelsUp));
+
+					DrawTileTreeTexture(ancestor->texture, Rectangle{ (float)cellX * cellSize, (float)cellY * cellSize, cellSize, cellSize }, view, left, bottom, left + tileSize, bottom + tileSize);
+					filled = true;
+				}
+
+				if (filled)
+					continue;
+
+				//Or the next level down's tiles, scaled down
+				for (int child = 0; child < 4; child++)
+				{
+					long long childX = x * 2 + (child & 1);
+					long long childY = y * 2 + (child >> 1);
+
+					const TileTreeTile* childTile = FindTile(contentHash, level + 1, childX, childY);
+
+					if (childTile == nullptr)
+						continue;
+
+					double childLeft = (double)childX * tileSize * 0.5;
+					double childBottom = (double)childY * tileSize * 0.5;
+
+					DrawTileTreeTexture(childTile->texture, Rectangle{ 0.0f, 0.0f, (float)TILE_TREE_TILE_SIZE, (float)TILE_TREE_TILE_SIZE }, view, childLeft, childBottom, childLeft + tileSize * 0.5, childBottom + tileSize * 0.5);
+				}
+			}
+		}
+	}
+	#pragma endregion
+
+	int FractalTileTree::GetNumTiles() const
+	{
+		return (int)tiles.size();
+	}
+
+	int FractalTileTree::GetNumWantedTiles() const
+	{
+		return (int)wantedTiles.size();
+	}
+
+	long long FractalTileTree::GetMemoryBytes() const
+	{
+		return memoryBytes;
+	}
+
+	bool FractalTileTree::IsRendering() const
+	{
+		return renderJobs.IsBusy();
+	}
+
+	float FractalTileTree::GetLoadImbalance() const
+	{
+		return loadImbalance;
+	}
+
+	const FractalRenderStats& FractalTileTree::GetFrameStats() const
+	{
+		return frameStats;
+	}
+
+	void FractalTileTree::Unload()
+	{
+		renderJobs.Cancel();
+
+		{
+			std::lock_guard<std::mutex> lock(renderMutex);
+
+			renderedTiles.clear();
+			renderedKeys.clear();
+			jobKeys.clear();
+
+			jobMaxBusySeconds = 0.0;
+			jobMeanBusySeconds = 0.0;
+
+			jobFrameStats = FractalRenderStats{ 0.0, -1.0, 0, 0, 0, 0, 0, false };
+		}
+
+		loadImbalance = 0.0f;
+		frameStats = FractalRenderStats{ 0.0, -1.0, 0, 0, 0, 0, 0, false };
+
+		for (auto& [key, tile] : tiles)
+			UnloadTexture(tile.texture);
+
+		tiles.clear();
+		wantedTiles.clear();
+
+		memoryBytes = 0;
+		publishedViewHash = 0;
+	}
+}
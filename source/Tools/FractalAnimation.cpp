@@ -0,0 +1,251 @@
+// FractalAnimation.cpp : Renders a keyframe file (see Animation.h) into a zoom animation, without a window.
+//
+// fractal_animation <keyframes.txt> [--size 1920x1080] [--fps 30] [--flip-y] [--exponential-map] [--output <directory> | --stdout]
+//
+// --exponential-map renders a zoom into a fixed point (keyframes that only change the zoom & iterations) once as a log-polar strip
+// & resamples every frame from it (see ExponentialMap.h)
+// --output writes frame-000001.png... (default: <keyframes>_frames), resuming where a stopped render left off
+// --stdout writes raw RGBA frames, for an encoder: fractal_animation zoom.txt --stdout | ffmpeg -f rawvideo -pix_fmt rgba -s 1920x1080 -r 30 -i - zoom.mp4
+
+#include <bit>
+#include <mutex>
+#include <chrono>
+#include <cstdio>
+#include <cstdarg>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <stdexcept>
+#include <algorithm>
+#include <filesystem>
+
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#endif
+
+#include "raylib.h"
+
+#include "Animation.h"
+#include "ExponentialMap.h"
+#include "CPUFractal.h"
+#include "RenderJournal.h"
+
+using namespace Explorer;
+
+//raylib logs to stdout, which may be the video
+void LogToStandardError(int logLevel, const char* text, va_list arguments)
+{
+	std::vfprintf(stderr, text, arguments);
+	std::fputc('\n', stderr);
+}
+
+unsigned long long GetAnimationHash(const std::vector<FractalKeyframe>& keyframes, const FractalAnimationSettings& settings, bool exponentialMap)
+{
+	unsigned long long hash = HashFractalParameters(FractalParameters());
+
+	for (const FractalKeyframe& keyframe : keyframes)
+	{
+		hash = HashFractalValue(hash, HashFractalParameters(keyframe.parameters));
+		hash = HashFractalValue(hash, std::bit_cast<unsigned long long>(keyframe.time));
+	}
+
+	hash = HashFractalValue(hash, (unsigned long long)settings.width);
+	hash = HashFractalValue(hash, (unsigned long long)settings.height);
+	hash = HashFractalValue(hash, std::bit_cast<unsigned long long>(settings.framesPerSecond));
+	hash = HashFractalValue(hash, settings.flipY ? 1ull : 0ull);
+	hash = HashFractalValue(hash, exponentialMap ? 1ull : 0ull);
+
+	return hash;
+}
+
+//The strip from the lowest to the highest zoom of all keyframes, with the most iterations of any keyframe
+void RenderExponentialMap(ExponentialMap& map, const std::vector<FractalKeyframe>& keyframes, const FractalAnimationSettings& settings)
+{
+	FractalParameters parameters = keyframes.front().parameters;
+
+	//A keyframe in the middle can zoom past the first & last ones, the strip spans every keyframe's zoom
+	float minZoom = parameters.zoom;
+	float maxZoom = parameters.zoom;
+
+	for (const FractalKeyframe& keyframe : keyframes)
+	{
+		FractalParameters zoomOnly = keyframe.parameters;
+		zoomOnly.zoom = parameters.zoom;
+		zoomOnly.maxIterations = parameters.maxIterations;
+
+		if (!AreFractalParametersEqual(zoomOnly, parameters))
+			throw std::runtime_error("--exponential-map needs keyframes that only change the zoom & iterations");
+
+		parameters.maxIterations = std::max(parameters.maxIterations, keyframe.parameters.maxIterations);
+
+		minZoom = std::min(minZoom, keyframe.parameters.zoom);
+		maxZoom = std::max(maxZoom, keyframe.parameters.zoom);
+	}
+
+	parameters.zoom = minZoom;
+
+	if (!FractalSupportsExponentialMap(parameters.type))
+		throw std::runtime_error(std::string("--exponential-map doesn't support the ") + GetFractalName(parameters.type));
+
+	auto startTime = std::chrono::steady_clock::now();
+
+	map.Render(parameters, maxZoom, settings.width, settings.height, settings.flipY);
+
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+	std::fprintf(stderr, "Rendered the exponential map (%dx%d samples) in %.2f s\n", map.GetNumAngles(), map.GetNumRadii(), seconds);
+}
+
+int main(int argc, char** argv)
+{
+	SetTraceLogCallback(LogToStandardError);
+	SetTraceLogLevel(LOG_WARNING);
+
+	if (argc < 2)
+	{
+		std::cerr << "Usage: fractal_animation <keyframes.txt> [--size 1920x1080] [--fps 30] [--flip-y] [--exponential-map] [--output <directory> | --stdout]" << std::endl;
+		return 1;
+	}
+
+	std::string keyframesFileName = argv[1];
+
+	FractalAnimationSettings settings = FractalAnimationSettings{ 1920, 1080, 30.0, false, false };
+
+	bool toStandardOutput = false;
+	bool exponentialMap = false;
+	std::string outputDirectory = std::filesystem::path(keyframesFileName).replace_extension().string() + "_frames";
+
+	try
+	{
+		for (int i = 2; i < argc; i++)
+		{
+			std::string argument = argv[i];
+			bool hasValue = i + 1 < argc;
+
+			if (argument == "--size" && hasValue && std::sscanf(argv[i + 1], "%dx%d", &settings.width, &settings.height) == 2)
+				i++;
+			else if (argument == "--fps" && hasValue)
+				settings.framesPerSecond = std::stod(argv[++i]);
+			else if (argument == "--flip-y")
+				settings.flipY = true;
+			else if (argument == "--output" && hasValue)
+				outputDirectory = argv[++i];
+			else if (argument == "--stdout")
+				toStandardOutput = true;
+			else if (argument == "--exponential-map")
+				exponentialMap = true;
+			else
+				throw std::runtime_error("Unknown argument " + argument);
+		}
+
+		if (settings.width <= 0 || settings.height <= 0 || settings.framesPerSecond <= 0.0)
+			throw std::runtime_error("Invalid size or fps");
+
+		std::vector<FractalKeyframe> keyframes = LoadFractalKeyframes(keyframesFileName);
+
+		if (keyframes.empty())
+			throw std::runtime_error("No keyframes in " + keyframesFileName);
+
+		int numFrames = GetFractalAnimationNumFrames(keyframes, settings);
+
+		ExponentialMap map;
+
+		if (exponentialMap)
+			RenderExponentialMap(map, keyframes, settings);
+
+		//Frames written in order for the encoder, or as they're done into files
+		settings.ordered = toStandardOutput;
+
+		//Guards the journal & numFailed
+		std::mutex journalMutex;
+		RenderJournal journal;
+
+		int numFailed = 0;
+
+		if (toStandardOutput)
+		{
+#ifdef _WIN32
+			_setmode(_fileno(stdout), _O_BINARY);
+#endif
+		}
+		else
+		{
+			std::filesystem::create_directories(outputDirectory);
+
+			//Every frame is a tile of the journal, so a stopped render only renders the frames that aren't written yet
+			if (journal.Open((std::filesystem::path(outputDirectory) / "frames.journal").string(), GetAnimationHash(keyframes, settings, exponentialMap)))
+				std::cerr << "Resuming, " << journal.GetNumFinishedTiles() << " frames are already done" << std::endl;
+		}
+
+		std::cerr << "Rendering " << numFrames << " frames (" << settings.width << "x" << settings.height << ", " << GetCPUFractalNumThreads() << " threads)" << std::endl;
+
+		auto startTime = std::chrono::steady_clock::now();
+		auto lastReportTime = startTime;
+
+		int numRendered = RenderFractalAnimation(keyframes, settings, [&](int frame)
+		{
+			std::lock_guard<std::mutex> lock(journalMutex);
+			return !toStandardOutput && journal.IsTileFinished(frame);
+		},
+		[&](int frame, const Image& image)
+		{
+			if (toStandardOutput)
+			{
+				std::fwrite(image.data, 4, (size_t)image.width * (size_t)image.height, stdout);
+				return;
+			}
+
+			char frameFileName[32];
+			std::snprintf(frameFileName, sizeof(frameFileName), "frame-%06d.png", frame + 1);
+
+			std::string framePath = (std::filesystem::path(outputDirectory) / frameFileName).string();
+
+			bool exported = ExportImage(image, framePath.c_str());
+
+			std::lock_guard<std::mutex> lock(journalMutex);
+
+			if (exported)
+			{
+				journal.FinishTile(frame, frameFileName);
+			}
+			else
+			{
+				std::cerr << "Failed to write " << framePath << std::endl;
+				numFailed++;
+			}
+		},
+		[&](int framesDone)
+		{
+			//Throughput about once a second
+			auto now = std::chrono::steady_clock::now();
+
+			if (now - lastReportTime < std::chrono::seconds(1) && framesDone < numFrames)
+				return;
+
+			double seconds = std::chrono::duration<double>(now - startTime).count();
+			lastReportTime = now;
+
+			std::fprintf(stderr, "%d/%d frames, %.2f fps\n", framesDone, numFrames, (double)framesDone / seconds);
+		},
+		exponentialMap ? [&](const FractalParameters& parameters, Color* pixels) { map.ResampleFrame(parameters.zoom, pixels); } : std::function<void(const FractalParameters&, Color*)>());
+
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+		std::fprintf(stderr, "Rendered %d frames in %.2f s (%.2f fps)\n", numRendered, seconds, (double)numRendered / seconds);
+
+		std::fflush(stdout);
+
+		//Kept for the next run to render the missing frames
+		if (numFailed > 0)
+			throw std::runtime_error(std::to_string(numFailed) + " frames failed to be written");
+
+		if (!toStandardOutput)
+			journal.Remove();
+	}
+	catch (std::exception& ex)
+	{
+		std::cerr << ex.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,392 @@
+// FractalBench.cpp : Measures the CPU kernels (see CPUFractal.h) of every fractal type, without a window.
+//
+// fractal_bench [--size 320x180] [--repetitions 9] [--min-seconds 0.05] [--types multibrot,julia] [--output bench.json]
+//
+// Every fractal type renders the default view, a view mostly on the boundary of the set & a view mostly inside it (inside the basins
+// for newton fractals), plus the default view at a fractional power for the types with a power (the only kernel iterating in lanes),
+// with every kernel variant: float & double, exact & fast math, & each lane width where there are lanes.
+// A repetition renders the view on one thread as many times as fit in min-seconds (at least once), the median repetition is reported
+// with the spread of all of them. The results are written as JSON, to track regressions between builds on the same machine
+
+#include <cmath>
+#include <chrono>
+#include <cstdio>
+#include <cstdarg>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <algorithm>
+
+#include "raylib.h"
+
+#include "CPUFractal.h"
+#include "RenderStats.h"
+
+using namespace Explorer;
+
+void LogToStandardError(int logLevel, const char* text, va_list arguments)
+{
+	std::vfprintf(stderr, text, arguments);
+	std::fputc('\n', stderr);
+}
+
+//Short names for --types & the JSON, in FractalType order
+const char* BENCH_FRACTAL_NAMES[NUM_FRACTAL_TYPES] =
+{
+	"multibrot", "multicorn", "burning_ship", "julia", "newton_3", "newton_4", "newton_5", "newton_sin", "polynomial_2", "polynomial_3"
+};
+
+struct BenchView
+{
+	std::string name;
+	FractalParameters parameters;
+};
+
+struct BenchResult
+{
+	FractalType type;
+	std::string view;
+	FractalParameters parameters;
+
+	CPUFractalPrecision precision;
+	bool fastMath;
+
+	//0 if the kernel doesn't iterate in lanes
+	int lanes;
+
+	long long pixels;
+	long long iterations;
+	FractalRenderStats classes;
+
+	int rendersPerRepetition;
+
+	//Per render, sorted
+	std::vector<double> repetitionSeconds;
+};
+
+FractalParameters GetBenchDefaultParameters(FractalType type)
+{
+	//The explorer's defaults (see ResetFractalParameters), newton & polynomial roots are the roots of z^n - 1
+	FractalParameters parameters;
+
+	parameters.type = type;
+	parameters.position = Vector2{ 0.0f, 0.0f };
+	parameters.zoom = 0.5f;
+	parameters.maxIterations = 256;
+	parameters.power = 2.0f;
+	parameters.c = Vector2{ 0.0f, 0.0f };
+	parameters.a = Vector2{ 1.0f, 0.0f };
+
+	int numRoots = GetFractalNumRoots(type);
+
+	for (int i = 0; i < numRoots; i++)
+	{
+		double angle = 2.0 * 3.14159265358979323846 * (double)i / (double)numRoots;
+		parameters.roots[i] = Vector2{ (float)std::cos(angle), (float)std::sin(angle) };
+	}
+
+	return parameters;
+}
+
+std::vector<BenchView> GetBenchViews(FractalType type)
+{
+	FractalParameters defaultView = GetBenchDefaultParameters(type);
+
+	FractalParameters boundary = defaultView;
+	FractalParameters interior = defaultView;
+
+	//Boundary views have the slowest escaping (or converging) pixels, interior views are all inside the set (or converge right away)
+	switch (type)
+	{
+		case FRACTAL_MULTIBROT:
+			boundary.position = Vector2{ -0.7436f, 0.1318f };
+			boundary.zoom = 40.0f;
+			interior.position = Vector2{ -0.25f, 0.0f };
+			interior.zoom = 2.0f;
+			break;
+		case FRACTAL_MULTICORN:
+			boundary.position = Vector2{ 0.3f, -0.5f };
+			interior.position = Vector2{ 0.1f, 0.2f };
+			break;
+		case FRACTAL_BURNING_SHIP:
+			boundary.position = Vector2{ -0.4f, -0.9f };
+			interior.position = Vector2{ -0.3f, -0.25f };
+			break;
+		case FRACTAL_JULIA:
+			boundary.position = Vector2{ -0.1f, -0.2f };
+			boundary.c = Vector2{ -0.8f, 0.156f };
+			interior.position = Vector2{ -0.6f, 0.6f };
+			interior.c = Vector2{ -0.12f, 0.75f };
+			break;
+		case FRACTAL_NEWTON_3DEG:
+			boundary.position = Vector2{ -1.1f, -0.5f };
+			interior.position = defaultView.roots[0];
+			break;
+		case FRACTAL_NEWTON_4DEG:
+		case FRACTAL_NEWTON_5DEG:
+			boundary.position = Vector2{ 0.0f, 0.0f };
+			interior.position = defaultView.roots[0];
+			break;
+		case FRACTAL_NEWTON_SIN:
+			//Between the roots 0 & -pi
+			boundary.position = Vector2{ -1.6f, 0.0f };
+			interior.position = Vector2{ 0.0f, 0.0f };
+			break;
+		case FRACTAL_POLYNOMIAL_2DEG:
+			boundary.position = Vector2{ 1.1f, 0.6f };
+			interior.position = Vector2{ 1.0f, 0.5f };
+			break;
+		case FRACTAL_POLYNOMIAL_3DEG:
+			boundary.position = Vector2{ 1.3f, -0.7f };
+			interior.position = Vector2{ 1.0f, 0.7f };
+			break;
+		default: //Or FRACTAL_UNKNOWN
+			break;
+	}
+
+	if (type != FRACTAL_MULTIBROT)
+	{
+		boundary.zoom = 8.0f;
+		interior.zoom = 8.0f;
+	}
+
+	std::vector<BenchView> views = { BenchView{ "default", defaultView }, BenchView{ "boundary", boundary }, BenchView{ "interior", interior } };
+
+	if (FractalSupportsPower(type))
+	{
+		FractalParameters fractionalPower = defaultView;
+		fractionalPower.power = 2.5f;
+
+		views.push_back(BenchView{ "fractional_power", fractionalPower });
+	}
+
+	return views;
+}
+
+double GetMedian(const std::vector<double>& sortedValues)
+{
+	size_t middle = sortedValues.size() / 2;
+	return sortedValues.size() % 2 == 1 ? sortedValues[middle] : 0.5 * (sortedValues[middle - 1] + sortedValues[middle]);
+}
+
+//Median absolute deviation over the median
+double GetRelativeSpread(const std::vector<double>& sortedValues)
+{
+	double median = GetMedian(sortedValues);
+
+	std::vector<double> deviations;
+
+	for (double value : sortedValues)
+		deviations.push_back(std::fabs(value - median));
+
+	std::sort(deviations.begin(), deviations.end());
+
+	return median > 0.0 ? GetMedian(deviations) / median : 0.0;
+}
+
+BenchResult RunBench(FractalType type, const BenchView& view, CPUFractalPrecision precision, bool fastMath, int lanes, int width, int height, int repetitions, double minSeconds)
+{
+	BenchResult result = {};
+
+	result.type = type;
+	result.view = view.name;
+	result.parameters = view.parameters;
+	result.parameters.fastMath = fastMath;
+	result.precision = precision;
+	result.fastMath = fastMath;
+	result.lanes = lanes;
+
+	std::vector<Color> pixels((size_t)width * (size_t)height);
+	CPUFractalView cpuView = GetCPUFractalView(result.parameters, width, height, false, false);
+
+	auto render = [&]()
+	{
+		return RenderFractalRectCPUVariant(result.parameters, cpuView, precision, std::max(lanes, 1), pixels.data(), width, 0, 0, width, height);
+	};
+
+	//Warm up, & times one render to pick how many fit in a repetition
+	auto startTime = std::chrono::steady_clock::now();
+	result.iterations = render();
+	double warmUpSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+	result.pixels = (long long)pixels.size();
+	result.classes = FractalRenderStats{ -1.0, -1.0, result.pixels, result.iterations, 0, 0, 0, false };
+	CountFractalPixelClasses(type, pixels.data(), pixels.size(), result.classes);
+
+	result.rendersPerRepetition = std::max((int)std::ceil(minSeconds / std::max(warmUpSeconds, 1e-6)), 1);
+
+	for (int repetition = 0; repetition < repetitions; repetition++)
+	{
+		startTime = std::chrono::steady_clock::now();
+
+		for (int i = 0; i < result.rendersPerRepetition; i++)
+			render();
+
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+		result.repetitionSeconds.push_back(seconds / (double)result.rendersPerRepetition);
+	}
+
+	std::sort(result.repetitionSeconds.begin(), result.repetitionSeconds.end());
+
+	return result;
+}
+
+void WriteBenchResults(const std::string& fileName, const std::vector<BenchResult>& results, int width, int height, int repetitions, double minSeconds)
+{
+	std::ofstream file(fileName);
+	file.precision(9);
+
+	file << "{\n";
+	file << "\t\"width\": " << width << ",\n";
+	file << "\t\"height\": " << height << ",\n";
+	file << "\t\"threads\": 1,\n";
+	file << "\t\"repetitions\": " << repetitions << ",\n";
+	file << "\t\"minSeconds\": " << minSeconds << ",\n";
+	file << "\t\"results\": [\n";
+
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		const BenchResult& result = results[i];
+		const FractalParameters& parameters = result.parameters;
+
+		double pixels = (double)result.pixels;
+		double medianSeconds = GetMedian(result.repetitionSeconds);
+
+		file << "\t\t{ \"fractal\": \"" << BENCH_FRACTAL_NAMES[result.type] << "\", \"view\": \"" << result.view << "\"";
+		file << ", \"precision\": \"" << GetCPUFractalPrecisionName(result.precision) << "\", \"fastMath\": " << (result.fastMath ? "true" : "false") << ", \"lanes\": " << result.lanes;
+		file << ", \"x\": " << parameters.position.x << ", \"y\": " << parameters.position.y << ", \"zoom\": " << parameters.zoom << ", \"power\": " << parameters.power << ", \"maxIterations\": " << parameters.maxIterations;
+		file << ", \"iterationsPerPixel\": " << (double)result.iterations / pixels;
+		file << ", \"escaped\": " << (double)result.classes.escapedPixels / pixels << ", \"interior\": " << (double)result.classes.interiorPixels / pixels << ", \"converged\": " << (double)result.classes.convergedPixels / pixels;
+		file << ", \"rendersPerRepetition\": " << result.rendersPerRepetition;
+		file << ", \"medianMs\": " << medianSeconds * 1000.0 << ", \"minMs\": " << result.repetitionSeconds.front() * 1000.0 << ", \"maxMs\": " << result.repetitionSeconds.back() * 1000.0;
+		file << ", \"relativeSpread\": " << GetRelativeSpread(result.repetitionSeconds);
+		file << ", \"mpixelsPerSecond\": " << pixels / medianSeconds / 1e6 << ", \"miterPerSecond\": " << (double)result.iterations / medianSeconds / 1e6 << " }";
+		file << (i + 1 < results.size() ? "," : "") << "\n";
+	}
+
+	file << "\t]\n";
+	file << "}\n";
+
+	if (!file)
+		throw std::runtime_error("Failed to write " + fileName);
+}
+
+std::vector<FractalType> ParseBenchTypes(const std::string& text)
+{
+	std::vector<FractalType> types;
+	size_t start = 0;
+
+	while (start <= text.size())
+	{
+		size_t end = std::min(text.find(',', start), text.size());
+		std::string name = text.substr(start, end - start);
+
+		auto found = std::find_if(std::begin(BENCH_FRACTAL_NAMES), std::end(BENCH_FRACTAL_NAMES), [&](const char* benchName) { return name == benchName; });
+
+		if (found == std::end(BENCH_FRACTAL_NAMES))
+			throw std::runtime_error("Unknown fractal " + name + ", the fractals are multibrot, multicorn, burning_ship, julia, newton_3, newton_4, newton_5, newton_sin, polynomial_2 & polynomial_3");
+
+		types.push_back((FractalType)(found - std::begin(BENCH_FRACTAL_NAMES)));
+		start = end + 1;
+	}
+
+	return types;
+}
+
+int main(int argc, char** argv)
+{
+	SetTraceLogCallback(LogToStandardError);
+	SetTraceLogLevel(LOG_WARNING);
+
+	int width = 320;
+	int height = 180;
+	int repetitions = 9;
+	double minSeconds = 0.05;
+	std::string outputFileName = "fractal_bench.json";
+
+	std::vector<FractalType> types;
+
+	for (int i = 0; i < NUM_FRACTAL_TYPES; i++)
+		types.push_back((FractalType)i);
+
+	try
+	{
+		for (int i = 1; i < argc; i++)
+		{
+			std::string argument = argv[i];
+			bool hasValue = i + 1 < argc;
+
+			if (argument == "--size" && hasValue && std::sscanf(argv[i + 1], "%dx%d", &width, &height) == 2)
+				i++;
+			else if (argument == "--repetitions" && hasValue)
+				repetitions = std::max(std::stoi(argv[++i]), 1);
+			else if (argument == "--min-seconds" && hasValue)
+				minSeconds = std::max(std::stod(argv[++i]), 0.0);
+			else if (argument == "--types" && hasValue)
+				types = ParseBenchTypes(argv[++i]);
+			else if (argument == "--output" && hasValue)
+				outputFileName = argv[++i];
+			else
+				throw std::runtime_error("Unknown argument " + argument + "\nUsage: fractal_bench [--size 320x180] [--repetitions 9] [--min-seconds 0.05] [--types multibrot,julia] [--output bench.json]");
+		}
+
+		if (width <= 0 || height <= 0)
+			throw std::runtime_error("Invalid size");
+
+		std::vector<BenchResult> results;
+
+		std::fprintf(stderr, "%-13s %-17s %-7s %-5s %5s %9s %9s %7s %8s\n", "fractal", "view", "prec", "fast", "lanes", "Mpix/s", "Miter/s", "it/px", "spread");
+
+		for (FractalType type : types)
+		{
+			for (const BenchView& view : GetBenchViews(type))
+			{
+				for (int precisionIndex = 0; precisionIndex < NUM_CPU_FRACTAL_PRECISIONS; precisionIndex++)
+				{
+					CPUFractalPrecision precision = (CPUFractalPrecision)precisionIndex;
+
+					for (bool fastMath : { false, true })
+					{
+						if (fastMath && !FractalSupportsFastMath(type))
+							continue;
+
+						FractalParameters parameters = view.parameters;
+						parameters.fastMath = fastMath;
+
+						//Lanes are a float kernel, every width is measured
+						std::vector<int> laneWidths = { 0 };
+
+						if (precision == CPU_FRACTAL_FLOAT && CPUFractalUsesLanes(parameters))
+							laneWidths.assign(std::begin(CPU_FRACTAL_LANE_WIDTHS), std::end(CPU_FRACTAL_LANE_WIDTHS));
+
+						for (int lanes : laneWidths)
+						{
+							BenchResult result = RunBench(type, view, precision, fastMath, lanes, width, height, repetitions, minSeconds);
+
+							double medianSeconds = GetMedian(result.repetitionSeconds);
+
+							std::fprintf(stderr, "%-13s %-17s %-7s %-5s %5d %9.2f %9.1f %7.1f %7.1f%%\n", BENCH_FRACTAL_NAMES[type], view.name.c_str(), GetCPUFractalPrecisionName(precision),
+								fastMath ? "yes" : "no", lanes, (double)result.pixels / medianSeconds / 1e6, (double)result.iterations / medianSeconds / 1e6,
+								(double)result.iterations / (double)result.pixels, GetRelativeSpread(result.repetitionSeconds) * 100.0);
+
+							results.push_back(result);
+						}
+					}
+				}
+			}
+		}
+
+		WriteBenchResults(outputFileName, results, width, height, repetitions, minSeconds);
+
+		std::cerr << "Wrote " << results.size() << " results to " << outputFileName << std::endl;
+	}
+	catch (std::exception& ex)
+	{
+		std::cerr << ex.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
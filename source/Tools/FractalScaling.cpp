@@ -0,0 +1,463 @@
+// FractalScaling.cpp : Measures how full CPU renders scale with threads, image size, iterations & tile size, without a window.
+//
+// fractal_scaling [--view view.txt] [--threads 1,2,4] [--sizes 1080p,4k,8k,16k] [--iterations 256,1024] [--tile-sizes 64,256,1024]
+//                 [--repetitions 3] [--output scaling.json] [--baseline baseline.json] [--threshold 0.1]
+//
+// Every combination renders the whole image into memory, a tile per item on the CPU renderers' threads (RunOnAllThreads, like the tile renderers),
+// the median of the repetitions' wall times is reported with the speed-up & parallel efficiency over the fewest threads of the same
+// size, iterations & tile size, & the peak resident memory of the render (of the process so far where it can't be reset, on all but linux)
+// Sizes are 1080p, 1440p, 4k, 8k, 16k or <width>x<height>, threads default to powers of 2 up to the hardware threads
+// view.txt is a keyframe file (see Animation.h), its first keyframe is rendered (default: the whole mandelbrot set), at each --iterations
+// --baseline compares the results to an earlier output of the same sweep: a render slower (or using more memory) than the baseline
+// by more than --threshold is a regression, & the run exits with 2 (1 if the baseline has none of the sweep's runs)
+
+#include <cmath>
+#include <chrono>
+#include <cstdio>
+#include <cstdarg>
+#include <string>
+#include <vector>
+#include <limits>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <algorithm>
+
+#include "raylib.h"
+
+#include "Animation.h"
+#include "CPUFractal.h"
+#include "ProcessMemory.h"
+
+using namespace Explorer;
+
+void LogToStandardError(int logLevel, const char* text, va_list arguments)
+{
+	std::vfprintf(stderr, text, arguments);
+	std::fputc('\n', stderr);
+}
+
+struct ScalingRun
+{
+	int width;
+	int height;
+	int maxIterations;
+	int tileSize;
+	int threads;
+
+	//Per render, sorted
+	std::vector<double> repetitionSeconds;
+
+	long long iterations;
+
+	//-1 if it can't be read
+	long long peakResidentBytes;
+
+	//Over the run with the fewest threads of the same size, iterations & tile size
+	double speedUp;
+	double efficiency;
+};
+
+double GetMedian(const std::vector<double>& sortedValues)
+{
+	size_t middle = sortedValues.size() / 2;
+	return sortedValues.size() % 2 == 1 ? sortedValues[middle] : 0.5 * (sortedValues[middle - 1] + sortedValues[middle]);
+}
+
+std::vector<std::string> SplitList(const std::string& text)
+{
+	std::vector<std::string> items;
+	size_t start = 0;
+
+	while (start <= text.size())
+	{
+		size_t end = std::min(text.find(',', start), text.size());
+		items.push_back(text.substr(start, end - start));
+
+		start = end + 1;
+	}
+
+	return items;
+}
+
+std::vector<int> ParseIntegerList(const std::string& text, const std::string& argument)
+{
+	std::vector<int> values;
+
+	for (const std::string& item : SplitList(text))
+	{
+		int value = 0;
+
+		if (std::sscanf(item.c_str(), "%d", &value) != 1 || value <= 0)
+			throw std::runtime_error("Invalid " + argument + " " + item);
+
+		values.push_back(value);
+	}
+
+	return values;
+}
+
+//1080p, 1440p, 4k, 8k, 16k or <width>x<height>
+std::vector<std::pair<int, int>> ParseSizeList(const std::string& text)
+{
+	std::vector<std::pair<int, int>> sizes;
+
+	for (const std::string& item : SplitList(text))
+	{
+		int width = 0;
+		int height = 0;
+
+		if (item == "1080p")
+			sizes.push_back({ 1920, 1080 });
+		else if (item == "1440p")
+			sizes.push_back({ 2560, 1440 });
+		else if (item == "4k")
+			sizes.push_back({ 3840, 2160 });
+		else if (item == "8k")
+			sizes.push_back({ 7680, 4320 });
+		else if (item == "16k")
+			sizes.push_back({ 15360, 8640 });
+		else if (std::sscanf(item.c_str(), "%dx%d", &width, &height) == 2 && width > 0 && height > 0)
+			sizes.push_back({ width, height });
+		else
+			throw std::runtime_error("Invalid size " + item + ", sizes are 1080p, 1440p, 4k, 8k, 16k or <width>x<height>");
+	}
+
+	return sizes;
+}
+
+//Identifies the view in baselines, without the iterations (they're swept)
+unsigned long long GetScalingViewHash(const FractalParameters& parameters)
+{
+	FractalParameters view = parameters;
+	view.maxIterations = 0;
+
+	return HashFractalParameters(view);
+}
+
+//Renders the whole image once per repetition, tileSize x tileSize tiles handed out to the threads
+void RunScaling(const FractalParameters& parameters, ScalingRun& run, int repetitions)
+{
+	ResetPeakResidentBytes();
+	SetCPUFractalNumThreads(run.threads);
+
+	//Zeroed, so its pages are resident before the first render is timed
+	std::vector<Color> pixels((size_t)run.width * (size_t)run.height);
+
+	CPUFractalView view = GetCPUFractalView(parameters, run.width, run.height, false, false);
+
+	int numTilesX = (run.width + run.tileSize - 1) / run.tileSize;
+	int numTilesY = (run.height + run.tileSize - 1) / run.tileSize;
+
+	for (int repetition = 0; repetition < repetitions; repetition++)
+	{
+		auto startTime = std::chrono::steady_clock::now();
+
+		run.iterations = RunOnAllThreads(numTilesX * numTilesY, [&](int tile)
+		{
+			int x = (tile % numTilesX) * run.tileSize;
+			int y = (tile / numTilesX) * run.tileSize;
+
+			return RenderFractalRectCPU(parameters, view, pixels.data(), run.width, x, y, std::min(run.tileSize, run.width - x), std::min(run.tileSize, run.height - y));
+		});
+
+		run.repetitionSeconds.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count());
+	}
+
+	std::sort(run.repetitionSeconds.begin(), run.repetitionSeconds.end());
+
+	run.peakResidentBytes = GetPeakResidentBytes();
+
+	SetCPUFractalNumThreads(0);
+}
+
+void WriteScalingResults(const std::string& fileName, const FractalParameters& parameters, const std::vector<ScalingRun>& runs, int repetitions, bool peakPerRun)
+{
+	std::ofstream file(fileName);
+	file.precision(9);
+
+	file << "{\n";
+	file << "\t\"fractal\": \"" << GetFractalName(parameters.type) << "\",\n";
+	file << "\t\"viewHash\": \"" << std::hex << GetScalingViewHash(parameters) << std::dec << "\",\n";
+	file << "\t\"hardwareThreads\": " << GetCPUFractalNumThreads() << ",\n";
+	file << "\t\"repetitions\": " << repetitions << ",\n";
+	file << "\t\"peakPerRun\": " << (peakPerRun ? "true" : "false") << ",\n";
+	file << "\t\"results\": [\n";
+
+	//A run per line, read back by LoadScalingBaseline
+	for (size_t i = 0; i < runs.size(); i++)
+	{
+		const ScalingRun& run = runs[i];
+		double seconds = GetMedian(run.repetitionSeconds);
+
+		file << "\t\t{ \"width\": " << run.width << ", \"height\": " << run.height << ", \"maxIterations\": " << run.maxIterations;
+		file << ", \"tileSize\": " << run.tileSize << ", \"threads\": " << run.threads;
+		file << ", \"seconds\": " << seconds << ", \"minSeconds\": " << run.repetitionSeconds.front() << ", \"maxSeconds\": " << run.repetitionSeconds.back();
+		file << ", \"speedUp\": " << run.speedUp << ", \"efficiency\": " << run.efficiency;
+		file << ", \"mpixelsPerSecond\": " << (double)run.width * (double)run.height / seconds / 1e6 << ", \"miterPerSecond\": " << (double)run.iterations / seconds / 1e6;
+		file << ", \"peakResidentMB\": ";
+
+		if (run.peakResidentBytes >= 0)
+			file << (double)run.peakResidentBytes / (1024.0 * 1024.0);
+		else
+			file << "null";
+
+		file << " }" << (i + 1 < runs.size() ? "," : "") << "\n";
+	}
+
+	file << "\t]\n";
+	file << "}\n";
+
+	if (!file)
+		throw std::runtime_error("Failed to write " + fileName);
+}
+
+//The number after "key": on the line, NaN if there's none (or it's null)
+double FindJSONNumber(const std::string& line, const std::string& key)
+{
+	size_t position = line.find("\"" + key + "\":");
+
+	if (position == std::string::npos)
+		return std::numeric_limits<double>::quiet_NaN();
+
+	double value = 0.0;
+
+	if (std::sscanf(line.c_str() + position + key.size() + 3, "%lf", &value) != 1)
+		return std::numeric_limits<double>::quiet_NaN();
+
+	return value;
+}
+
+std::string FindJSONString(const std::string& line, const std::string& key)
+{
+	size_t position = line.find("\"" + key + "\": \"");
+
+	if (position == std::string::npos)
+		return "";
+
+	size_t start = position + key.size() + 5;
+	return line.substr(start, line.find('"', start) - start);
+}
+
+struct ScalingBaselineRun
+{
+	int width;
+	int height;
+	int maxIterations;
+	int tileSize;
+	int threads;
+
+	double seconds;
+
+	//NaN if it wasn't known
+	double peakResidentMB;
+};
+
+//Runs of a file written by WriteScalingResults, throws std::runtime_error if it can't be read or is of another view
+std::vector<ScalingBaselineRun> LoadScalingBaseline(const std::string& fileName, const FractalParameters& parameters)
+{
+	std::ifstream file(fileName);
+
+	if (!file)
+		throw std::runtime_error("Failed to open " + fileName);
+
+	char viewHash[32] = {};
+	std::snprintf(viewHash, sizeof(viewHash), "%llx", GetScalingViewHash(parameters));
+
+	std::vector<ScalingBaselineRun> runs;
+	std::string line;
+
+	while (std::getline(file, line))
+	{
+		std::string baselineHash = FindJSONString(line, "viewHash");
+
+		if (!baselineHash.empty() && baselineHash != viewHash)
+			throw std::runtime_error(fileName + " is a baseline of another view");
+
+		double seconds = FindJSONNumber(line, "seconds");
+
+		if (std::isnan(seconds))
+			continue;
+
+		runs.push_back(ScalingBaselineRun{ (int)FindJSONNumber(line, "width"), (int)FindJSONNumber(line, "height"), (int)FindJSONNumber(line, "maxIterations"),
+			(int)FindJSONNumber(line, "tileSize"), (int)FindJSONNumber(line, "threads"), seconds, FindJSONNumber(line, "peakResidentMB") });
+	}
+
+	return runs;
+}
+
+//Prints the runs slower (or using more memory) than their baseline by more than threshold, returns how many there are,
+//throws std::runtime_error if the baseline has none of the runs (a different sweep checks nothing)
+int CompareScalingBaseline(const std::vector<ScalingRun>& runs, const std::vector<ScalingBaselineRun>& baseline, double threshold)
+{
+	int numRegressions = 0;
+	int numCompared = 0;
+
+	for (const ScalingRun& run : runs)
+	{
+		auto found = std::find_if(baseline.begin(), baseline.end(), [&](const ScalingBaselineRun& baselineRun)
+		{
+			return baselineRun.width == run.width && baselineRun.height == run.height && baselineRun.maxIterations == run.maxIterations
+				&& baselineRun.tileSize == run.tileSize && baselineRun.threads == run.threads;
+		});
+
+		if (found == baseline.end())
+			continue;
+
+		numCompared++;
+
+		double seconds = GetMedian(run.repetitionSeconds);
+		double timeRatio = seconds / found->seconds;
+
+		double peakResidentMB = run.peakResidentBytes >= 0 ? (double)run.peakResidentBytes / (1024.0 * 1024.0) : std::numeric_limits<double>::quiet_NaN();
+		double memoryRatio = peakResidentMB / found->peakResidentMB;
+
+		bool slower = timeRatio > 1.0 + threshold;
+		bool larger = !std::isnan(memoryRatio) && memoryRatio > 1.0 + threshold;
+
+		if (!slower && !larger)
+			continue;
+
+		std::fprintf(stderr, "Regression: %dx%d, %d iterations, %d tiles, %d threads: %.3f s (baseline %.3f s, %+.1f%%), %.0f MB (baseline %.0f MB)\n",
+			run.width, run.height, run.maxIterations, run.tileSize, run.threads, seconds, found->seconds, (timeRatio - 1.0) * 100.0, peakResidentMB, found->peakResidentMB);
+
+		numRegressions++;
+	}
+
+	if (numCompared == 0)
+		throw std::runtime_error("The baseline has none of this sweep's runs (sizes, iterations, tile sizes & threads), nothing was compared");
+
+	std::fprintf(stderr, "Compared %d runs to the baseline (threshold %.0f%%): %d regressions\n", numCompared, threshold * 100.0, numRegressions);
+
+	return numRegressions;
+}
+
+int main(int argc, char** argv)
+{
+	SetTraceLogCallback(LogToStandardError);
+	SetTraceLogLevel(LOG_WARNING);
+
+	FractalParameters parameters;
+	parameters.type = FRACTAL_MULTIBROT;
+	parameters.position = Vector2{ -0.5f, 0.0f };
+	parameters.zoom = 0.5f;
+
+	std::vector<int> threadCounts;
+
+	for (int threads = 1; threads < GetCPUFractalNumThreads(); threads *= 2)
+		threadCounts.push_back(threads);
+
+	threadCounts.push_back(GetCPUFractalNumThreads());
+
+	std::vector<std::pair<int, int>> sizes = ParseSizeList("1080p,4k,8k,16k");
+	std::vector<int> iterationCounts = { 256, 1024 };
+	std::vector<int> tileSizes = { 64, 256, 1024 };
+
+	int repetitions = 3;
+	double threshold = 0.1;
+
+	std::string outputFileName = "fractal_scaling.json";
+	std::string baselineFileName = "";
+
+	try
+	{
+		for (int i = 1; i < argc; i++)
+		{
+			std::string argument = argv[i];
+			bool hasValue = i + 1 < argc;
+
+			if (argument == "--view" && hasValue)
+			{
+				std::string viewFileName = argv[++i];
+				std::vector<FractalKeyframe> keyframes = LoadFractalKeyframes(viewFileName);
+
+				if (keyframes.empty())
+					throw std::runtime_error("No view in " + viewFileName);
+
+				parameters = keyframes.front().parameters;
+			}
+			else if (argument == "--threads" && hasValue)
+				threadCounts = ParseIntegerList(argv[++i], "thread count");
+			else if (argument == "--sizes" && hasValue)
+				sizes = ParseSizeList(argv[++i]);
+			else if (argument == "--iterations" && hasValue)
+				iterationCounts = ParseIntegerList(argv[++i], "iterations");
+			else if (argument == "--tile-sizes" && hasValue)
+				tileSizes = ParseIntegerList(argv[++i], "tile size");
+			else if (argument == "--repetitions" && hasValue)
+				repetitions = std::max(std::stoi(argv[++i]), 1);
+			else if (argument == "--output" && hasValue)
+				outputFileName = argv[++i];
+			else if (argument == "--baseline" && hasValue)
+				baselineFileName = argv[++i];
+			else if (argument == "--threshold" && hasValue)
+				threshold = std::max(std::stod(argv[++i]), 0.0);
+			else
+				throw std::runtime_error("Unknown argument " + argument);
+		}
+
+		//Fewest threads first, they're what the others are compared to
+		std::sort(threadCounts.begin(), threadCounts.end());
+		threadCounts.erase(std::unique(threadCounts.begin(), threadCounts.end()), threadCounts.end());
+
+		//Read first, so a bad baseline doesn't wait for the whole sweep
+		std::vector<ScalingBaselineRun> baseline;
+
+		if (!baselineFileName.empty())
+			baseline = LoadScalingBaseline(baselineFileName, parameters);
+
+		bool peakPerRun = ResetPeakResidentBytes();
+
+		if (!peakPerRun)
+			std::cerr << "The peak memory can't be reset on this platform, each run reports the peak of the process so far" << std::endl;
+
+		std::vector<ScalingRun> runs;
+
+		std::fprintf(stderr, "%11s %6s %5s %7s %9s %8s %6s %9s %8s\n", "size", "iter", "tile", "threads", "seconds", "speed-up", "eff", "Mpix/s", "peak MB");
+
+		for (const auto& [width, height] : sizes)
+		{
+			for (int maxIterations : iterationCounts)
+			{
+				parameters.maxIterations = maxIterations;
+
+				for (int tileSize : tileSizes)
+				{
+					double baseSeconds = 0.0;
+
+					for (int threads : threadCounts)
+					{
+						ScalingRun run = ScalingRun{ width, height, maxIterations, tileSize, threads, {}, 0, -1, 1.0, 1.0 };
+						RunScaling(parameters, run, repetitions);
+
+						double seconds = GetMedian(run.repetitionSeconds);
+
+						if (threads == threadCounts.front())
+							baseSeconds = seconds;
+
+						run.speedUp = baseSeconds / seconds;
+						run.efficiency = run.speedUp * (double)threadCounts.front() / (double)threads;
+
+						std::fprintf(stderr, "%5dx%-5d %6d %5d %7d %9.3f %8.2f %5.0f%% %9.1f %8.0f\n", width, height, maxIterations, tileSize, threads, seconds, run.speedUp,
+							run.efficiency * 100.0, (double)width * (double)height / seconds / 1e6, (double)run.peakResidentBytes / (1024.0 * 1024.0));
+
+						runs.push_back(run);
+					}
+				}
+			}
+		}
+
+		WriteScalingResults(outputFileName, parameters, runs, repetitions, peakPerRun);
+		std::cerr << "Wrote " << runs.size() << " runs to " << outputFileName << std::endl;
+
+		if (!baselineFileName.empty() && CompareScalingBaseline(runs, baseline, threshold) > 0)
+			return 2;
+	}
+	catch (std::exception& ex)
+	{
+		std::cerr << ex.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,230 @@
+// FractalServer.cpp : Serves fractal tiles over HTTP on the loopback interface, so several viewers (or web maps) share one rendering box.
+//
+// fractal_server [--port 8080] [--tile-size 256] [--memory 512] [--cache <directory> | --no-disk-cache] [--flip-y]
+//
+// GET /tiles/{type}/{z}/{x}/{y}.png?position=-0.75,0&zoom=0.4&iterations=200...
+//     tile x, y of level z of the pyramid of the view in the query (keyframe fields, see Animation.h), like fractal_tiles' {z}/{x}/{y}.png
+// GET /stats
+//     JSON with the cache's hit rate & the render & request latency percentiles
+//
+// --memory is the memory cache's budget in megabytes, --cache the disk cache's directory (default: fractal_tile_cache)
+
+#include <bit>
+#include <cstdio>
+#include <cstdarg>
+#include <string>
+#include <iostream>
+#include <stdexcept>
+#include <semaphore>
+#include <algorithm>
+
+#include "raylib.h"
+
+#include "Animation.h"
+#include "CPUFractal.h"
+#include "TilePyramid.h"
+#include "TileCache.h"
+#include "HttpServer.h"
+
+using namespace Explorer;
+
+//Low mantissa bits dropped (rounded), so views a few float steps apart share their tiles
+const unsigned int TILE_QUANTIZE_BITS = 4;
+
+int tileSize = 256;
+bool flipY = false;
+
+TileCache tileCache;
+
+//A render per core at most, the other requests wait for a slot
+std::counting_semaphore<> renderSlots(1);
+
+void LogToStandardError(int logLevel, const char* text, va_list arguments)
+{
+	std::vfprintf(stderr, text, arguments);
+	std::fputc('\n', stderr);
+}
+
+#pragma region Tiles
+float QuantizeTileFloat(float value)
+{
+	unsigned int bits = std::bit_cast<unsigned int>(value);
+	bits = (bits + (1u << (TILE_QUANTIZE_BITS - 1))) & ~((1u << TILE_QUANTIZE_BITS) - 1u);
+
+	return std::bit_cast<float>(bits);
+}
+
+Vector2 QuantizeTileVector2(Vector2 value)
+{
+	return Vector2{ QuantizeTileFloat(value.x), QuantizeTileFloat(value.y) };
+}
+
+FractalParameters QuantizeTileParameters(FractalParameters parameters)
+{
+	parameters.normalizedCenterOffset = QuantizeTileVector2(parameters.normalizedCenterOffset);
+	parameters.position = QuantizeTileVector2(parameters.position);
+	parameters.zoom = QuantizeTileFloat(parameters.zoom);
+	parameters.power = QuantizeTileFloat(parameters.power);
+	parameters.c = QuantizeTileVector2(parameters.c);
+	parameters.a = QuantizeTileVector2(parameters.a);
+
+	for (int i = 0; i < NUM_MAX_ROOTS; i++)
+		parameters.roots[i] = QuantizeTileVector2(parameters.roots[i]);
+
+	return parameters;
+}
+
+std::string RenderTilePNG(const FractalParameters& parameters, int z, int x, int y)
+{
+	Image image = GenImageColor(tileSize, tileSize, BLACK);
+
+	renderSlots.acquire();
+
+	//Deep levels are rendered in double
+	CPUFractalView view = GetTilePyramidTileView(parameters, tileSize, z, x, y, flipY);
+	RenderFractalRectCPUDeep(parameters, view, (Color*)image.data, tileSize, 0, 0, tileSize, tileSize);
+
+	renderSlots.release();
+
+	int fileSize = 0;
+	unsigned char* fileData = ExportImageToMemory(image, ".png", &fileSize);
+
+	UnloadImage(image);
+
+	if (fileData == nullptr)
+		throw std::runtime_error("Failed to encode a tile");
+
+	std::string bytes((const char*)fileData, (size_t)fileSize);
+	MemFree(fileData);
+
+	return bytes;
+}
+
+HttpResponse GetTileResponse(const HttpRequest& request)
+{
+	int type = 0;
+	int z = 0;
+	int x = 0;
+	int y = 0;
+	int pathLength = 0;
+
+	if (std::sscanf(request.path.c_str(), "/tiles/%d/%d/%d/%d.png%n", &type, &z, &x, &y, &pathLength) != 4 || pathLength != (int)request.path.size())
+		return HttpResponse{ 404, "text/plain", "Not found\n" };
+
+	if (type < 0 || type >= NUM_FRACTAL_TYPES || z < 0 || z > 30 || x < 0 || y < 0 || x >= (1 << z) || y >= (1 << z))
+		return HttpResponse{ 400, "text/plain", "Invalid tile\n" };
+
+	//The query is keyframe fields separated by & instead of spaces
+	std::string line = DecodeUrl(request.query);
+	std::replace(line.begin(), line.end(), '&', ' ');
+
+	FractalKeyframe keyframe;
+
+	if (!ParseFractalKeyframeLine(line + " time=0 type=" + std::to_string(type), keyframe))
+		return HttpResponse{ 400, "text/plain", "Invalid parameters\n" };
+
+	FractalParameters parameters = QuantizeTileParameters(keyframe.parameters);
+
+	if (!IsCPUFractalRectResolvable(GetTilePyramidTileView(parameters, tileSize, z, x, y, flipY), 0, 0, tileSize, tileSize))
+		return HttpResponse{ 400, "text/plain", "Tile is zoomed in past double precision\n" };
+
+	unsigned long long key = HashFractalParameters(parameters);
+	key = HashFractalValue(key, (unsigned long long)tileSize);
+	key = HashFractalValue(key, flipY ? 1ull : 0ull);
+	key = HashFractalValue(key, (unsigned long long)z);
+	key = HashFractalValue(key, (unsigned long long)x);
+	key = HashFractalValue(key, (unsigned long long)y);
+
+	CachedTile tile = tileCache.GetTile(key, [&]() { return RenderTilePNG(parameters, z, x, y); });
+
+	return HttpResponse{ 200, "image/png", *tile };
+}
+#pragma endregion
+
+HttpResponse GetStatsResponse()
+{
+	TileCacheStats stats = tileCache.GetStats();
+
+	char json[1024];
+	std::snprintf(json, sizeof(json),
+		"{\n"
+		"\t\"requests\": %lld,\n"
+		"\t\"memoryHits\": %lld,\n"
+		"\t\"diskHits\": %lld,\n"
+		"\t\"coalesced\": %lld,\n"
+		"\t\"renders\": %lld,\n"
+		"\t\"failedRenders\": %lld,\n"
+		"\t\"hitRate\": %.4f,\n"
+		"\t\"memoryBytes\": %lld,\n"
+		"\t\"memoryBudget\": %lld,\n"
+		"\t\"memoryTiles\": %lld,\n"
+		"\t\"renderLatencyMs\": { \"p50\": %.3f, \"p90\": %.3f, \"p99\": %.3f, \"max\": %.3f },\n"
+		"\t\"requestLatencyMs\": { \"p50\": %.3f, \"p90\": %.3f, \"p99\": %.3f, \"max\": %.3f }\n"
+		"}\n",
+		stats.numRequests, stats.numMemoryHits, stats.numDiskHits, stats.numCoalesced, stats.numRenders, stats.numFailedRenders, stats.hitRate,
+		stats.memoryBytes, stats.memoryBudget, stats.numMemoryTiles,
+		stats.renderLatencyP50, stats.renderLatencyP90, stats.renderLatencyP99, stats.renderLatencyMax,
+		stats.requestLatencyP50, stats.requestLatencyP90, stats.requestLatencyP99, stats.requestLatencyMax);
+
+	return HttpResponse{ 200, "application/json", json };
+}
+
+int main(int argc, char** argv)
+{
+	SetTraceLogCallback(LogToStandardError);
+	SetTraceLogLevel(LOG_WARNING);
+
+	int port = 8080;
+	long long memoryMegabytes = 512;
+	std::string cacheDirectory = "fractal_tile_cache";
+
+	try
+	{
+		for (int i = 1; i < argc; i++)
+		{
+			std::string argument = argv[i];
+			bool hasValue = i + 1 < argc;
+
+			if (argument == "--port" && hasValue)
+				port = std::stoi(argv[++i]);
+			else if (argument == "--tile-size" && hasValue)
+				tileSize = std::stoi(argv[++i]);
+			else if (argument == "--memory" && hasValue)
+				memoryMegabytes = std::stoll(argv[++i]);
+			else if (argument == "--cache" && hasValue)
+				cacheDirectory = argv[++i];
+			else if (argument == "--no-disk-cache")
+				cacheDirectory = "";
+			else if (argument == "--flip-y")
+				flipY = true;
+			else
+				throw std::runtime_error("Usage: fractal_server [--port 8080] [--tile-size 256] [--memory 512] [--cache <directory> | --no-disk-cache] [--flip-y]");
+		}
+
+		if (tileSize <= 0 || port <= 0 || port > 65535)
+			throw std::runtime_error("Invalid tile size or port");
+
+		tileCache.Reset(memoryMegabytes * 1024ll * 1024ll, cacheDirectory);
+
+		for (int i = 1; i < GetCPUFractalNumThreads(); i++)
+			renderSlots.release();
+
+		std::cerr << "Serving " << tileSize << "x" << tileSize << " tiles on http://127.0.0.1:" << port << "/tiles/{type}/{z}/{x}/{y}.png?position=...&zoom=... ("
+			<< GetCPUFractalNumThreads() << " renders at once), stats on http://127.0.0.1:" << port << "/stats" << std::endl;
+
+		RunHttpServer(port, [](const HttpRequest& request)
+		{
+			if (request.path == "/stats")
+				return GetStatsResponse();
+
+			return GetTileResponse(request);
+		});
+	}
+	catch (std::exception& ex)
+	{
+		std::cerr << ex.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,168 @@
+// FractalSweep.cpp : Renders a grid of variations of a view into one contact sheet (see ParameterSweep.h), without a window.
+//
+// fractal_sweep <view.txt> --columns power:2:6:5 [--rows iterations:50:400:4] [--cell 320x180] [--spacing 4] [--flip-y] [--output sheet.png]
+//
+// An axis is <parameter>:<from>:<to>:<count>, the parameters being power, c.x, c.y, a.x, a.y, iterations & zoom
+// view.txt is a keyframe file (see Animation.h), the sweep is around its first keyframe
+// Next to the sheet, <output>.json has every cell's parameters & render time
+
+#include <chrono>
+#include <cstdio>
+#include <cstdarg>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <algorithm>
+#include <filesystem>
+
+#include "raylib.h"
+
+#include "Animation.h"
+#include "CPUFractal.h"
+#include "ParameterSweep.h"
+
+using namespace Explorer;
+
+void LogToStandardError(int logLevel, const char* text, va_list arguments)
+{
+	std::vfprintf(stderr, text, arguments);
+	std::fputc('\n', stderr);
+}
+
+//<parameter>:<from>:<to>:<count>
+SweepAxis ParseSweepAxis(const std::string& text)
+{
+	char name[32] = {};
+	SweepAxis axis = SweepAxis{ SWEEP_NONE, 0.0, 0.0, 1 };
+
+	if (std::sscanf(text.c_str(), "%31[^:]:%lf:%lf:%d", name, &axis.from, &axis.to, &axis.count) != 4 || axis.count < 1)
+		throw std::runtime_error("Invalid sweep axis " + text + ", it's <parameter>:<from>:<to>:<count>");
+
+	axis.parameter = GetSweepParameterByName(name);
+
+	if (axis.parameter == SWEEP_NONE)
+		throw std::runtime_error(std::string("Unknown sweep parameter ") + name);
+
+	return axis;
+}
+
+void WriteSweepTimings(const std::string& fileName, const std::vector<FractalParameters>& cells, const std::vector<ContactSheetCellStats>& cellStats,
+	const SweepAxis& columns, const SweepAxis& rows, const ContactSheetSettings& settings, double seconds)
+{
+	std::ofstream file(fileName);
+
+	file << "{\n";
+	file << "\t\"columns\": " << settings.columns << ",\n";
+	file << "\t\"rows\": " << (cells.size() + settings.columns - 1) / settings.columns << ",\n";
+	file << "\t\"cellWidth\": " << settings.cellWidth << ",\n";
+	file << "\t\"cellHeight\": " << settings.cellHeight << ",\n";
+	file << "\t\"threads\": " << GetCPUFractalNumThreads() << ",\n";
+	file << "\t\"seconds\": " << seconds << ",\n";
+	file << "\t\"cells\": [\n";
+
+	for (size_t i = 0; i < cells.size(); i++)
+	{
+		file << "\t\t{ \"column\": " << i % settings.columns << ", \"row\": " << i / settings.columns;
+		file << ", \"" << GetSweepParameterName(columns.parameter) << "\": " << GetSweepParameterValue(cells[i], columns.parameter);
+
+		if (rows.parameter != SWEEP_NONE && rows.parameter != columns.parameter)
+			file << ", \"" << GetSweepParameterName(rows.parameter) << "\": " << GetSweepParameterValue(cells[i], rows.parameter);
+
+		file << ", \"milliseconds\": " << cellStats[i].threadSeconds * 1000.0 << ", \"iterations\": " << cellStats[i].iterations << " }" << (i + 1 < cells.size() ? "," : "") << "\n";
+	}
+
+	file << "\t]\n";
+	file << "}\n";
+
+	if (!file)
+		throw std::runtime_error("Failed to write " + fileName);
+}
+
+int main(int argc, char** argv)
+{
+	SetTraceLogCallback(LogToStandardError);
+	SetTraceLogLevel(LOG_WARNING);
+
+	if (argc < 2)
+	{
+		std::cerr << "Usage: fractal_sweep <view.txt> --columns power:2:6:5 [--rows iterations:50:400:4] [--cell 320x180] [--spacing 4] [--flip-y] [--output sheet.png]" << std::endl;
+		return 1;
+	}
+
+	std::string viewFileName = argv[1];
+
+	SweepAxis columns = SweepAxis{ SWEEP_NONE, 0.0, 0.0, 1 };
+	SweepAxis rows = SweepAxis{ SWEEP_NONE, 0.0, 0.0, 1 };
+
+	ContactSheetSettings settings = ContactSheetSettings{ 1, 320, 180, 4, false };
+	std::string outputFileName = std::filesystem::path(viewFileName).replace_extension().string() + "_sweep.png";
+
+	try
+	{
+		for (int i = 2; i < argc; i++)
+		{
+			std::string argument = argv[i];
+			bool hasValue = i + 1 < argc;
+
+			if (argument == "--columns" && hasValue)
+				columns = ParseSweepAxis(argv[++i]);
+			else if (argument == "--rows" && hasValue)
+				rows = ParseSweepAxis(argv[++i]);
+			else if (argument == "--cell" && hasValue && std::sscanf(argv[i + 1], "%dx%d", &settings.cellWidth, &settings.cellHeight) == 2)
+				i++;
+			else if (argument == "--spacing" && hasValue)
+				settings.spacing = std::max(std::stoi(argv[++i]), 0);
+			else if (argument == "--flip-y")
+				settings.flipY = true;
+			else if (argument == "--output" && hasValue)
+				outputFileName = argv[++i];
+			else
+				throw std::runtime_error("Unknown argument " + argument);
+		}
+
+		if (columns.parameter == SWEEP_NONE)
+			throw std::runtime_error("--columns is needed");
+
+		if (settings.cellWidth <= 0 || settings.cellHeight <= 0)
+			throw std::runtime_error("Invalid cell size");
+
+		std::vector<FractalKeyframe> keyframes = LoadFractalKeyframes(viewFileName);
+
+		if (keyframes.empty())
+			throw std::runtime_error("No view in " + viewFileName);
+
+		std::vector<FractalParameters> cells = GetParameterSweepGrid(keyframes.front().parameters, columns, rows);
+		settings.columns = columns.count;
+
+		std::cerr << "Rendering " << cells.size() << " cells (" << settings.cellWidth << "x" << settings.cellHeight << ", " << GetCPUFractalNumThreads() << " threads)" << std::endl;
+
+		auto startTime = std::chrono::steady_clock::now();
+
+		std::vector<ContactSheetCellStats> cellStats;
+		Image sheet = RenderContactSheet(cells, settings, cellStats);
+
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+		bool exported = ExportImage(sheet, outputFileName.c_str());
+		UnloadImage(sheet);
+
+		if (!exported)
+			throw std::runtime_error("Failed to write " + outputFileName);
+
+		WriteSweepTimings(std::filesystem::path(outputFileName).replace_extension(".json").string(), cells, cellStats, columns, rows, settings, seconds);
+
+		for (size_t i = 0; i < cells.size(); i++)
+			std::fprintf(stderr, "Cell %d, %d: %.1f ms, %lld iterations\n", (int)(i % settings.columns), (int)(i / settings.columns), cellStats[i].threadSeconds * 1000.0, cellStats[i].iterations);
+
+		std::fprintf(stderr, "Rendered the sheet in %.2f s\n", seconds);
+	}
+	catch (std::exception& ex)
+	{
+		std::cerr << ex.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,114 @@
+// FractalTiles.cpp : Renders a view into a tile pyramid (see TilePyramid.h) for pan & zoom web maps, without a window.
+//
+// fractal_tiles <view.txt> [--levels 8] [--tile-size 256] [--dzi] [--flip-y] [--fill-interior] [--output <directory>]
+//
+// view.txt is a keyframe file (see Animation.h, the viewer's A key writes one), the pyramid is of its first keyframe
+// --dzi writes Deep Zoom (OpenSeadragon) instead of {z}/{x}/{y}.png (Leaflet, OpenLayers)
+// --fill-interior writes the tiles under uniformly interior tiles too, as links to a single interior tile
+// --output is the pyramid's directory (default: <view>_tiles)
+
+#include <chrono>
+#include <cstdio>
+#include <cstdarg>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <stdexcept>
+#include <filesystem>
+
+#include "raylib.h"
+
+#include "Animation.h"
+#include "TilePyramid.h"
+#include "CPUFractal.h"
+
+using namespace Explorer;
+
+void LogToStandardError(int logLevel, const char* text, va_list arguments)
+{
+	std::vfprintf(stderr, text, arguments);
+	std::fputc('\n', stderr);
+}
+
+int main(int argc, char** argv)
+{
+	SetTraceLogCallback(LogToStandardError);
+	SetTraceLogLevel(LOG_WARNING);
+
+	if (argc < 2)
+	{
+		std::cerr << "Usage: fractal_tiles <view.txt> [--levels 8] [--tile-size 256] [--dzi] [--flip-y] [--fill-interior] [--output <directory>]" << std::endl;
+		return 1;
+	}
+
+	std::string viewFileName = argv[1];
+
+	TilePyramidSettings settings = TilePyramidSettings{ 256, 8, TILE_PYRAMID_XYZ, false, false };
+	std::string outputDirectory = std::filesystem::path(viewFileName).replace_extension().string() + "_tiles";
+
+	try
+	{
+		for (int i = 2; i < argc; i++)
+		{
+			std::string argument = argv[i];
+			bool hasValue = i + 1 < argc;
+
+			if (argument == "--levels" && hasValue)
+				settings.numLevels = std::stoi(argv[++i]);
+			else if (argument == "--tile-size" && hasValue)
+				settings.tileSize = std::stoi(argv[++i]);
+			else if (argument == "--dzi")
+				settings.layout = TILE_PYRAMID_DZI;
+			else if (argument == "--flip-y")
+				settings.flipY = true;
+			else if (argument == "--fill-interior")
+				settings.fillInterior = true;
+			else if (argument == "--output" && hasValue)
+				outputDirectory = argv[++i];
+			else
+				throw std::runtime_error("Unknown argument " + argument);
+		}
+
+		std::vector<FractalKeyframe> keyframes = LoadFractalKeyframes(viewFileName);
+
+		if (keyframes.empty())
+			throw std::runtime_error("No view in " + viewFileName);
+
+		std::cerr << "Rendering " << settings.numLevels << " levels of " << settings.tileSize << "x" << settings.tileSize << " tiles ("
+			<< GetCPUFractalNumThreads() << " threads) into " << outputDirectory << std::endl;
+
+		auto startTime = std::chrono::steady_clock::now();
+		auto lastReportTime = startTime;
+
+		std::vector<TilePyramidLevelStats> levelStats = GenerateTilePyramid(keyframes.front().parameters, settings, outputDirectory,
+			[&](int level, long long tilesDone, long long numTiles)
+		{
+			//About once a second & at the end of every level
+			auto now = std::chrono::steady_clock::now();
+
+			if (now - lastReportTime < std::chrono::seconds(1) && tilesDone < numTiles)
+				return;
+
+			lastReportTime = now;
+			std::fprintf(stderr, "Level %d: %lld/%lld tiles\n", level, tilesDone, numTiles);
+		});
+
+		long long numRendered = 0;
+
+		for (const TilePyramidLevelStats& stats : levelStats)
+		{
+			std::fprintf(stderr, "Level %d: %lld rendered, %lld skipped, %lld deduplicated in %.2f s\n", stats.level, stats.numRendered, stats.numSkipped, stats.numDeduplicated, stats.seconds);
+			numRendered += stats.numRendered;
+		}
+
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+		std::fprintf(stderr, "Rendered %lld tiles in %.2f s (%.1f tiles/s)\n", numRendered, seconds, (double)numRendered / seconds);
+	}
+	catch (std::exception& ex)
+	{
+		std::cerr << ex.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
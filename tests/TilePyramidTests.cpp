@@ -0,0 +1,106 @@
+// TilePyramidTests.cpp : Checks of the tile pyramid (see TilePyramid.h), run by ctest, without a window.
+//
+// tile_pyramid_tests [<directory>]
+//
+// Pyramids are written into directory (default: a tile_pyramid_tests directory in the system's temporary directory), returns 1 if a check fails
+
+#include <cstdio>
+#include <cstdarg>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <stdexcept>
+#include <filesystem>
+
+#include "raylib.h"
+
+#include "Animation.h"
+#include "TilePyramid.h"
+
+using namespace Explorer;
+
+int numFailed = 0;
+
+void LogToStandardError(int logLevel, const char* text, va_list arguments)
+{
+	std::vfprintf(stderr, text, arguments);
+	std::fputc('\n', stderr);
+}
+
+void Check(bool passed, const std::string& description)
+{
+	if (passed)
+		return;
+
+	std::cerr << "FAILED: " << description << std::endl;
+	numFailed++;
+}
+
+FractalParameters GetTestParameters(const std::string& line)
+{
+	FractalKeyframe keyframe;
+
+	if (!ParseFractalKeyframeLine(line, keyframe))
+		throw std::runtime_error("Invalid test view " + line);
+
+	return keyframe.parameters;
+}
+
+//Deep zoom's first levels are smaller than a tile, with the view's center interior the 1x1 level is an interior tile,
+//the tiles under interior tiles have to be linked to a full size interior tile all the same
+void CheckDZIFillInteriorTileSizes(const std::filesystem::path& directory)
+{
+	FractalParameters parameters = GetTestParameters("time=0 type=0 position=-0.5,0 zoom=1 iterations=100");
+	TilePyramidSettings settings = TilePyramidSettings{ 256, 4, TILE_PYRAMID_DZI, false, true };
+
+	std::vector<TilePyramidLevelStats> levelStats = GenerateTilePyramid(parameters, settings, directory.string(), [](int, long long, long long) {});
+
+	Check(levelStats.back().numSkipped > 0, "the deepest level has tiles under interior tiles");
+
+	//The last numLevels levels are quadtree levels, all of their tiles are full size
+	for (size_t i = levelStats.size() - settings.numLevels; i < levelStats.size(); i++)
+	{
+		std::filesystem::path levelDirectory = directory / "fractal_files" / std::to_string(levelStats[i].level);
+
+		for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(levelDirectory))
+		{
+			Image tile = LoadImage(entry.path().string().c_str());
+
+			Check(tile.width == settings.tileSize && tile.height == settings.tileSize,
+				entry.path().generic_string() + " is " + std::to_string(tile.width) + "x" + std::to_string(tile.height) + " instead of a full tile");
+
+			UnloadImage(tile);
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	SetTraceLogCallback(LogToStandardError);
+	SetTraceLogLevel(LOG_WARNING);
+
+	std::filesystem::path directory = argc > 1 ? std::filesystem::path(argv[1]) : std::filesystem::temp_directory_path() / "tile_pyramid_tests";
+
+	try
+	{
+		std::filesystem::remove_all(directory);
+
+		CheckDZIFillInteriorTileSizes(directory / "dzi_fill_interior");
+
+		std::filesystem::remove_all(directory);
+	}
+	catch (std::exception& ex)
+	{
+		std::cerr << ex.what() << std::endl;
+		return 1;
+	}
+
+	if (numFailed > 0)
+	{
+		std::cerr << numFailed << " checks failed" << std::endl;
+		return 1;
+	}
+
+	std::cerr << "All checks passed" << std::endl;
+	return 0;
+}